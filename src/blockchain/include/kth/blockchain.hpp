@@ -28,13 +28,16 @@
 #include <kth/blockchain/pools/block_organizer.hpp>
 #include <kth/blockchain/pools/block_pool.hpp>
 #include <kth/blockchain/pools/branch.hpp>
+#include <kth/blockchain/pools/recent_blocks.hpp>
 #include <kth/blockchain/pools/transaction_entry.hpp>
 #include <kth/blockchain/pools/transaction_organizer.hpp>
 #include <kth/blockchain/pools/transaction_pool.hpp>
+#include <kth/blockchain/pools/unconfirmed_pool.hpp>
 #include <kth/blockchain/populate/populate_base.hpp>
 #include <kth/blockchain/populate/populate_block.hpp>
 #include <kth/blockchain/populate/populate_chain_state.hpp>
 #include <kth/blockchain/populate/populate_transaction.hpp>
+#include <kth/blockchain/validate/script_cache.hpp>
 #include <kth/blockchain/validate/validate_block.hpp>
 #include <kth/blockchain/validate/validate_input.hpp>
 #include <kth/blockchain/validate/validate_transaction.hpp>
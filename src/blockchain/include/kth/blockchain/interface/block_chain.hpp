@@ -20,7 +20,9 @@
 #include <kth/blockchain/interface/fast_chain.hpp>
 #include <kth/blockchain/interface/safe_chain.hpp>
 #include <kth/blockchain/pools/block_organizer.hpp>
+#include <kth/blockchain/pools/recent_blocks.hpp>
 #include <kth/blockchain/pools/transaction_organizer.hpp>
+#include <kth/blockchain/pools/unconfirmed_pool.hpp>
 #include <kth/blockchain/populate/populate_chain_state.hpp>
 #include <kth/blockchain/settings.hpp>
 
@@ -60,10 +62,13 @@ public:
     bool get_transaction_position(size_t& out_height, size_t& out_position, hash_digest const& hash, bool require_confirmed) const override;
 
     /// Get the output that is referenced by the outpoint in the UTXO Set.
-    bool get_utxo(domain::chain::output& out_output, size_t& out_height, uint32_t& out_median_time_past, bool& out_coinbase, domain::chain::output_point const& outpoint, size_t branch_height) const override;
+    bool get_utxo(domain::chain::prevout_cache& out_output, size_t& out_height, uint32_t& out_median_time_past, bool& out_coinbase, domain::chain::output_point const& outpoint, size_t branch_height) const override;
 
     std::pair<bool, database::internal_database::utxo_pool_t> get_utxo_pool_from(uint32_t from, uint32_t to) const override;
 
+    /// Get the UTXO cache counters, (hits, misses).
+    std::pair<size_t, size_t> get_utxo_cache_stats() const override;
+
     /// Get a determination of whether the block hash exists in the store.
     bool get_block_exists(hash_digest const& block_hash) const override;
 
@@ -170,6 +175,9 @@ public:
     /// fetch a block by hash.
     void fetch_block(hash_digest const& hash, block_fetch_handler handler) const override;
 
+    /// fetch a block by hash, in the wire format (not deserialized).
+    void fetch_block_data(hash_digest const& hash, block_data_fetch_handler handler) const override;
+
     /// fetch the set of block hashes indicated by the block locator.
     void fetch_locator_block_hashes(get_blocks_const_ptr locator, hash_digest const& threshold, size_t limit, inventory_fetch_handler handler) const override;
 
@@ -200,6 +208,10 @@ public:
     /// fetch position and height within block of transaction by hash.
     void fetch_transaction_position(hash_digest const& hash, bool require_confirmed, transaction_index_fetch_handler handler) const override;
 
+    /// fetch the merkle branch of a confirmed transaction by hash, with its
+    /// position and the height of its block.
+    void fetch_merkle_branch(hash_digest const& tx_hash, merkle_branch_fetch_handler handler) const override;
+
     /// fetch the set of block headers indicated by the block locator.
     void fetch_locator_block_headers(get_headers_const_ptr locator, hash_digest const& threshold, size_t limit, locator_block_headers_fetch_handler handler) const override;
 
@@ -338,6 +350,9 @@ public:
     /// True if the blockchain is stale based on configured age limit.
     bool is_stale_fast() const override;
 
+    /// The multiset hash of the unspent outputs at height.
+    bool get_utxo_set_hash(hash_digest& out_hash, size_t height) const override;
+
     /// Get a reference to the blockchain configuration settings.
     settings const& chain_settings() const;
 
@@ -366,9 +381,12 @@ private:
     //-------------------------------------------------------------------------
 
     code set_chain_state(domain::chain::chain_state::ptr previous);
+    std::optional<database::header_index::entry> get_header_entry(size_t height) const;
+    hash_list block_transaction_hashes(size_t height) const;
     void handle_transaction(code const& ec, transaction_const_ptr tx, result_handler handler) const;
     void handle_block(code const& ec, block_const_ptr block, result_handler handler) const;
-    void handle_reorganize(code const& ec, block_const_ptr top, result_handler handler);
+    void handle_reorganize(code const& ec, block_const_ptr_list_const_ptr incoming_blocks, result_handler handler);
+    std::vector<uint64_t> compute_short_ids(uint64_t k0, uint64_t k1, std::vector<hash_digest> const& hashes) const;
 
     // These are thread safe.
     std::atomic<bool> stopped_;
@@ -390,6 +408,9 @@ private:
     mutable prioritized_mutex validation_mutex_;
     mutable threadpool priority_pool_;
     mutable dispatcher dispatch_;
+    unconfirmed_pool unconfirmed_pool_;
+    script_cache script_cache_;
+    recent_blocks recent_blocks_;
 
 
 #if defined(KTH_WITH_MEMPOOL)
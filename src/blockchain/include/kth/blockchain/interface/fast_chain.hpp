@@ -63,11 +63,14 @@ struct KB_API fast_chain {
     virtual bool get_last_height(size_t& out_height) const = 0;
 
     /// Get the output that is referenced by the outpoint in the UTXO Set.
-    virtual bool get_utxo(domain::chain::output& out_output, size_t& out_height, uint32_t& out_median_time_past, bool& out_coinbase, domain::chain::output_point const& outpoint, size_t branch_height) const = 0;
+    virtual bool get_utxo(domain::chain::prevout_cache& out_output, size_t& out_height, uint32_t& out_median_time_past, bool& out_coinbase, domain::chain::output_point const& outpoint, size_t branch_height) const = 0;
 
     /// Get a UTXO subset from the reorganization pool, [from, to] the specified heights.
     virtual std::pair<bool, database::internal_database::utxo_pool_t> get_utxo_pool_from(uint32_t from, uint32_t to) const = 0;
 
+    /// Get the UTXO cache counters, (hits, misses).
+    virtual std::pair<size_t, size_t> get_utxo_cache_stats() const = 0;
+
 #if ! defined(KTH_DB_READONLY)
     virtual void prune_reorg_async() = 0;
 #endif
@@ -38,9 +38,11 @@ struct KB_API safe_chain {
     using confirmed_transactions_fetch_handler = handle1<std::vector<hash_digest>>;
     // Smart pointer parameters must not be passed by reference.
     using block_fetch_handler = std::function<void(code const&, block_const_ptr, size_t)>;
+    using block_data_fetch_handler = std::function<void(code const&, std::shared_ptr<data_chunk const>, size_t)>;
     using block_header_txs_size_fetch_handler = std::function<void(code const&, header_const_ptr, size_t, std::shared_ptr<hash_list>, uint64_t)>;
     using block_hash_time_fetch_handler = std::function<void(code const&, hash_digest const&, uint32_t, size_t)>;
     using merkle_block_fetch_handler =  std::function<void(code const&, merkle_block_ptr, size_t)>;
+    using merkle_branch_fetch_handler = std::function<void(code const&, hash_list const&, size_t, size_t)>;
     using compact_block_fetch_handler = std::function<void(code const&, compact_block_ptr, size_t)>;
     using block_header_fetch_handler = std::function<void(code const&, header_ptr, size_t)>;
     using transaction_fetch_handler = std::function<void(code const&, transaction_const_ptr, size_t, size_t)>;
@@ -74,6 +76,8 @@ struct KB_API safe_chain {
 
     virtual void fetch_block(hash_digest const& hash, block_fetch_handler handler) const = 0;
 
+    virtual void fetch_block_data(hash_digest const& hash, block_data_fetch_handler handler) const = 0;
+
     virtual void fetch_locator_block_hashes(get_blocks_const_ptr locator, hash_digest const& threshold, size_t limit, inventory_fetch_handler handler) const = 0;
 
     virtual void fetch_merkle_block(size_t height, merkle_block_fetch_handler handler) const = 0;
@@ -92,6 +96,8 @@ struct KB_API safe_chain {
 
     virtual void fetch_transaction_position(hash_digest const& hash, bool require_confirmed, transaction_index_fetch_handler handler) const = 0;
 
+    virtual void fetch_merkle_branch(hash_digest const& tx_hash, merkle_branch_fetch_handler handler) const = 0;
+
     // virtual void for_each_transaction(size_t from, size_t to, for_each_tx_handler const& handler) const = 0;
 
     // virtual void for_each_transaction_non_coinbase(size_t from, size_t to, for_each_tx_handler const& handler) const = 0;
@@ -174,6 +180,10 @@ struct KB_API safe_chain {
 
     virtual bool is_stale() const = 0;
 
+    /// The multiset hash of the unspent outputs at height (the top or a
+    /// block in the reorg pool).
+    virtual bool get_utxo_set_hash(hash_digest& out_hash, size_t height) const = 0;
+
     //TODO(Mario) temporary duplication
     /// Get a determination of whether the block hash exists in the store.
     virtual bool get_block_exists_safe(hash_digest const& block_hash) const = 0;
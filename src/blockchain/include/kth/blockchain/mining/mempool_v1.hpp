@@ -7,11 +7,15 @@
 
 #include <algorithm>
 #include <chrono>
+#include <mutex>
+#include <optional>
 #include <print>
+#include <set>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #ifndef NDEBUG
@@ -86,6 +90,13 @@ using all_transactions_t = std::vector<node>;
 
 
 #if defined(KTH_CURRENCY_BCH)
+// Canonical transaction order (CTOR), txids compared as numbers.
+struct ctor_less {
+    bool operator()(hash_digest const& a, hash_digest const& b) const {
+        return std::lexicographical_compare(a.rbegin(), a.rend(), b.rbegin(), b.rend());
+    }
+};
+
 inline
 void sort_ctor(all_transactions_t& all, std::vector<size_t>& candidates) {
     auto const cmp = [&all](index_t ia, index_t ib) {
@@ -298,6 +309,7 @@ public:
     using internal_utxo_set_t = std::unordered_map<domain::chain::point, domain::chain::output>;
     using previous_outputs_t = std::unordered_map<domain::chain::point, index_t>;
     using hash_index_t = std::unordered_map<hash_digest, std::pair<index_t, domain::chain::transaction>>;
+    using block_template_t = std::pair<std::vector<transaction_element>, uint64_t>;
 
     // using mutex_t = boost::shared_mutex;
     // using shared_lock_t = boost::shared_lock<mutex_t>;
@@ -400,6 +412,8 @@ public:
             end = std::chrono::high_resolution_clock::now();
             increment_time(start, end, insert_candidate_time);
 
+            ++generation_;
+
 
     #ifndef NDEBUG
             check_invariant();
@@ -560,6 +574,9 @@ public:
             for (auto i : to_remove) {
                 auto it = std::next(all_transactions_.begin(), i);
                 hash_index_.erase(it->txid());
+#if defined(KTH_CURRENCY_BCH)
+                ctor_index_.erase(it->txid());
+#endif
                 remove_from_utxo(it->txid(), it->output_count());
 
                 if (i < all_transactions_.size() - 1) {
@@ -617,6 +634,7 @@ public:
 // #endif
 
 
+            ++generation_;
             sorted_ = false;
             candidate_transactions_.clear();
             previous_outputs_.clear();
@@ -705,24 +723,28 @@ public:
         });
     }
 
-    //TODO(fernando):
     bool contains(hash_digest const& txid) const {
         // shared_lock_t lock(mutex_);
         return prioritizer_.low_job([&txid, this]{
-            auto it = hash_index_.find(txid);
-            return it != hash_index_.end();
+            return hash_index_.contains(txid);
         });
     }
 
-    hash_index_t get_validated_txs_high() const {
-        return prioritizer_.high_job([this]{
-            return hash_index_;
+    /// Invoke f with a read-only view of the pooled transactions (by hash).
+    /// The view is only valid during the call, the mempool is not modified
+    /// meanwhile. Nothing is copied, f must not call back into the mempool
+    /// and must return a value.
+    template <typename F>
+    auto with_validated_txs_high(F f) const {
+        return prioritizer_.high_job([&f, this]{
+            return f(std::as_const(hash_index_));
         });
     }
 
-    hash_index_t get_validated_txs_low() const {
-        return prioritizer_.low_job([this]{
-            return hash_index_;
+    template <typename F>
+    auto with_validated_txs_low(F f) const {
+        return prioritizer_.low_job([&f, this]{
+            return f(std::as_const(hash_index_));
         });
     }
 
@@ -750,60 +772,32 @@ public:
         });
     }
 
-    std::pair<std::vector<transaction_element>, uint64_t> get_block_template() const {
-        //TODO(fernando): implement a cache, outside
+    block_template_t get_block_template() const {
+        return get_block_template(max_template_size_);
+    }
 
+    /// Candidate transactions in block order and their fees, limited to
+    /// max_size bytes (i.e. the ABLA block size limit minus the coinbase).
+    /// Served from cache until the mempool changes.
+    block_template_t get_block_template(size_t max_size) const {
         if (processing_block_) {
             return {};
         }
 
-        auto copied_data = prioritizer_.high_job([this] {
-            std::vector<size_t> candidates;
-            candidates.reserve(candidate_transactions_.size());
-            std::transform(std::begin(candidate_transactions_), std::end(candidate_transactions_), std::back_inserter(candidates),
-                   [](candidate_index_t const& x) {
-                       return x.index();
-                    }
-            );
+        {
+            std::lock_guard<std::mutex> lock(template_mutex_);
+            if (template_cache_ && template_cache_->generation == generation_ && template_cache_->max_size == max_size) {
+                return template_cache_->value;
+            }
+        }
 
-            return make_tuple(std::move(candidates), all_transactions_, accum_fees_, sorted_);
-            // return make_tuple(candidate_transactions_, all_transactions_, accum_fees_);
+        auto [generation, value] = prioritizer_.high_job([this, max_size] {
+            return std::make_pair(size_t(generation_), make_block_template(max_size));
         });
 
-        auto& candidates = std::get<0>(copied_data);
-        auto& all = std::get<1>(copied_data);
-        auto accum_fees = std::get<2>(copied_data);
-        auto sorted = std::get<3>(copied_data);
-
-// #if defined(KTH_CURRENCY_BCH)
-
-//         auto const cmp = [this](size_t a, size_t b) {
-//             return ctor_cmp(a, b);
-//         };
-
-//         // start = chrono::high_resolution_clock::now();
-//         std::sort(std::begin(candidates), std::end(candidates), cmp);
-//         // end = chrono::high_resolution_clock::now();
-//         // auto sort_time = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
-// #else
-//         sort_ltor(all, candidates);
-// #endif
-
-#if defined(KTH_CURRENCY_BCH)
-        sort_ctor(all, candidates);
-#else
-        sort_ltor(sorted, all, candidates);
-#endif
-
-
-        std::vector<transaction_element> res;
-        res.reserve(candidates.size());
-
-        for (auto i : candidates) {
-            res.push_back(std::move(all[i].element()));
-        }
-
-        return {std::move(res), accum_fees};
+        std::lock_guard<std::mutex> lock(template_mutex_);
+        template_cache_ = cached_template{generation, max_size, value};
+        return value;
     }
 
     domain::chain::output get_utxo(domain::chain::point const& point) const {
@@ -1575,6 +1569,9 @@ private:
 
         start = std::chrono::high_resolution_clock::now();
         hash_index_.emplace(tx.hash(), std::make_pair(node_index, tx));
+#if defined(KTH_CURRENCY_BCH)
+        ctor_index_.insert(tx.hash());
+#endif
         end = std::chrono::high_resolution_clock::now();
         increment_time(start, end, hash_index_emplace_time);
 
@@ -2146,6 +2143,85 @@ private:
     }
 
 
+    struct cached_template {
+        size_t generation;
+        size_t max_size;
+        block_template_t value;
+    };
+
+#if defined(KTH_CURRENCY_BCH)
+    // The candidate set is walked in the CTOR order maintained by ctor_index_,
+    // no copy of the pool and no sort. A limit below the candidate set size
+    // selects in candidate order, skipping transactions whose parents are out.
+    block_template_t make_block_template(size_t max_size) const {
+        std::vector<bool> selected;
+        uint64_t fees = accum_fees_;
+
+        if (accum_size_ > max_size) {
+            selected.resize(all_transactions_.size(), false);
+            fees = 0;
+            size_t size = 0;
+
+            for (auto const& ci : candidate_transactions_) {
+                auto const& node = all_transactions_[ci.index()];
+                if (size + node.size() > max_size) {
+                    continue;
+                }
+
+                auto const parents_in = std::all_of(node.parents().begin(), node.parents().end(), [&](index_t pi) {
+                    return selected[pi];
+                });
+                if ( ! parents_in) {
+                    continue;
+                }
+
+                selected[ci.index()] = true;
+                size += node.size();
+                fees += node.fee();
+            }
+        }
+
+        std::vector<transaction_element> res;
+        res.reserve(candidate_transactions_.size());
+
+        for (auto const& txid : ctor_index_) {
+            auto const index = hash_index_.find(txid)->second.first;
+            auto const& node = all_transactions_[index];
+            if (node.candidate_index() == null_index) {
+                continue;
+            }
+
+            if (selected.empty() || selected[index]) {
+                res.push_back(node.element());
+            }
+        }
+
+        return {std::move(res), fees};
+    }
+#else
+    block_template_t make_block_template(size_t /*max_size*/) const {
+        std::vector<size_t> candidates;
+        candidates.reserve(candidate_transactions_.size());
+        std::transform(std::begin(candidate_transactions_), std::end(candidate_transactions_), std::back_inserter(candidates),
+               [](candidate_index_t const& x) {
+                   return x.index();
+                }
+        );
+
+        auto all = all_transactions_;
+        sort_ltor(sorted_, all, candidates);
+
+        std::vector<transaction_element> res;
+        res.reserve(candidates.size());
+
+        for (auto i : candidates) {
+            res.push_back(std::move(all[i].element()));
+        }
+
+        return {std::move(res), accum_fees_};
+    }
+#endif
+
     size_t const max_template_size_;
     size_t const mempool_total_size_;
     size_t accum_size_ = 0;
@@ -2164,6 +2240,16 @@ private:
     // mutable mutex_t mutex_;
     prioritizer prioritizer_;
     std::atomic<bool> processing_block_{false};
+
+#if defined(KTH_CURRENCY_BCH)
+    // Txids of the pool in CTOR order, maintained as transactions enter/leave.
+    std::set<hash_digest, ctor_less> ctor_index_;
+#endif
+
+    // Incremented on each change of the pool, protected by prioritizer_.
+    std::atomic<size_t> generation_ {0};
+    mutable std::mutex template_mutex_;
+    mutable std::optional<cached_template> template_cache_;
 };
 
 }  // namespace mining
@@ -34,6 +34,10 @@ public:
         return std::move(te_);
     }
 
+    transaction_element const& element() const {
+        return te_;
+    }
+
     hash_digest const& txid() const {
         return te_.txid();
     }
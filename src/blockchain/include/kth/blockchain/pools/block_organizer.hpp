@@ -34,9 +34,9 @@ struct KB_API block_organizer {
 
     /// Construct an instance.
 #if defined(KTH_WITH_MEMPOOL)
-    block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, domain::config::network network, bool relay_transactions, mining::mempool& mp);
+    block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions, mining::mempool& mp);
 #else
-    block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, domain::config::network network, bool relay_transactions);
+    block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions);
 #endif
 
     bool start();
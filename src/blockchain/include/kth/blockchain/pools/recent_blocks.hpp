@@ -0,0 +1,82 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_BLOCKCHAIN_RECENT_BLOCKS_HPP
+#define KTH_BLOCKCHAIN_RECENT_BLOCKS_HPP
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <kth/blockchain/define.hpp>
+#include <kth/domain.hpp>
+
+namespace kth::blockchain {
+
+/// Bounded cache of the most recently organized blocks, keyed by hash and by
+/// height, so that the requests of many peers for the last blocks after a tip
+/// change (or a small reorganization) do not read the store.
+/// Each entry keeps the block and its wire and compact block encodings, the
+/// encodings are built once, on the first request. Entries are evicted least
+/// recently used first. A capacity of zero disables the cache.
+/// This class is thread safe.
+struct KB_API recent_blocks {
+    using data_ptr = std::shared_ptr<data_chunk const>;
+
+    explicit
+    recent_blocks(size_t capacity);
+
+    // Non-copyable, non-movable
+    recent_blocks(recent_blocks const&) = delete;
+    recent_blocks& operator=(recent_blocks const&) = delete;
+
+    bool disabled() const;
+    size_t capacity() const;
+    size_t size() const;
+
+    /// Add a block organized at the height, the blocks previously added at
+    /// or above the height (now reorganized out) are removed.
+    void add(block_const_ptr block, size_t height);
+    void clear();
+
+    /// The block or nullptr, out_height is set when found.
+    block_const_ptr find(hash_digest const& hash, size_t& out_height) const;
+    block_const_ptr find(size_t height) const;
+
+    /// The wire encoding of the block or nullptr.
+    data_ptr data(hash_digest const& hash, size_t& out_height) const;
+
+    /// The compact block of the block or nullptr.
+    compact_block_ptr compact(hash_digest const& hash, size_t& out_height) const;
+
+private:
+    using lru_list = std::list<hash_digest>;
+
+    struct item {
+        block_const_ptr block;
+        size_t height;
+        data_ptr data;
+        compact_block_ptr compact;
+        lru_list::iterator position;
+    };
+
+    // precondition: mutex_ is locked.
+    item const* touch(hash_digest const& hash) const;
+    void erase(hash_digest const& hash);
+
+    size_t const capacity_;
+
+    // These are protected by mutex.
+    mutable lru_list lru_;
+    mutable std::unordered_map<hash_digest, item> items_;
+    std::map<size_t, hash_digest> heights_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace kth::blockchain
+
+#endif
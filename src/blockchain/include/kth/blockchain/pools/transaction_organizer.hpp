@@ -6,10 +6,13 @@
 #define KTH_BLOCKCHAIN_TRANSACTION_ORGANIZER_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 
 #include <kth/blockchain/define.hpp>
 #include <kth/blockchain/interface/fast_chain.hpp>
@@ -42,12 +45,21 @@ struct KB_API transaction_organizer {
     using transaction_subscriber = resubscriber<code, transaction_const_ptr>;
     using ds_proof_subscriber = resubscriber<code, double_spend_proof_const_ptr>;
 
+    /// Number of transactions in each stage of the admission pipeline.
+    struct admission_depth {
+        size_t waiting;     // blocked by a conflicting in-flight transaction.
+        size_t checking;
+        size_t populating;
+        size_t verifying;
+        size_t committing;
+    };
+
     /// Construct an instance.
 
 #if defined(KTH_WITH_MEMPOOL)
-    transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, mining::mempool& mp);
+    transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache& scripts, mining::mempool& mp);
 #else
-    transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings);
+    transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache& scripts);
 #endif
 
     bool start();
@@ -67,6 +79,8 @@ struct KB_API transaction_organizer {
     void fetch_mempool(size_t maximum, inventory_fetch_handler) const;
     void fetch_ds_proof(hash_digest const& hash, ds_proof_fetch_handler) const;
 
+    admission_depth depth() const;
+
 protected:
     bool stopped() const;
     uint64_t price(transaction_const_ptr tx) const;
@@ -81,7 +95,10 @@ private:
     void handle_pushed(code const& ec, transaction_const_ptr tx, result_handler handler);
 #endif
 
-    void signal_completion(code const& ec);
+    // Admission of transactions sharing prevouts (or spending each other).
+    void claim(domain::chain::transaction const& tx);
+    void release(domain::chain::transaction const& tx);
+    bool conflicts(domain::chain::transaction const& tx) const;
 
     void validate_handle_check(code const& ec, transaction_const_ptr tx, result_handler handler) const;
     void validate_handle_accept(code const& ec, transaction_const_ptr tx, result_handler handler) const;
@@ -97,7 +114,6 @@ private:
     // These are thread safe.
     prioritized_mutex& mutex_;
     std::atomic<bool> stopped_;
-    std::promise<code> resume_;
     settings const& settings_;
     dispatcher& dispatch_;
     transaction_pool transaction_pool_;
@@ -110,6 +126,21 @@ private:
 #endif
 
     std::unordered_map<hash_digest, double_spend_proof_const_ptr> ds_proofs_;
+
+    // Protected by claims_mutex_.
+    std::mutex claims_mutex_;
+    std::condition_variable claims_released_;
+    std::unordered_set<domain::chain::point> claimed_prevouts_;
+    std::unordered_set<hash_digest> claimed_transactions_;
+
+    // Serializes the mempool and store writes of concurrent admissions.
+    std::mutex commit_mutex_;
+
+    std::atomic<size_t> waiting_ {0};
+    std::atomic<size_t> checking_ {0};
+    std::atomic<size_t> populating_ {0};
+    std::atomic<size_t> verifying_ {0};
+    std::atomic<size_t> committing_ {0};
 };
 
 } // namespace kth::blockchain
@@ -0,0 +1,93 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_BLOCKCHAIN_UNCONFIRMED_POOL_HPP
+#define KTH_BLOCKCHAIN_UNCONFIRMED_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <kth/blockchain/define.hpp>
+#include <kth/domain.hpp>
+
+namespace kth::blockchain {
+
+/// This class is thread safe.
+/// In-memory index of the unconfirmed transactions accepted to the pool,
+/// so that queries (i.e. compact block reconstruction) do not read the store.
+/// Also keeps a bounded ring of recently rejected transactions which may
+/// still be mined by others (BIP152 extra transactions), and an index of
+/// the pooled inputs and outputs by (mainnet encoded) payment address.
+struct KB_API unconfirmed_pool {
+    static constexpr size_t extra_capacity_default = 100;
+
+    /// An input or output of a pooled transaction paying to/from an address.
+    struct address_entry {
+        transaction_const_ptr tx;
+        uint32_t index;
+        bool input;
+        uint32_t arrival_time;
+    };
+
+    /// Pooled and extra transactions, with their hashes in the same order.
+    struct snapshot {
+        std::vector<hash_digest> hashes;
+        std::vector<transaction_const_ptr> transactions;
+        size_t pooled = 0;
+    };
+
+    explicit
+    unconfirmed_pool(size_t extra_capacity = extra_capacity_default);
+
+    size_t size() const;
+    size_t extra_size() const;
+
+    /// Add a transaction accepted to the pool.
+    void add(transaction_const_ptr tx, uint32_t arrival_time);
+
+    /// Add a rejected transaction to the ring, overwriting the oldest.
+    void add_extra(transaction_const_ptr tx);
+
+    /// Remove the transactions confirmed by the block.
+    void remove(domain::chain::block const& block);
+    void remove(hash_digest const& hash);
+    void clear();
+
+    bool contains(hash_digest const& hash) const;
+
+    /// The pooled transaction (not extra), or nullptr.
+    transaction_const_ptr find(hash_digest const& hash) const;
+
+    /// Copy the transaction pointers (pooled first, then extra).
+    snapshot take_snapshot() const;
+
+    /// Inputs and outputs of pooled transactions for the (mainnet) address.
+    std::vector<address_entry> get_address_entries(domain::wallet::payment_address const& address) const;
+
+private:
+    struct entry {
+        transaction_const_ptr tx;
+        uint32_t arrival_time;
+    };
+
+    static domain::wallet::payment_address::list extract(domain::chain::script const& script);
+    void index_addresses(transaction_const_ptr const& tx, uint32_t arrival_time);
+    void unindex_addresses(domain::chain::transaction const& tx);
+    void erase(hash_digest const& hash);
+
+    size_t const extra_capacity_;
+
+    // These are protected by mutex.
+    std::unordered_map<hash_digest, entry> transactions_;
+    std::vector<transaction_const_ptr> extra_;
+    std::unordered_map<domain::wallet::payment_address, std::vector<address_entry>> addresses_;
+    size_t extra_next_ = 0;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace kth::blockchain
+
+#endif
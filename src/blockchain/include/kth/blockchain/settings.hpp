@@ -31,6 +31,9 @@ struct KB_API settings {
     uint64_t minimum_output_satoshis = 500;
     uint32_t notify_limit_hours = 24;
     uint32_t reorganization_limit = 256;
+    size_t script_cache_capacity = 100000;
+    size_t signature_cache_capacity = 1048576;
+    size_t recent_blocks_capacity = 16;
     infrastructure::config::checkpoint::list checkpoints;
     bool fix_checkpoints = true;
     bool allow_collisions = true;
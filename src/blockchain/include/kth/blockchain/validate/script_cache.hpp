@@ -0,0 +1,78 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_BLOCKCHAIN_SCRIPT_CACHE_HPP
+#define KTH_BLOCKCHAIN_SCRIPT_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <kth/blockchain/define.hpp>
+#include <kth/domain.hpp>
+
+namespace kth::blockchain {
+
+/// Bounded set of the transactions whose input scripts were all verified,
+/// keyed by transaction hash and the enabled forks of the verification.
+/// The hash commits to the scripts and to the spent outpoints (so to the
+/// spent outputs), the forks to the script flags, together they determine
+/// the verification result. The sigchecks are kept for the block limits.
+/// Entries are distributed in independently locked shards, each one evicting
+/// its oldest entries. A capacity of zero disables the cache.
+/// This class is thread safe.
+struct KB_API script_cache {
+    explicit
+    script_cache(size_t capacity);
+
+    // Non-copyable, non-movable
+    script_cache(script_cache const&) = delete;
+    script_cache& operator=(script_cache const&) = delete;
+
+    bool disabled() const;
+    size_t capacity() const;
+    size_t size() const;
+
+    /// The sigchecks of a verified transaction, counts a hit or a miss.
+    std::optional<size_t> find(hash_digest const& hash, uint32_t forks) const;
+
+    /// Insert or replace the entry of a verified transaction.
+    void add(hash_digest const& hash, uint32_t forks, size_t sigchecks);
+    void clear();
+
+    size_t hits() const;
+    size_t misses() const;
+    float hit_rate() const;
+
+private:
+    static constexpr size_t shard_count = 16;
+
+    struct shard {
+        struct item {
+            uint32_t forks;
+            size_t sigchecks;
+        };
+
+        std::mutex mutex;
+        std::deque<hash_digest> order;
+        std::unordered_map<hash_digest, item> map;
+    };
+
+    shard& shard_for(hash_digest const& hash) const;
+
+    size_t const capacity_;
+    size_t const shard_capacity_;
+    mutable std::array<shard, shard_count> shards_;
+    mutable std::atomic<size_t> hits_ {0};
+    mutable std::atomic<size_t> misses_ {0};
+};
+
+} // namespace kth::blockchain
+
+#endif
@@ -15,6 +15,7 @@
 #include <kth/blockchain/pools/branch.hpp>
 #include <kth/blockchain/populate/populate_block.hpp>
 #include <kth/blockchain/settings.hpp>
+#include <kth/blockchain/validate/script_cache.hpp>
 #include <kth/domain.hpp>
 
 #if defined(KTH_WITH_MEMPOOL)
@@ -28,9 +29,9 @@ struct KB_API validate_block {
     using result_handler = handle0;
 
 #if defined(KTH_WITH_MEMPOOL)
-    validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, domain::config::network network, bool relay_transactions, mining::mempool const& mp);
+    validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions, mining::mempool const& mp);
 #else
-    validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, domain::config::network network, bool relay_transactions);
+    validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions);
 #endif
 
     void start();
@@ -52,15 +53,24 @@ private:
     using atomic_counter = std::atomic<size_t>;
     using atomic_counter_ptr = std::shared_ptr<atomic_counter>;
 
+    struct check_state;
+    using check_state_ptr = std::shared_ptr<check_state>;
+
+    struct connect_state;
+    using connect_state_ptr = std::shared_ptr<connect_state>;
+
     static
     void dump(code const& ec, const domain::chain::transaction& tx, uint32_t input_index, uint32_t forks, size_t height);
 
-    void check_block(block_const_ptr block, size_t bucket, size_t buckets, result_handler handler) const;
-    void handle_checked(code const& ec, block_const_ptr block, result_handler handler) const;
+    void check_transactions(block_const_ptr block, check_state_ptr state, size_t bucket, result_handler handler) const;
+    void handle_transactions_checked(code const& ec, block_const_ptr block, check_state_ptr state, result_handler handler) const;
+    void check_merkle(check_state_ptr state, size_t chunk, result_handler handler) const;
+    void check_structure(block_const_ptr block, check_state_ptr state, result_handler handler) const;
+    void handle_checked(code const& ec, block_const_ptr block, check_state_ptr state, result_handler handler) const;
     void handle_populated(code const& ec, block_const_ptr block, result_handler handler) const;
     void accept_transactions(block_const_ptr block, size_t bucket, size_t buckets, atomic_counter_ptr sigops, bool bip16, bool bip141, result_handler handler) const;
     void handle_accepted(code const& ec, block_const_ptr block, atomic_counter_ptr sigops, bool bip141, result_handler handler) const;
-    void connect_inputs(block_const_ptr block, size_t bucket, size_t buckets, result_handler handler) const;
+    void connect_inputs(block_const_ptr block, connect_state_ptr state, size_t bucket, result_handler handler) const;
     void handle_connected(code const& ec, block_const_ptr block, result_handler handler) const;
 
     // These are thread safe.
@@ -68,6 +78,7 @@ private:
     fast_chain const& fast_chain_;
     domain::config::network network_;
     dispatcher& priority_dispatch_;
+    script_cache const& script_cache_;
     mutable atomic_counter hits_;
     mutable atomic_counter queries_;
 
@@ -6,6 +6,8 @@
 #define KTH_BLOCKCHAIN_VALIDATE_INPUT_HPP
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include <kth/blockchain/define.hpp>
 #include <kth/domain.hpp>
@@ -29,6 +31,14 @@ struct KB_API validate_input {
 
     static
     std::pair<code, size_t> verify_script(domain::chain::transaction const& tx, uint32_t input_index, uint32_t forks);
+
+    /// Verify a set of inputs of the transaction, serializing the transaction
+    /// and its prevouts once. Returns the result and the accumulated sigchecks,
+    /// failed_index is set to the input index of the failure (if any).
+    /// The verified signatures are added to the signature cache if
+    /// store_signatures is set (transaction pool).
+    static
+    std::pair<code, size_t> verify_scripts(domain::chain::transaction const& tx, std::vector<uint32_t> const& input_indexes, uint32_t forks, uint32_t& failed_index, bool store_signatures = false);
 };
 
 } // namespace kth::blockchain
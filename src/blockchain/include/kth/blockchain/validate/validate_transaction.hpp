@@ -7,12 +7,14 @@
 
 #include <atomic>
 #include <cstddef>
+#include <memory>
 
 #include <kth/blockchain/define.hpp>
 #include <kth/blockchain/interface/fast_chain.hpp>
 #include <kth/blockchain/pools/branch.hpp>
 #include <kth/blockchain/populate/populate_transaction.hpp>
 #include <kth/blockchain/settings.hpp>
+#include <kth/blockchain/validate/script_cache.hpp>
 #include <kth/domain.hpp>
 
 #if defined(KTH_WITH_MEMPOOL)
@@ -27,9 +29,9 @@ struct KB_API validate_transaction {
     using result_handler = handle0;
 
 #if defined(KTH_WITH_MEMPOOL)
-    validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings, mining::mempool const& mp);
+    validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache& scripts, mining::mempool const& mp);
 #else
-    validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings);
+    validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache& scripts);
 #endif
 
     void start();
@@ -46,16 +48,21 @@ protected:
     }
 
 private:
+    using atomic_counter = std::atomic<size_t>;
+    using atomic_counter_ptr = std::shared_ptr<atomic_counter>;
+
     void handle_populated(code const& ec, transaction_const_ptr tx, result_handler handler) const;
-    void connect_inputs(transaction_const_ptr tx, size_t bucket, size_t buckets, result_handler handler) const;
+    void connect_inputs(transaction_const_ptr tx, size_t bucket, size_t buckets, atomic_counter_ptr sigchecks, result_handler handler) const;
+    void handle_connected(code const& ec, transaction_const_ptr tx, atomic_counter_ptr sigchecks, result_handler handler) const;
 
     // These are thread safe.
     std::atomic<bool> stopped_;
     bool const retarget_;
     fast_chain const& fast_chain_;
     dispatcher& dispatch_;
+    script_cache& script_cache_;
 
-    // Caller must not invoke accept/connect concurrently.
+    // Stateless, accept/connect may be invoked concurrently for distinct transactions.
     populate_transaction transaction_populator_;
 };
 
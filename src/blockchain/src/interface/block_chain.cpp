@@ -5,13 +5,14 @@
 #include <kth/blockchain/interface/block_chain.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <latch>
-
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -26,6 +27,10 @@
 #include <kth/infrastructure/utility/limits.hpp>
 #include <kth/infrastructure/utility/timer.hpp>
 
+#ifdef WITH_CONSENSUS
+#include <kth/consensus.hpp>
+#endif
+
 namespace kth {
 //TODO: remove from here
 time_t floor_subtract(time_t left, time_t right) {
@@ -76,6 +81,16 @@ using namespace std::placeholders;
 
 static auto const hour_seconds = 3600u;
 
+namespace {
+
+// Same resolution as the arrival time of the store.
+uint32_t arrival_time_now() {
+    auto const now = std::chrono::high_resolution_clock::now();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
+}
+
+} // anonymous namespace
+
 block_chain::block_chain(threadpool& pool, blockchain::settings const& chain_settings
                        , database::settings const& database_settings, domain::config::network network, bool relay_transactions /* = true*/)
     : stopped_(true)
@@ -86,14 +101,16 @@ block_chain::block_chain(threadpool& pool, blockchain::settings const& chain_set
     , validation_mutex_(relay_transactions)
     , priority_pool_("blockchain", thread_ceiling(chain_settings.cores), priority(chain_settings.priority))
     , dispatch_(priority_pool_, NAME "_priority")
+    , script_cache_(chain_settings.script_cache_capacity)
+    , recent_blocks_(chain_settings.recent_blocks_capacity)
 
 #if defined(KTH_WITH_MEMPOOL)
     , mempool_(chain_settings.mempool_max_template_size, chain_settings.mempool_size_multiplier)
-    , transaction_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings, mempool_)
-    , block_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings, network, relay_transactions, mempool_)
+    , transaction_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings, script_cache_, mempool_)
+    , block_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings, script_cache_, network, relay_transactions, mempool_)
 #else
-    , transaction_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings)
-    , block_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings, network, relay_transactions)
+    , transaction_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings, script_cache_)
+    , block_organizer_(validation_mutex_, dispatch_, pool, *this, chain_settings, script_cache_, network, relay_transactions)
 #endif
 {}
 
@@ -165,9 +182,9 @@ bool block_chain::get_block_exists_safe(hash_digest const& block_hash) const {
 }
 
 bool block_chain::get_block_hash(hash_digest& out_hash, size_t height) const {
-    auto const result = database_.internal_db().get_header(height);
-    if ( ! result.is_valid()) return false;
-    out_hash = result.hash();
+    auto const entry = get_header_entry(height);
+    if ( ! entry) return false;
+    out_hash = entry->hash;
     return true;
 }
 
@@ -175,6 +192,24 @@ bool block_chain::get_branch_work(uint256_t& out_work, uint256_t const& maximum,
     size_t top;
     if ( ! get_last_height(top)) return false;
 
+    // The cumulative chain work makes this a difference of two entries.
+    auto const& index = database_.internal_db().get_header_index();
+    if ( ! index.empty()) {
+        out_work = 0;
+        if (from_height > top) return true;
+
+        auto const last = index.get(top);
+        if ( ! last) return false;
+        out_work = last->work;
+
+        if (from_height > 0) {
+            auto const previous = index.get(from_height - 1);
+            if ( ! previous) return false;
+            out_work -= previous->work;
+        }
+        return true;
+    }
+
     out_work = 0;
     for (uint32_t height = from_height; height <= top && out_work < maximum; ++height) {
         auto const result = database_.internal_db().get_header(height);
@@ -206,23 +241,23 @@ bool block_chain::get_height(size_t& out_height, hash_digest const& block_hash)
 }
 
 bool block_chain::get_bits(uint32_t& out_bits, size_t height) const {
-    auto result = database_.internal_db().get_header(height);
-    if ( ! result.is_valid()) return false;
-    out_bits = result.bits();
+    auto const entry = get_header_entry(height);
+    if ( ! entry) return false;
+    out_bits = entry->bits;
     return true;
 }
 
 bool block_chain::get_timestamp(uint32_t& out_timestamp, size_t height) const {
-    auto result = database_.internal_db().get_header(height);
-    if ( ! result.is_valid()) return false;
-    out_timestamp = result.timestamp();
+    auto const entry = get_header_entry(height);
+    if ( ! entry) return false;
+    out_timestamp = entry->timestamp;
     return true;
 }
 
 bool block_chain::get_version(uint32_t& out_version, size_t height) const {
-    auto result = database_.internal_db().get_header(height);
-    if ( ! result.is_valid()) return false;
-    out_version = result.version();
+    auto const entry = get_header_entry(height);
+    if ( ! entry) return false;
+    out_version = entry->version;
     return true;
 }
 
@@ -233,12 +268,12 @@ bool block_chain::get_last_height(size_t& out_height) const {
     return succeed(res);
 }
 
-bool block_chain::get_utxo(domain::chain::output& out_output, size_t& out_height, uint32_t& out_median_time_past, bool& out_coinbase, domain::chain::output_point const& outpoint, size_t branch_height) const {
+bool block_chain::get_utxo(domain::chain::prevout_cache& out_output, size_t& out_height, uint32_t& out_median_time_past, bool& out_coinbase, domain::chain::output_point const& outpoint, size_t branch_height) const {
     auto entry = database_.internal_db().get_utxo(outpoint);
     if ( ! entry.is_valid()) return false;
     if (entry.height() > branch_height) return false;
 
-    out_output = entry.output();
+    out_output = entry.shared_output();
     out_height = entry.height();
     out_median_time_past = entry.median_time_past();
     out_coinbase = entry.coinbase();
@@ -255,13 +290,31 @@ std::pair<bool, database::internal_database::utxo_pool_t> block_chain::get_utxo_
     return {true, std::move(p.second)};
 }
 
+std::pair<size_t, size_t> block_chain::get_utxo_cache_stats() const {
+    auto const& cache = database_.internal_db().get_utxo_cache();
+    return {cache.hits(), cache.misses()};
+}
+
+bool block_chain::get_utxo_set_hash(hash_digest& out_hash, size_t height) const {
+    auto const hash = database_.internal_db().get_utxo_set_hash(uint32_t(height));
+    if ( ! hash) return false;
+    out_hash = *hash;
+    return true;
+}
+
 // Writers
 // ----------------------------------------------------------------------------
 #if ! defined(KTH_DB_READONLY)
 
 // bool block_chain::insert(block_const_ptr block, size_t height, int) {
 bool block_chain::insert(block_const_ptr block, size_t height) {
-    return database_.insert(*block, height) == error::success;
+    if (database_.insert(block, height) != error::success) {
+        return false;
+    }
+
+    // Confirmed transactions leave the in-memory pool.
+    unconfirmed_pool_.remove(*block);
+    return true;
 }
 
 void block_chain::push(transaction_const_ptr tx, dispatcher&, result_handler handler) {
@@ -270,7 +323,12 @@ void block_chain::push(transaction_const_ptr tx, dispatcher&, result_handler han
     //last_transaction_.store(tx);
 
     // Transaction push is currently sequential so dispatch is not used.
-    handler(database_.push(*tx, chain_state()->enabled_forks()));
+    auto const ec = database_.push(*tx, chain_state()->enabled_forks());
+    if ( ! ec) {
+        unconfirmed_pool_.add(tx, arrival_time_now());
+    }
+
+    handler(ec);
 }
 
 #endif // ! defined(KTH_DB_READONLY)
@@ -305,16 +363,23 @@ void block_chain::reorganize(const infrastructure::config::checkpoint& fork_poin
     }
 
     // The top (back) block is used to update the chain state.
-    auto const complete = std::bind(&block_chain::handle_reorganize, this, _1, incoming_blocks->back(), handler);
+    auto const complete = std::bind(&block_chain::handle_reorganize, this, _1, incoming_blocks, handler);
     database_.reorganize(fork_point, incoming_blocks, outgoing_blocks, dispatch, complete);
 }
 
-void block_chain::handle_reorganize(code const& ec, block_const_ptr top, result_handler handler) {
+void block_chain::handle_reorganize(code const& ec, block_const_ptr_list_const_ptr incoming_blocks, result_handler handler) {
     if (ec) {
         handler(ec);
         return;
     }
 
+    // Confirmed transactions leave the in-memory pool.
+    for (auto const& block : *incoming_blocks) {
+        unconfirmed_pool_.remove(*block);
+    }
+
+    auto const top = incoming_blocks->back();
+
     if ( ! top->validation.state) {
         handler(error::chain_state_invalid);
         return;
@@ -323,6 +388,34 @@ void block_chain::handle_reorganize(code const& ec, block_const_ptr top, result_
     set_chain_state(top->validation.state);
     last_block_.store(top);
 
+    // The incoming blocks are consecutive, from the fork point up.
+    auto height = top->validation.state->height() - incoming_blocks->size() + 1;
+    for (auto const& block : *incoming_blocks) {
+        recent_blocks_.add(block, height++);
+    }
+
+    auto const& cache = database_.internal_db().get_utxo_cache();
+    if ( ! cache.disabled()) {
+        spdlog::debug("[blockchain] UTXO cache size: {}, hit rate: {:.2f}%", cache.size(), cache.hit_rate() * 100);
+    }
+
+    if ( ! script_cache_.disabled()) {
+        spdlog::debug("[blockchain] Script cache size: {}, hit rate: {:.2f}%, tx pool hit rate: {:.2f}%", script_cache_.size(), script_cache_.hit_rate() * 100, top->validation.cache_efficiency * 100);
+    }
+
+#ifdef WITH_CONSENSUS
+    size_t signature_hits;
+    size_t signature_queries;
+    consensus::get_signature_cache_stats(signature_hits, signature_queries);
+    if (signature_queries != 0) {
+        spdlog::debug("[blockchain] Signature cache hit rate: {:.2f}%", signature_hits * 100.0f / signature_queries);
+    }
+#endif
+
+    auto const admissions = transaction_organizer_.depth();
+    spdlog::debug("[blockchain] Transaction admissions waiting: {}, checking: {}, populating: {}, verifying: {}, committing: {}",
+        admissions.waiting, admissions.checking, admissions.populating, admissions.verifying, admissions.committing);
+
     handler(error::success);
 }
 
@@ -350,6 +443,59 @@ domain::chain::chain_state::ptr block_chain::chain_state(branch::const_ptr branc
     return chain_state_populator_.populate(chain_state(), branch);
 }
 
+// private.
+// Served by the in-memory header index, read from the store only if the
+// index is not loaded (the chain work is not set in that case).
+std::optional<database::header_index::entry> block_chain::get_header_entry(size_t height) const {
+    if (height > max_uint32) {
+        return std::nullopt;
+    }
+
+    auto const& internal = database_.internal_db();
+    if ( ! internal.get_header_index().empty()) {
+        return internal.get_header_index().get(uint32_t(height));
+    }
+
+    auto const result = internal.get_header_and_abla_state(uint32_t(height));
+    if ( ! result) {
+        return std::nullopt;
+    }
+
+    auto const& header = std::get<0>(*result);
+    return database::header_index::entry{
+        header.hash(),
+        header.merkle(),
+        header.version(),
+        header.timestamp(),
+        header.bits(),
+        header.nonce(),
+        std::get<1>(*result),
+        std::get<2>(*result),
+        std::get<3>(*result),
+        0
+    };
+}
+
+// The stored txid index avoids loading the block, blocks stored before the
+// index existed (and pruned stores) fall back to the block.
+hash_list block_chain::block_transaction_hashes(size_t height) const {
+    auto const recent = recent_blocks_.find(height);
+    if (recent) {
+        return recent->to_hashes();
+    }
+
+    auto hashes = database_.internal_db().get_block_tx_hashes(uint32_t(height));
+    if ( ! hashes.empty()) {
+        return hashes;
+    }
+
+    auto const block = database_.internal_db().get_block(uint32_t(height));
+    if ( ! block.is_valid()) {
+        return {};
+    }
+    return block.to_hashes();
+}
+
 // private.
 code block_chain::set_chain_state(domain::chain::chain_state::ptr previous) {
     // Critical Section
@@ -379,6 +525,17 @@ bool block_chain::start() {
     //switch to fast mode if the database is stale
     //set_database_flags();
 
+    // Load the unconfirmed transactions of the store into memory.
+    for (auto const& entry : database_.internal_db().get_all_transaction_unconfirmed()) {
+        auto const tx = std::make_shared<transaction const>(entry.transaction());
+        unconfirmed_pool_.add(tx, entry.arrival_time());
+    }
+
+#ifdef WITH_CONSENSUS
+    // Before any script is verified.
+    consensus::set_signature_cache_capacity(settings_.signature_cache_capacity);
+#endif
+
     // Initialize chain state after database start but before organizers.
     pool_state_ = chain_state_populator_.populate();
     if ( ! pool_state_) {
@@ -442,6 +599,13 @@ void block_chain::fetch_block(size_t height,
         return;
     }
 
+    // Try the recent blocks first.
+    auto const recent = recent_blocks_.find(height);
+    if (recent) {
+        handler(error::success, recent, height);
+        return;
+    }
+
     auto const cached = last_block_.load();
 
     // Try the cached block first.
@@ -470,6 +634,14 @@ void block_chain::fetch_block(hash_digest const& hash,
         return;
     }
 
+    // Try the recent blocks first.
+    size_t recent_height;
+    auto const recent = recent_blocks_.find(hash, recent_height);
+    if (recent) {
+        handler(error::success, recent, recent_height);
+        return;
+    }
+
     auto const cached = last_block_.load();
 
     // Try the cached block first.
@@ -492,6 +664,41 @@ void block_chain::fetch_block(hash_digest const& hash,
     handler(error::success, result, height);
 }
 
+void block_chain::fetch_block_data(hash_digest const& hash, block_data_fetch_handler handler) const {
+    if (stopped()) {
+        handler(error::service_stopped, nullptr, 0);
+        return;
+    }
+
+    // Try the recent blocks first, their encoding is shared.
+    size_t recent_height;
+    auto const recent = recent_blocks_.data(hash, recent_height);
+    if (recent) {
+        handler(error::success, recent, recent_height);
+        return;
+    }
+
+    auto const cached = last_block_.load();
+
+    // The cached block is already deserialized, serializing it is cheaper.
+    if (cached && cached->validation.state && cached->hash() == hash) {
+        handler(error::success, std::make_shared<data_chunk const>(cached->domain::chain::block::to_data()), cached->validation.state->height());
+        return;
+    }
+
+    auto block_result = database_.internal_db().get_block_data(hash);
+
+    if (block_result.first.empty()) {
+        handler(error::not_found, nullptr, 0);
+        return;
+    }
+
+    auto const height = block_result.second;
+    auto const result = std::make_shared<data_chunk const>(std::move(block_result.first));
+
+    handler(error::success, result, height);
+}
+
 void block_chain::fetch_block_header_txs_size(hash_digest const& hash,
     block_header_txs_size_fetch_handler handler) const {
     if (stopped()) {
@@ -521,15 +728,20 @@ void block_chain::fetch_merkle_block(size_t height, merkle_block_fetch_handler h
         return;
     }
 
-    auto const block_result = database_.internal_db().get_block(height);
+    auto const header = database_.internal_db().get_header(uint32_t(height));
+    if ( ! header.is_valid()) {
+        handler(error::not_found, nullptr, 0);
+        return;
+    }
 
-    if ( ! block_result.is_valid()) {
+    auto hashes = block_transaction_hashes(height);
+    if (hashes.empty()) {
         handler(error::not_found, nullptr, 0);
         return;
     }
 
-    auto const merkle = std::make_shared<merkle_block>(block_result.header(),
-        block_result.transactions().size(), block_result.to_hashes(), data_chunk{});
+    auto const count = hashes.size();
+    auto const merkle = std::make_shared<merkle_block>(header, count, std::move(hashes), data_chunk{});
     handler(error::success, merkle, height);
 }
 
@@ -540,16 +752,22 @@ void block_chain::fetch_merkle_block(hash_digest const& hash,
         return;
     }
 
-    auto const block_result = database_.internal_db().get_block(hash);
+    auto const header = database_.internal_db().get_header(hash);
+    if ( ! header.first.is_valid()) {
+        handler(error::not_found, nullptr, 0);
+        return;
+    }
 
-    if ( ! block_result.first.is_valid()) {
+    auto const height = header.second;
+    auto hashes = block_transaction_hashes(height);
+    if (hashes.empty()) {
         handler(error::not_found, nullptr, 0);
         return;
     }
 
-    auto const merkle = std::make_shared<merkle_block>(block_result.first.header(),
-        block_result.first.transactions().size(), block_result.first.to_hashes(), data_chunk{});
-    handler(error::success, merkle, block_result.second);
+    auto const count = hashes.size();
+    auto const merkle = std::make_shared<merkle_block>(header.first, count, std::move(hashes), data_chunk{});
+    handler(error::success, merkle, height);
 }
 
 void block_chain::fetch_compact_block(size_t height, compact_block_fetch_handler handler) const {
@@ -563,6 +781,14 @@ void block_chain::fetch_compact_block(hash_digest const& hash, compact_block_fet
         return;
     }
 
+    // The compact block of a recent block is built once, for all the peers.
+    size_t recent_height;
+    auto const recent = recent_blocks_.compact(hash, recent_height);
+    if (recent) {
+        handler(error::success, recent, recent_height);
+        return;
+    }
+
     fetch_block(hash,[&handler](code const& ec, block_const_ptr message, size_t height) {
         if (ec == error::success) {
             auto blk_ptr = std::make_shared<compact_block>(compact_block::factory_from_block(*message));
@@ -689,6 +915,14 @@ void block_chain::fetch_transaction_position(hash_digest const& hash, bool requi
         return;
     }
 
+    // The position is read from the stored entry without the transaction.
+    uint32_t height;
+    uint32_t position;
+    if (database_.internal_db().get_transaction_position(hash, height, position) == database::result_code::success) {
+        handler(error::success, position, height);
+        return;
+    }
+
     auto const result = database_.internal_db().get_transaction(hash, max_size_t);
 
     if ( result.is_valid() ) {
@@ -710,14 +944,39 @@ void block_chain::fetch_transaction_position(hash_digest const& hash, bool requi
     handler(error::success, position_max, result2.height());
 }
 
+void block_chain::fetch_merkle_branch(hash_digest const& tx_hash, merkle_branch_fetch_handler handler) const {
+    if (stopped()) {
+        handler(error::service_stopped, {}, 0, 0);
+        return;
+    }
 
-//TODO (Mario) : Review and move to proper location
-hash_digest generate_merkle_root(std::vector<domain::chain::transaction> transactions) {
-    using std::swap;
+    uint32_t height;
+    uint32_t position;
+    if (database_.internal_db().get_transaction_position(tx_hash, height, position) != database::result_code::success) {
+        auto const result = database_.internal_db().get_transaction(tx_hash, max_size_t);
+        if ( ! result.is_valid()) {
+            handler(error::not_found, {}, 0, 0);
+            return;
+        }
+        height = result.height();
+        position = result.position();
+    }
+
+    auto hashes = block_transaction_hashes(height);
+    if (position >= hashes.size() || hashes[position] != tx_hash) {
+        handler(error::not_found, {}, 0, 0);
+        return;
+    }
 
-    if (transactions.empty()) return null_hash;
+    auto const branch = domain::chain::block::generate_merkle_branch(std::move(hashes), position);
+    handler(error::success, branch, position, height);
+}
 
+
+//TODO (Mario) : Review and move to proper location
+hash_digest generate_merkle_root(std::vector<domain::chain::transaction> transactions) {
     hash_list merkle;
+    merkle.reserve(transactions.size());
 
     auto hasher = [&merkle](transaction const& tx) {
         merkle.push_back(tx.hash());
@@ -725,27 +984,7 @@ hash_digest generate_merkle_root(std::vector<domain::chain::transaction> transac
 
     // Hash ordering matters, don't use std::transform here.
     std::for_each(transactions.begin(), transactions.end(), hasher);
-
-    hash_list update;
-    // Initial capacity is half of the original list (clear doesn't reset).
-    update.reserve((merkle.size() + 1) / 2);
-
-    while (merkle.size() > 1) {
-        // If number of hashes is odd, duplicate last hash in the list.
-        if (merkle.size() % 2 != 0) {
-            merkle.push_back(merkle.back());
-        }
-
-        for (auto it = merkle.begin(); it != merkle.end(); it += 2) {
-            update.push_back(bitcoin_hash(build_chunk({ it[0], it[1] })));
-        }
-
-        swap(merkle, update);
-        update.clear();
-    }
-
-    // There is now only one item in the list.
-    return merkle.front();
+    return domain::chain::block::generate_merkle_root(std::move(merkle));
 }
 
 namespace {
@@ -763,9 +1002,28 @@ std::tuple<uint8_t, uint8_t> get_address_versions(bool use_testnet_rules) {
 
 }
 
+// The unconfirmed pool indexes the addresses with the mainnet versions.
+std::optional<kth::domain::wallet::payment_address> to_pool_address(kth::domain::wallet::payment_address const& address, bool use_testnet_rules) {
+    using kth::domain::wallet::payment_address;
+    auto const [encoding_p2kh, encoding_p2sh] = get_address_versions(use_testnet_rules);
+
+    uint8_t version;
+    if (address.version() == encoding_p2kh) {
+        version = payment_address::mainnet_p2kh;
+    } else if (address.version() == encoding_p2sh) {
+        version = payment_address::mainnet_p2sh;
+    } else {
+        return std::nullopt;
+    }
+
+    if (address.hash_span().size() == kth::hash_size) {
+        return payment_address(address.hash32(), version);
+    }
+    return payment_address(address.hash20(), version);
+}
+
 } // anonymous namespace
 
-//TODO(fernando): refactor!!!
 std::vector<kth::blockchain::mempool_transaction_summary> block_chain::get_mempool_transactions(std::vector<std::string> const& payment_addresses, bool use_testnet_rules) const {
 /*          "    \"address\"  (string) The base58check encoded address\n"
             "    \"txid\"  (string) The related txid\n"
@@ -776,63 +1034,60 @@ std::vector<kth::blockchain::mempool_transaction_summary> block_chain::get_mempo
             "    \"prevout\"  (string) The previous transaction output index (if spending)\n"
 */
 
-    auto const [encoding_p2kh, encoding_p2sh] = get_address_versions(use_testnet_rules);
-
     std::vector<kth::blockchain::mempool_transaction_summary> ret;
 
     std::unordered_set<kth::domain::wallet::payment_address> addrs;
     for (auto const& payment_address : payment_addresses) {
         kth::domain::wallet::payment_address address(payment_address);
-        if (address){
+        if (address) {
             addrs.insert(address);
         }
     }
 
-    auto const result = database_.internal_db().get_all_transaction_unconfirmed();
+    for (auto const& address : addrs) {
+        auto const pool_address = to_pool_address(address, use_testnet_rules);
+        if ( ! pool_address) {
+            continue;
+        }
 
-    for (auto const& tx_res : result) {
-        auto const& tx = tx_res.transaction();
-        //tx.recompute_hash();
-        size_t i = 0;
-        for (auto const& output : tx.outputs()) {
-            auto const tx_addresses = kth::domain::wallet::payment_address::extract(output.script(), encoding_p2kh, encoding_p2sh);
-            for(auto const tx_address : tx_addresses) {
-                if (tx_address && addrs.find(tx_address) != addrs.end()) {
-                    ret.push_back
-                            (kth::blockchain::mempool_transaction_summary
-                                     (tx_address.encoded_cashaddr(false), kth::encode_hash(tx.hash()), "",
-                                      "", std::to_string(output.value()), i, tx_res.arrival_time()));
-                }
+        auto const encoded = address.encoded_cashaddr(false);
+
+        for (auto const& entry : unconfirmed_pool_.get_address_entries(*pool_address)) {
+            auto const& tx = *entry.tx;
+
+            if ( ! entry.input) {
+                ret.push_back(kth::blockchain::mempool_transaction_summary(
+                    encoded, kth::encode_hash(tx.hash()), "", "",
+                    std::to_string(tx.outputs()[entry.index].value()),
+                    entry.index, entry.arrival_time));
+                continue;
             }
-            ++i;
-        }
-        i = 0;
-        for (auto const& input : tx.inputs()) {
-            // TODO(kth): payment_addrress::extract should use the prev_output script instead of the input script
-            // see https://github.com/k-nuth/core/blob/v0.10.0/src/wallet/payment_address.cpp#L505
-            auto const tx_addresses = kth::domain::wallet::payment_address::extract(input.script(), encoding_p2kh, encoding_p2sh);
-            for(auto const tx_address : tx_addresses)
-            if (tx_address && addrs.find(tx_address) != addrs.end()) {
-                std::latch latch(1);
-                fetch_transaction(input.previous_output().hash(), false,
-                                  [&](const kth::code &ec,
-                                      kth::transaction_const_ptr tx_ptr, size_t index,
-                                      size_t height) {
-                                      if (ec == kth::error::success) {
-                                          ret.push_back(kth::blockchain::mempool_transaction_summary
-                                                                (tx_address.encoded_cashaddr(false),
-                                                                kth::encode_hash(tx.hash()),
-                                                                kth::encode_hash(input.previous_output().hash()),
-                                                                 std::to_string(input.previous_output().index()),
-                                                                "-"+std::to_string(tx_ptr->outputs()[input.previous_output().index()].value()),
-                                                                i,
-                                                                tx_res.arrival_time()));
-                                      }
-                                      latch.count_down();
-                                  });
-                latch.wait();
+
+            auto const& prevout = tx.inputs()[entry.index].previous_output();
+            auto const push_input = [&](uint64_t value) {
+                ret.push_back(kth::blockchain::mempool_transaction_summary(
+                    encoded, kth::encode_hash(tx.hash()),
+                    kth::encode_hash(prevout.hash()),
+                    std::to_string(prevout.index()),
+                    "-" + std::to_string(value),
+                    entry.index, entry.arrival_time));
+            };
+
+            // The previous output is usually cached by the validation.
+            if (prevout.validation.cache.is_valid()) {
+                push_input(prevout.validation.cache.value());
+                continue;
             }
-            ++i;
+
+            std::latch latch(1);
+            fetch_transaction(prevout.hash(), false,
+                [&](kth::code const& ec, kth::transaction_const_ptr tx_ptr, size_t, size_t) {
+                    if (ec == kth::error::success) {
+                        push_input(tx_ptr->outputs()[prevout.index()].value());
+                    }
+                    latch.count_down();
+                });
+            latch.wait();
         }
     }
 
@@ -841,48 +1096,22 @@ std::vector<kth::blockchain::mempool_transaction_summary> block_chain::get_mempo
 
 // Precondition: valid payment addresses
 std::vector<domain::chain::transaction> block_chain::get_mempool_transactions_from_wallets(std::vector<domain::wallet::payment_address> const& payment_addresses, bool use_testnet_rules) const {
-    auto const [encoding_p2kh, encoding_p2sh] = get_address_versions(use_testnet_rules);
-
     std::vector<domain::chain::transaction> ret;
 
-    auto const result = database_.internal_db().get_all_transaction_unconfirmed();
-
-    for (auto const& tx_res : result) {
-        auto const& tx = tx_res.transaction();
-        //tx.recompute_hash();
-        // Only insert the transaction once. Avoid duplicating the tx if serveral wallets are used in the same tx, and if the same wallet is the input and output addr.
-        bool inserted = false;
+    // Only insert the transaction once. Avoid duplicating the tx if serveral wallets are used in the same tx, and if the same wallet is the input and output addr.
+    std::unordered_set<hash_digest> inserted;
 
-        for (auto iter_output = tx.outputs().begin(); (iter_output != tx.outputs().end() && !inserted); ++iter_output) {
-
-            auto const tx_addresses = kth::domain::wallet::payment_address::extract((*iter_output).script(), encoding_p2kh, encoding_p2sh);
-
-            for (auto iter_addr = tx_addresses.begin(); (iter_addr != tx_addresses.end() && !inserted); ++iter_addr) {
-                if (*iter_addr) {
-                    auto it = std::find(payment_addresses.begin(), payment_addresses.end(), *iter_addr);
-                    if (it != payment_addresses.end()) {
-                        ret.push_back(tx);
-                        inserted = true;
-                    }
-                }
-            }
+    for (auto const& address : payment_addresses) {
+        auto const pool_address = to_pool_address(address, use_testnet_rules);
+        if ( ! pool_address) {
+            continue;
         }
 
-        for (auto iter_input = tx.inputs().begin(); (iter_input != tx.inputs().end() && !inserted); ++iter_input) {
-            // TODO(kth): payment_addrress::extract should use the prev_output script instead of the input script
-            // see https://github.com/k-nuth/core/blob/v0.10.0/src/wallet/payment_address.cpp#L505
-            auto const tx_addresses = kth::domain::wallet::payment_address::extract((*iter_input).script(), encoding_p2kh, encoding_p2sh);
-            for (auto iter_addr = tx_addresses.begin(); (iter_addr != tx_addresses.end() && !inserted); ++iter_addr) {
-                if (*iter_addr) {
-                    auto it = std::find(payment_addresses.begin(), payment_addresses.end(), *iter_addr);
-                    if (it != payment_addresses.end()) {
-                        ret.push_back(tx);
-                        inserted = true;
-                    }
-                }
+        for (auto const& entry : unconfirmed_pool_.get_address_entries(*pool_address)) {
+            if (inserted.insert(entry.tx->hash()).second) {
+                ret.push_back(*entry.tx);
             }
         }
-
     }
 
     return ret;
@@ -896,43 +1125,66 @@ void block_chain::fill_tx_list_from_mempool(domain::message::compact_block const
     auto k0 = from_little_endian_unsafe<uint64_t>(header_hash);
     auto k1 = from_little_endian_unsafe<uint64_t>(std::span{header_hash}.subspan(sizeof(uint64_t)));
 
-    auto const result = database_.internal_db().get_all_transaction_unconfirmed();
-
-    for (auto const& tx_res : result) {
-        auto const& tx = tx_res.transaction();
+    // Pooled (and recently rejected) transactions are kept in memory.
+    auto const pool = unconfirmed_pool_.take_snapshot();
+    auto const short_ids = compute_short_ids(k0, k1, pool.hashes);
 
-        uint64_t shortid = sip_hash_uint256(k0, k1, tx.hash()) & uint64_t(0xffffffffffff);
+    for (size_t i = 0; i < pool.hashes.size(); ++i) {
+        uint64_t shortid = short_ids[i] & uint64_t(0xffffffffffff);
 
         auto idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if ( ! have_txn[idit->second]) {
-                txn_available[idit->second] = tx;
-                have_txn[idit->second] = true;
-                ++mempool_count;
-            } else {
-                // If we find two mempool txn that match the short id, just
-                // request it. This should be rare enough that the extra
-                // bandwidth doesn't matter, but eating a round-trip due to
-                // FillBlock failure would be annoying.
-                if (txn_available[idit->second].is_valid()) {
-                    //txn_available[idit->second].reset();
-                    txn_available[idit->second] = domain::chain::transaction{};
-                    --mempool_count;
-                }
-            }
+        if (idit == shorttxids.end()) {
+            continue;
         }
 
-        //TODO (Mario) :  break the loop
-        // Though ideally we'd continue scanning for the
-        // two-txn-match-shortid case, the performance win of an early exit
-        // here is too good to pass up and worth the extra risk.
-        /*if (mempool_count == shorttxids.size()) {
-            return false;
+        auto& available = txn_available[idit->second];
+        if ( ! have_txn[idit->second]) {
+            available = *pool.transactions[i];
+            have_txn[idit->second] = true;
+            ++mempool_count;
+        } else if (available.is_valid() && available.hash() == pool.hashes[i]) {
+            // The same transaction, in the pool and in the extra ring.
+            continue;
         } else {
-            return true;
-        }*/
+            // If we find two mempool txn that match the short id, just
+            // request it. This should be rare enough that the extra
+            // bandwidth doesn't matter, but eating a round-trip due to
+            // FillBlock failure would be annoying.
+            if (available.is_valid()) {
+                available = domain::chain::transaction{};
+                --mempool_count;
+            }
+        }
+    }
+}
+
+// private
+// Short ids of large pools are computed in chunks on the priority pool.
+std::vector<uint64_t> block_chain::compute_short_ids(uint64_t k0, uint64_t k1, std::vector<hash_digest> const& hashes) const {
+    static constexpr size_t min_chunk_size = 4096;
+
+    std::vector<uint64_t> short_ids(hashes.size());
+    auto const chunks = std::min(dispatch_.size(), hashes.size() / min_chunk_size);
+
+    if (chunks <= 1) {
+        sip_hash_uint256_batch(k0, k1, hashes.data(), hashes.size(), short_ids.data());
+        return short_ids;
     }
 
+    auto const chunk_size = (hashes.size() + chunks - 1) / chunks;
+    std::latch latch(chunks);
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        auto const first = chunk * chunk_size;
+        auto const count = std::min(chunk_size, hashes.size() - first);
+        dispatch_.concurrent([&, first, count] {
+            sip_hash_uint256_batch(k0, k1, hashes.data() + first, count, short_ids.data() + first);
+            latch.count_down();
+        });
+    }
+
+    latch.wait();
+    return short_ids;
 }
 
 safe_chain::mempool_mini_hash_map block_chain::get_mempool_mini_hash_map(domain::message::compact_block const& block) const {
@@ -948,12 +1200,12 @@ safe_chain::mempool_mini_hash_map block_chain::get_mempool_mini_hash_map(domain:
     safe_chain::mempool_mini_hash_map mempool;
 
 
-    auto const result = database_.internal_db().get_all_transaction_unconfirmed();
+    auto const pool = unconfirmed_pool_.take_snapshot();
 
-    for (auto const& tx_res : result) {
-        auto const& tx = tx_res.transaction();
+    for (size_t i = 0; i < pool.pooled; ++i) {
+        auto const& tx = *pool.transactions[i];
 
-        auto sh = sip_hash_uint256(k0, k1, tx.hash());
+        auto sh = sip_hash_uint256(k0, k1, pool.hashes[i]);
 
        /* to_little_endian()
         uint64_t pepe = 4564564;
@@ -982,6 +1234,13 @@ void block_chain::fetch_unconfirmed_transaction(hash_digest const& hash, transac
         return;
     }
 
+    // The pool holds every accepted transaction, the store is the fallback.
+    auto const pooled = unconfirmed_pool_.find(hash);
+    if (pooled) {
+        handler(error::success, pooled);
+        return;
+    }
+
     auto const result = database_.internal_db().get_transaction_unconfirmed(hash);
 
     if ( ! result.is_valid()) {
@@ -1371,19 +1630,14 @@ void block_chain::fetch_locator_block_headers(get_headers_const_ptr locator, has
     }
 
     auto message = std::make_shared<headers>();
-    message->elements().reserve(floor_subtract(end, begin));
 
-    // Build the hash list until we hit end or the blockchain top.
-    for (auto height = begin; height < end; ++height) {
-        auto const result = database_.internal_db().get_header(height);
-
-        // If not found then we are at our top.
-        if ( ! result.is_valid()) {
-            message->elements().shrink_to_fit();
-            break;
-        }
-        message->elements().push_back(result);
+    // Build the header list until we hit end or the blockchain top.
+    if (begin < end && begin <= max_uint32) {
+        auto const last = std::min(end - 1, size_t(max_uint32));
+        auto const list = database_.internal_db().get_headers(uint32_t(begin), uint32_t(last));
+        message->elements().assign(list.begin(), list.end());
     }
+
     handler(error::success, std::move(message));
 }
 
@@ -1401,12 +1655,12 @@ void block_chain::fetch_block_locator(block::indexes const& heights, block_locat
     hashes.reserve(heights.size());
 
     for (auto const height : heights) {
-        auto const result = database_.internal_db().get_header(height);
-        if ( ! result.is_valid()) {
+        hash_digest hash;
+        if ( ! get_block_hash(hash, height)) {
             handler(error::not_found, nullptr);
-            break;
+            return;
         }
-        hashes.push_back(result.hash());
+        hashes.push_back(hash);
     }
 
     handler(error::success, message);
@@ -1507,21 +1761,17 @@ void block_chain::filter_transactions(get_data_ptr message, result_handler handl
 
 //TODO(fernando): Do we have to use the mempool when both KTH_DB_NEW_FULL and KTH_WITH_MEMPOOL are activated?
 #if defined(KTH_WITH_MEMPOOL)
-    auto validated_txs = mempool_.get_validated_txs_low();
-
-    if (validated_txs.empty()) {
-        handler(error::success);
-        return;
-    }
-
-    for (auto it = inventories.begin(); it != inventories.end();) {
-        auto found = validated_txs.find(it->hash());
-        if (it->is_transaction_type() && found != validated_txs.end()) {
-            it = inventories.erase(it);
-        } else {
-            ++it;
+    // Query the pool in place, it is not copied.
+    mempool_.with_validated_txs_low([&inventories](auto const& validated_txs) {
+        if (validated_txs.empty()) {
+            return false;
         }
-    }
+
+        std::erase_if(inventories, [&validated_txs](auto const& inventory) {
+            return inventory.is_transaction_type() && validated_txs.contains(inventory.hash());
+        });
+        return true;
+    });
 #else
 
     size_t out_height;
@@ -1609,7 +1859,16 @@ void block_chain::organize(block_const_ptr block, result_handler handler) {
 
 void block_chain::organize(transaction_const_ptr tx, result_handler handler) {
     // This cannot call organize or stop (lock safe).
-    transaction_organizer_.organize(tx, handler);
+    transaction_organizer_.organize(tx, [this, tx, handler](code const& ec) {
+        // Well-formed but not pooled, it may still be mined (BIP152).
+        if (ec == error::missing_previous_output || ec == error::orphan_transaction ||
+            ec == error::insufficient_fee || ec == error::dusty_transaction ||
+            ec == error::double_spend_mempool) {
+            unconfirmed_pool_.add_extra(tx);
+        }
+
+        handler(ec);
+    });
 }
 
 void block_chain::organize(double_spend_proof_const_ptr ds_proof, result_handler handler) {
@@ -1661,6 +1920,14 @@ bool block_chain::stopped() const {
 
 #if defined(KTH_WITH_MEMPOOL)
 std::pair<std::vector<kth::mining::transaction_element>, uint64_t> block_chain::get_block_template() const {
+#if defined(KTH_CURRENCY_BCH)
+    // Sized to the block size limit of the next block (ABLA).
+    auto const state = chain_state();
+    if (state) {
+        auto const limit = state->dynamic_max_block_size();
+        return mempool_.get_block_template(limit > coinbase_reserved_size ? limit - coinbase_reserved_size : 0);
+    }
+#endif
     return mempool_.get_block_template();
 }
 #endif
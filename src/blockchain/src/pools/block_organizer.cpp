@@ -32,9 +32,9 @@ using namespace std::placeholders;
 // transaction: { exists, height, output }
 
 #if defined(KTH_WITH_MEMPOOL)
-block_organizer::block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, domain::config::network network, bool relay_transactions, mining::mempool& mp)
+block_organizer::block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions, mining::mempool& mp)
 #else
-block_organizer::block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, domain::config::network network, bool relay_transactions)
+block_organizer::block_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions)
 #endif
     : fast_chain_(chain)
     , mutex_(mutex)
@@ -42,9 +42,9 @@ block_organizer::block_organizer(prioritized_mutex& mutex, dispatcher& dispatch,
     , dispatch_(dispatch)
     , block_pool_(settings.reorganization_limit)
 #if defined(KTH_WITH_MEMPOOL)
-    , validator_(dispatch, fast_chain_, settings, network, relay_transactions, mp)
+    , validator_(dispatch, fast_chain_, settings, scripts, network, relay_transactions, mp)
 #else
-    , validator_(dispatch, fast_chain_, settings, network, relay_transactions)
+    , validator_(dispatch, fast_chain_, settings, scripts, network, relay_transactions)
 #endif
     , subscriber_(std::make_shared<reorganize_subscriber>(thread_pool, NAME))
 
@@ -221,7 +221,7 @@ void block_organizer::populate_prevout_1(branch::const_ptr branch, domain::chain
 
     prevout.spent = false;
     prevout.confirmed = false;
-    prevout.cache = domain::chain::output{};
+    prevout.cache.reset();
     prevout.from_mempool = false;
 
     // If the input is a coinbase there is no prevout to populate.
@@ -238,13 +238,13 @@ void block_organizer::populate_prevout_1(branch::const_ptr branch, domain::chain
     // BUGBUG: Spends are not marked as spent by unconfirmed transactions.
     // So tx pool transactions currently have no double spend limitation.
     // The output is spent only if by a spend at or below the branch height.
-    auto const spend_height = prevout.cache.validation.spender_height;
+    auto const spend_height = prevout.cache.get().validation.spender_height;
 
     // The previous output has already been spent (double spend).
     if ((spend_height <= branch_height) && (spend_height != output::validation::not_spent)) {
         prevout.spent = true;
         prevout.confirmed = true;
-        prevout.cache = domain::chain::output{};
+        prevout.cache.reset();
     }
 }
 
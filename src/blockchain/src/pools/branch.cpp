@@ -216,7 +216,7 @@ void branch::populate_prevout(output_point const& outpoint) const {
     auto& prevout = outpoint.validation;
 
     // In case this input is a coinbase or the prevout is spent.
-    prevout.cache = domain::chain::output{};
+    prevout.cache.reset();
     prevout.coinbase = false;
     prevout.height = 0;
     prevout.median_time_past = 0;
@@ -256,7 +256,7 @@ void branch::populate_prevout(output_point const& outpoint, std::vector<std::uno
     auto& prevout = outpoint.validation;
 
     // In case this input is a coinbase or the prevout is spent.
-    prevout.cache = domain::chain::output{};
+    prevout.cache.reset();
     prevout.coinbase = false;
     prevout.height = 0;
     prevout.median_time_past = 0;
@@ -0,0 +1,175 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/blockchain/pools/recent_blocks.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace kth::blockchain {
+
+recent_blocks::recent_blocks(size_t capacity)
+    : capacity_(capacity)
+{}
+
+bool recent_blocks::disabled() const {
+    return capacity_ == 0;
+}
+
+size_t recent_blocks::capacity() const {
+    return capacity_;
+}
+
+size_t recent_blocks::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+}
+
+void recent_blocks::add(block_const_ptr block, size_t height) {
+    if (disabled()) {
+        return;
+    }
+
+    auto const hash = block->hash();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // A block at or above the height was reorganized out.
+    while ( ! heights_.empty() && heights_.rbegin()->first >= height) {
+        auto const top = heights_.rbegin()->second;
+        erase(top);
+    }
+
+    if (items_.size() >= capacity_) {
+        auto const oldest = lru_.back();
+        erase(oldest);
+    }
+
+    lru_.push_front(hash);
+    items_.emplace(hash, item{std::move(block), height, nullptr, nullptr, lru_.begin()});
+    heights_.emplace(height, hash);
+}
+
+void recent_blocks::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    items_.clear();
+    heights_.clear();
+}
+
+block_const_ptr recent_blocks::find(hash_digest const& hash, size_t& out_height) const {
+    if (disabled()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const found = touch(hash);
+    if (found == nullptr) {
+        return nullptr;
+    }
+
+    out_height = found->height;
+    return found->block;
+}
+
+block_const_ptr recent_blocks::find(size_t height) const {
+    if (disabled()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const it = heights_.find(height);
+    if (it == heights_.end()) {
+        return nullptr;
+    }
+
+    return touch(it->second)->block;
+}
+
+// The encodings are built out of the lock, concurrent first requests may
+// build them more than once, the last one is kept.
+recent_blocks::data_ptr recent_blocks::data(hash_digest const& hash, size_t& out_height) const {
+    if (disabled()) {
+        return nullptr;
+    }
+
+    block_const_ptr block;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const found = touch(hash);
+        if (found == nullptr) {
+            return nullptr;
+        }
+
+        out_height = found->height;
+        if (found->data) {
+            return found->data;
+        }
+        block = found->block;
+    }
+
+    auto const result = std::make_shared<data_chunk const>(block->domain::chain::block::to_data());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const it = items_.find(hash);
+    if (it != items_.end()) {
+        it->second.data = result;
+    }
+    return result;
+}
+
+compact_block_ptr recent_blocks::compact(hash_digest const& hash, size_t& out_height) const {
+    if (disabled()) {
+        return nullptr;
+    }
+
+    block_const_ptr block;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const found = touch(hash);
+        if (found == nullptr) {
+            return nullptr;
+        }
+
+        out_height = found->height;
+        if (found->compact) {
+            return found->compact;
+        }
+        block = found->block;
+    }
+
+    auto const result = std::make_shared<domain::message::compact_block>(domain::message::compact_block::factory_from_block(*block));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const it = items_.find(hash);
+    if (it != items_.end()) {
+        it->second.compact = result;
+    }
+    return result;
+}
+
+// private
+recent_blocks::item const* recent_blocks::touch(hash_digest const& hash) const {
+    auto const it = items_.find(hash);
+    if (it == items_.end()) {
+        return nullptr;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.position);
+    return &it->second;
+}
+
+// private
+void recent_blocks::erase(hash_digest const& hash) {
+    auto const it = items_.find(hash);
+    if (it == items_.end()) {
+        return;
+    }
+
+    heights_.erase(it->second.height);
+    lru_.erase(it->second.position);
+    items_.erase(it);
+}
+
+} // namespace kth::blockchain
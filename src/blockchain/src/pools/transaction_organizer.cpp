@@ -9,6 +9,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include <kth/blockchain/define.hpp>
@@ -27,9 +28,9 @@ using namespace std::placeholders;
 // TODO(legacy): create priority pool at blockchain level and use in both organizers.
 
 #if defined(KTH_WITH_MEMPOOL)
-transaction_organizer::transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, mining::mempool& mp)
+transaction_organizer::transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache& scripts, mining::mempool& mp)
 #else
-transaction_organizer::transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings)
+transaction_organizer::transaction_organizer(prioritized_mutex& mutex, dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain, settings const& settings, script_cache& scripts)
 #endif
     : fast_chain_(chain)
     , mutex_(mutex)
@@ -39,9 +40,9 @@ transaction_organizer::transaction_organizer(prioritized_mutex& mutex, dispatche
     , transaction_pool_(settings)
 
 #if defined(KTH_WITH_MEMPOOL)
-    , validator_(dispatch, fast_chain_, settings, mp)
+    , validator_(dispatch, fast_chain_, settings, scripts, mp)
 #else
-    , validator_(dispatch, fast_chain_, settings)
+    , validator_(dispatch, fast_chain_, settings, scripts)
 #endif
 
     , subscriber_(std::make_shared<transaction_subscriber>(thread_pool, NAME))
@@ -73,11 +74,18 @@ bool transaction_organizer::start() {
 
 bool transaction_organizer::stop() {
     validator_.stop();
+
+    // Wake admissions waiting on a conflicting transaction.
+    {
+        std::lock_guard<std::mutex> lock(claims_mutex_);
+        stopped_ = true;
+    }
+    claims_released_.notify_all();
+
     subscriber_->stop();
     subscriber_->invoke(error::service_stopped, {});
     ds_proof_subscriber_->stop();
     ds_proof_subscriber_->invoke(error::service_stopped, {});
-    stopped_ = true;
     return true;
 }
 
@@ -181,23 +189,38 @@ void transaction_organizer::organize(double_spend_proof_const_ptr ds_proof, resu
 
 // Transaction Organize sequence.
 //-----------------------------------------------------------------------------
+// Transactions that do not share prevouts are admitted concurrently, they
+// only hold the validation mutex shared (which excludes block organization).
+// The mempool and store writes are the only serialized stage.
 
 // This is called from blockchain::organize.
 void transaction_organizer::organize(transaction_const_ptr tx, result_handler handler) {
+    if (stopped()) {
+        handler(error::service_stopped);
+        return;
+    }
+
+    // Wait for in-flight transactions spending the same outputs or being
+    // spent by this one, their outcome determines the validity of this one.
+    claim(*tx);
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_low_priority();
+    mutex_.lock_low_priority_shared();
 
     if (stopped()) {
-        mutex_.unlock_low_priority();
+        mutex_.unlock_low_priority_shared();
+        release(*tx);
         handler(error::service_stopped);
         return;
     }
 
-    // Reset the reusable promise.
-    resume_ = std::promise<code>();
+    auto const resume = std::make_shared<std::promise<code>>();
+    result_handler const complete = [resume](code const& ec) {
+        resume->set_value(ec);
+    };
 
-    result_handler const complete = std::bind(&transaction_organizer::signal_completion, this, _1);
+    ++checking_;
     auto const check_handler = std::bind(&transaction_organizer::handle_check, this, _1, tx, complete);
 
     // Checks that are independent of chain state.
@@ -206,20 +229,59 @@ void transaction_organizer::organize(transaction_const_ptr tx, result_handler ha
     // Wait on completion signal.
     // This is necessary in order to continue on a non-priority thread.
     // If we do not wait on the original thread there may be none left.
-    auto ec = resume_.get_future().get();
+    auto ec = resume->get_future().get();
 
-    mutex_.unlock_low_priority();
+    mutex_.unlock_low_priority_shared();
     ///////////////////////////////////////////////////////////////////////////
 
+    release(*tx);
+
     // Invoke caller handler outside of critical section.
     handler(ec);
 }
 
+// Admission claims.
+//-----------------------------------------------------------------------------
+
 // private
-void transaction_organizer::signal_completion(code const& ec) {
-    // This must be protected so that it is properly cleared.
-    // Signal completion, which results in original handler invoke with code.
-    resume_.set_value(ec);
+bool transaction_organizer::conflicts(domain::chain::transaction const& tx) const {
+    if (claimed_transactions_.contains(tx.hash())) {
+        return true;
+    }
+
+    return std::any_of(tx.inputs().begin(), tx.inputs().end(), [this](auto const& input) {
+        auto const& prevout = input.previous_output();
+        return claimed_prevouts_.contains(prevout) || claimed_transactions_.contains(prevout.hash());
+    });
+}
+
+// private
+void transaction_organizer::claim(domain::chain::transaction const& tx) {
+    std::unique_lock<std::mutex> lock(claims_mutex_);
+
+    if (conflicts(tx)) {
+        ++waiting_;
+        claims_released_.wait(lock, [&] { return stopped() || ! conflicts(tx); });
+        --waiting_;
+    }
+
+    claimed_transactions_.insert(tx.hash());
+    for (auto const& input : tx.inputs()) {
+        claimed_prevouts_.insert(input.previous_output());
+    }
+}
+
+// private
+void transaction_organizer::release(domain::chain::transaction const& tx) {
+    {
+        std::lock_guard<std::mutex> lock(claims_mutex_);
+        claimed_transactions_.erase(tx.hash());
+        for (auto const& input : tx.inputs()) {
+            claimed_prevouts_.erase(input.previous_output());
+        }
+    }
+
+    claims_released_.notify_all();
 }
 
 // Verify sub-sequence.
@@ -227,6 +289,8 @@ void transaction_organizer::signal_completion(code const& ec) {
 
 // private
 void transaction_organizer::handle_check(code const& ec, transaction_const_ptr tx, result_handler handler) {
+    --checking_;
+
     if (stopped()) {
         handler(error::service_stopped);
         return;
@@ -239,12 +303,16 @@ void transaction_organizer::handle_check(code const& ec, transaction_const_ptr t
 
     auto const accept_handler = std::bind(&transaction_organizer::handle_accept, this, _1, tx, handler);
 
+    ++populating_;
+
     // Checks that are dependent on chain state and prevouts.
     validator_.accept(tx, accept_handler);
 }
 
 // private
 void transaction_organizer::handle_accept(code const& ec, transaction_const_ptr tx, result_handler handler) {
+    --populating_;
+
     if (stopped()) {
         handler(error::service_stopped);
         return;
@@ -267,12 +335,16 @@ void transaction_organizer::handle_accept(code const& ec, transaction_const_ptr
 
     auto const connect_handler = std::bind(&transaction_organizer::handle_connect, this, _1, tx, handler);
 
+    ++verifying_;
+
     // Checks that include script validation.
     validator_.connect(tx, connect_handler);
 }
 
 // private
 void transaction_organizer::handle_connect(code const& ec, transaction_const_ptr tx, result_handler handler) {
+    --verifying_;
+
     if (stopped()) {
         handler(error::service_stopped);
         return;
@@ -289,9 +361,14 @@ void transaction_organizer::handle_connect(code const& ec, transaction_const_ptr
         return;
     }
 
+    ++committing_;
+    commit_mutex_.lock();
+
 #if defined(KTH_WITH_MEMPOOL)
     auto res = mempool_.add(*tx);
     if (res == error::double_spend_mempool || res == error::double_spend_blockchain) {
+        commit_mutex_.unlock();
+        --committing_;
         handler(res);
         return;
     }
@@ -303,12 +380,18 @@ void transaction_organizer::handle_connect(code const& ec, transaction_const_ptr
     //#########################################################################
     fast_chain_.push(tx, dispatch_, pushed_handler);
     //#########################################################################
+#else
+    commit_mutex_.unlock();
+    --committing_;
 #endif
 }
 
 #if ! defined(KTH_DB_READONLY)
 // private
 void transaction_organizer::handle_pushed(code const& ec, transaction_const_ptr tx, result_handler handler) {
+    commit_mutex_.unlock();
+    --committing_;
+
     if (ec) {
         spdlog::critical("[blockchain] Failure writing transaction to store, is now corrupted: {}", ec.message());
         handler(ec);
@@ -363,6 +446,10 @@ void transaction_organizer::fetch_mempool(size_t maximum, inventory_fetch_handle
     transaction_pool_.fetch_mempool(maximum, handler);
 }
 
+transaction_organizer::admission_depth transaction_organizer::depth() const {
+    return {waiting_, checking_, populating_, verifying_, committing_};
+}
+
 void transaction_organizer::fetch_ds_proof(hash_digest const& hash, ds_proof_fetch_handler handler) const {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
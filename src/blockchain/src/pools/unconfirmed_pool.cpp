@@ -0,0 +1,198 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/blockchain/pools/unconfirmed_pool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include <kth/domain.hpp>
+
+namespace kth::blockchain {
+
+unconfirmed_pool::unconfirmed_pool(size_t extra_capacity)
+    : extra_capacity_(extra_capacity)
+{}
+
+size_t unconfirmed_pool::size() const {
+    shared_lock lock(mutex_);
+    return transactions_.size();
+}
+
+size_t unconfirmed_pool::extra_size() const {
+    shared_lock lock(mutex_);
+    return extra_.size();
+}
+
+void unconfirmed_pool::add(transaction_const_ptr tx, uint32_t arrival_time) {
+    auto const hash = tx->hash();
+
+    unique_lock lock(mutex_);
+    auto const inserted = transactions_.try_emplace(hash, entry{tx, arrival_time}).second;
+    if (inserted) {
+        index_addresses(tx, arrival_time);
+    }
+}
+
+void unconfirmed_pool::add_extra(transaction_const_ptr tx) {
+    if (extra_capacity_ == 0) {
+        return;
+    }
+
+    unique_lock lock(mutex_);
+
+    if (extra_.size() < extra_capacity_) {
+        extra_.push_back(std::move(tx));
+        return;
+    }
+
+    extra_[extra_next_] = std::move(tx);
+    extra_next_ = (extra_next_ + 1) % extra_capacity_;
+}
+
+void unconfirmed_pool::remove(domain::chain::block const& block) {
+    unique_lock lock(mutex_);
+
+    if (transactions_.empty()) {
+        return;
+    }
+
+    for (auto const& tx : block.transactions()) {
+        erase(tx.hash());
+    }
+}
+
+void unconfirmed_pool::remove(hash_digest const& hash) {
+    unique_lock lock(mutex_);
+    erase(hash);
+}
+
+void unconfirmed_pool::clear() {
+    unique_lock lock(mutex_);
+    transactions_.clear();
+    addresses_.clear();
+    extra_.clear();
+    extra_next_ = 0;
+}
+
+bool unconfirmed_pool::contains(hash_digest const& hash) const {
+    shared_lock lock(mutex_);
+    return transactions_.contains(hash);
+}
+
+transaction_const_ptr unconfirmed_pool::find(hash_digest const& hash) const {
+    shared_lock lock(mutex_);
+    auto const it = transactions_.find(hash);
+    return it == transactions_.end() ? nullptr : it->second.tx;
+}
+
+unconfirmed_pool::snapshot unconfirmed_pool::take_snapshot() const {
+    snapshot result;
+
+    shared_lock lock(mutex_);
+    auto const total = transactions_.size() + extra_.size();
+    result.hashes.reserve(total);
+    result.transactions.reserve(total);
+
+    for (auto const& [hash, item] : transactions_) {
+        result.hashes.push_back(hash);
+        result.transactions.push_back(item.tx);
+    }
+    result.pooled = transactions_.size();
+
+    for (auto const& tx : extra_) {
+        result.hashes.push_back(tx->hash());
+        result.transactions.push_back(tx);
+    }
+
+    return result;
+}
+
+std::vector<unconfirmed_pool::address_entry> unconfirmed_pool::get_address_entries(domain::wallet::payment_address const& address) const {
+    shared_lock lock(mutex_);
+    auto const it = addresses_.find(address);
+    if (it == addresses_.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+// private
+// TODO(kth): payment_addrress::extract should use the prev_output script instead of the input script
+domain::wallet::payment_address::list unconfirmed_pool::extract(domain::chain::script const& script) {
+    using domain::wallet::payment_address;
+    return payment_address::extract(script, payment_address::mainnet_p2kh, payment_address::mainnet_p2sh);
+}
+
+// private
+// precondition: mutex_ is exclusively locked.
+void unconfirmed_pool::index_addresses(transaction_const_ptr const& tx, uint32_t arrival_time) {
+    uint32_t index = 0;
+    for (auto const& output : tx->outputs()) {
+        for (auto const& address : extract(output.script())) {
+            if (address) {
+                addresses_[address].push_back(address_entry{tx, index, false, arrival_time});
+            }
+        }
+        ++index;
+    }
+
+    index = 0;
+    for (auto const& input : tx->inputs()) {
+        for (auto const& address : extract(input.script())) {
+            if (address) {
+                addresses_[address].push_back(address_entry{tx, index, true, arrival_time});
+            }
+        }
+        ++index;
+    }
+}
+
+// private
+// precondition: mutex_ is exclusively locked.
+void unconfirmed_pool::unindex_addresses(domain::chain::transaction const& tx) {
+    auto const hash = tx.hash();
+
+    auto const unindex = [&](domain::chain::script const& script) {
+        for (auto const& address : extract(script)) {
+            auto const it = addresses_.find(address);
+            if (it == addresses_.end()) {
+                continue;
+            }
+
+            std::erase_if(it->second, [&hash](address_entry const& x) {
+                return x.tx->hash() == hash;
+            });
+
+            if (it->second.empty()) {
+                addresses_.erase(it);
+            }
+        }
+    };
+
+    for (auto const& output : tx.outputs()) {
+        unindex(output.script());
+    }
+
+    for (auto const& input : tx.inputs()) {
+        unindex(input.script());
+    }
+}
+
+// private
+// precondition: mutex_ is exclusively locked.
+void unconfirmed_pool::erase(hash_digest const& hash) {
+    auto const it = transactions_.find(hash);
+    if (it == transactions_.end()) {
+        return;
+    }
+
+    unindex_addresses(*it->second.tx);
+    transactions_.erase(it);
+}
+
+} // namespace kth::blockchain
@@ -59,7 +59,7 @@ void populate_base::populate_prevout(size_t branch_height, output_point const& o
 
     prevout.spent = false;
     prevout.confirmed = false;
-    prevout.cache = domain::chain::output{};
+    prevout.cache.reset();
     prevout.from_mempool = false;
 
     // If the input is a coinbase there is no prevout to populate.
@@ -75,13 +75,13 @@ void populate_base::populate_prevout(size_t branch_height, output_point const& o
     // BUGBUG: Spends are not marked as spent by unconfirmed transactions.
     // So tx pool transactions currently have no double spend limitation.
     // The output is spent only if by a spend at or below the branch height.
-    auto const spend_height = prevout.cache.validation.spender_height;
+    auto const spend_height = prevout.cache.get().validation.spender_height;
 
     // The previous output has already been spent (double spend).
     if ((spend_height <= branch_height) && (spend_height != output::validation::not_spent)) {
         prevout.spent = true;
         prevout.confirmed = true;
-        prevout.cache = domain::chain::output{};
+        prevout.cache.reset();
     }
 }
 
@@ -66,18 +66,41 @@ void populate_block::populate(branch::const_ptr branch, result_handler&& handler
     auto branch_utxo = create_branch_utxo_set(branch);
 
 #if defined(KTH_WITH_MEMPOOL)
-    auto validated_txs = mempool_.get_validated_txs_high();
+    populate_from_mempool(*block);
 #endif
 
     for (size_t bucket = 0; bucket < buckets; ++bucket) {
-#if defined(KTH_WITH_MEMPOOL)
-        dispatch_.concurrent(&populate_block::populate_transactions, this, branch, bucket, buckets, branch_utxo, validated_txs, join_handler);
-#else
         dispatch_.concurrent(&populate_block::populate_transactions, this, branch, bucket, buckets, branch_utxo, join_handler);
-#endif
     }
 }
 
+#if defined(KTH_WITH_MEMPOOL)
+// Pooled transactions are already validated, take their prevouts from the
+// mempool in a single pass over its (uncopied) index.
+void populate_block::populate_from_mempool(domain::chain::block const& block) const {
+    mempool_.with_validated_txs_high([&block](auto const& validated_txs) {
+        size_t pooled = 0;
+        auto const& txs = block.transactions();
+
+        // Must skip coinbase here as it is already accounted for.
+        for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx) {
+            auto const it = validated_txs.find(tx->hash());
+            if (it == validated_txs.end()) {
+                continue;
+            }
+
+            ++pooled;
+            tx->validation.validated = true;
+            auto const& tx_cached = it->second.second;
+            for (size_t i = 0; i < tx_cached.inputs().size(); ++i) {
+                tx->inputs()[i].previous_output().validation = tx_cached.inputs()[i].previous_output().validation;
+            }
+        }
+        return pooled;
+    });
+}
+#endif
+
 // Initialize the coinbase input for subsequent validation.
 void populate_block::populate_coinbase(branch::const_ptr branch, block_const_ptr block) const {
     auto const& txs = block->transactions();
@@ -98,7 +121,7 @@ void populate_block::populate_coinbase(branch::const_ptr branch, block_const_ptr
     prevout.confirmed = true;
 
     // A coinbase does not spend a previous output so these are unused/default.
-    prevout.cache = domain::chain::output{};
+    prevout.cache.reset();
     prevout.coinbase = false;
     prevout.height = 0;
     prevout.median_time_past = 0;
@@ -152,11 +175,7 @@ void populate_block::populate_transaction_inputs(branch::const_ptr branch, domai
     }
 }
 
-#if defined(KTH_WITH_MEMPOOL)
-void populate_block::populate_transactions(branch::const_ptr branch, size_t bucket, size_t buckets, local_utxo_set_t const& branch_utxo, mining::mempool::hash_index_t const& validated_txs, result_handler handler) const {
-#else
 void populate_block::populate_transactions(branch::const_ptr branch, size_t bucket, size_t buckets, local_utxo_set_t const& branch_utxo, result_handler handler) const {
-#endif
     // TODO(fernando): check how to replace it with UTXO
     KTH_ASSERT(bucket < buckets);
     auto const block = branch->top();
@@ -206,21 +225,13 @@ void populate_block::populate_transactions(branch::const_ptr branch, size_t buck
     for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx) {
 
 #if defined(KTH_WITH_MEMPOOL)
-        auto it = validated_txs.find(tx->hash());
-        if (it == validated_txs.end()) {
-            auto const& inputs = tx->inputs();
-            populate_transaction_inputs(branch, inputs, bucket, buckets, input_position, branch_utxo, first_height, chain_top, reorg_subset);
-        } else {
-            tx->validation.validated = true;
-            auto const& tx_cached = it->second.second;
-            for (size_t i = 0; i < tx_cached.inputs().size(); ++i) {
-                tx->inputs()[i].previous_output().validation = tx_cached.inputs()[i].previous_output().validation;
-            }
+        // Populated from the mempool.
+        if (tx->validation.validated) {
+            continue;
         }
-#else
+#endif
         auto const& inputs = tx->inputs();
         populate_transaction_inputs(branch, inputs, bucket, buckets, input_position, branch_utxo, first_height, chain_top, reorg_subset);
-#endif // defined(KTH_WITH_MEMPOOL)
     }
 
     handler(error::success);
@@ -237,7 +248,7 @@ void populate_block::populate_from_reorg_subset(output_point const& outpoint, ut
         auto const& entry = it->second;
         val.height = entry.height();
         val.median_time_past = entry.median_time_past();
-        val.cache = entry.output();
+        val.cache = entry.shared_output();
         val.coinbase = entry.coinbase();
     }
 
@@ -0,0 +1,102 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/blockchain/validate/script_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace kth::blockchain {
+
+script_cache::script_cache(size_t capacity)
+    : capacity_(capacity)
+    , shard_capacity_(capacity == 0 ? 0 : std::max(size_t(1), capacity / shard_count))
+{}
+
+bool script_cache::disabled() const {
+    return capacity_ == 0;
+}
+
+size_t script_cache::capacity() const {
+    return capacity_;
+}
+
+size_t script_cache::size() const {
+    size_t total = 0;
+    for (auto& target : shards_) {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        total += target.map.size();
+    }
+    return total;
+}
+
+// The hash is uniformly distributed, its first byte is enough to spread the
+// transactions across the shards.
+script_cache::shard& script_cache::shard_for(hash_digest const& hash) const {
+    return shards_[hash[0] % shard_count];
+}
+
+std::optional<size_t> script_cache::find(hash_digest const& hash, uint32_t forks) const {
+    if (disabled()) {
+        return std::nullopt;
+    }
+
+    auto& target = shard_for(hash);
+    std::lock_guard<std::mutex> lock(target.mutex);
+
+    auto const it = target.map.find(hash);
+    if (it == target.map.end() || it->second.forks != forks) {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    ++hits_;
+    return it->second.sigchecks;
+}
+
+void script_cache::add(hash_digest const& hash, uint32_t forks, size_t sigchecks) {
+    if (disabled()) {
+        return;
+    }
+
+    auto& target = shard_for(hash);
+    std::lock_guard<std::mutex> lock(target.mutex);
+
+    auto const it = target.map.find(hash);
+    if (it != target.map.end()) {
+        it->second = {forks, sigchecks};
+        return;
+    }
+
+    if (target.map.size() >= shard_capacity_) {
+        target.map.erase(target.order.front());
+        target.order.pop_front();
+    }
+
+    target.order.push_back(hash);
+    target.map.emplace(hash, shard::item{forks, sigchecks});
+}
+
+void script_cache::clear() {
+    for (auto& target : shards_) {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.map.clear();
+        target.order.clear();
+    }
+}
+
+size_t script_cache::hits() const {
+    return hits_;
+}
+
+size_t script_cache::misses() const {
+    return misses_;
+}
+
+float script_cache::hit_rate() const {
+    size_t const queries = hits_ + misses_;
+    return queries == 0 ? 0.0f : (hits_ * 1.0f / queries);
+}
+
+} // namespace kth::blockchain
@@ -5,10 +5,13 @@
 #include <kth/blockchain/validate/validate_block.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <kth/blockchain/interface/fast_chain.hpp>
 #include <kth/blockchain/pools/branch.hpp>
@@ -36,14 +39,15 @@ using namespace std::placeholders;
 // will never be invoked, resulting in a threadpool.join indefinite hang.
 
 #if defined(KTH_WITH_MEMPOOL)
-validate_block::validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, domain::config::network network, bool relay_transactions, mining::mempool const& mp)
+validate_block::validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions, mining::mempool const& mp)
 #else
-validate_block::validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, domain::config::network network, bool relay_transactions)
+validate_block::validate_block(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache const& scripts, domain::config::network network, bool relay_transactions)
 #endif
     : stopped_(true)
     , fast_chain_(chain)
     , network_(network)
     , priority_dispatch_(dispatch)
+    , script_cache_(scripts)
 #if defined(KTH_WITH_MEMPOOL)
     , block_populator_(dispatch, chain, relay_transactions, mp)
 #else
@@ -65,54 +69,217 @@ void validate_block::stop() {
 // Check.
 //-----------------------------------------------------------------------------
 // These checks are context free.
+// Transactions are hashed and checked in contiguous ranges of similar size
+// (the work is linear in bytes), then the merkle tree is built in subtrees
+// while the rest of the block is checked.
+
+namespace {
+
+// Below these sizes splitting the work costs more than it saves.
+constexpr size_t min_bucket_bytes = 64 * 1024;
+constexpr size_t min_merkle_chunk = 1024;
+
+size_t ceiling_log2(size_t value) {
+    size_t levels = 0;
+    for (size_t power = 1; power < value; power <<= 1) {
+        ++levels;
+    }
+    return levels;
+}
+
+} // namespace
+
+struct validate_block::check_state {
+    explicit
+    check_state(size_t count)
+        : hashes(count)
+    {}
+
+    // The transaction ranges, bucket i is [bounds[i], bounds[i + 1]).
+    std::vector<size_t> bounds;
+    size_t bytes = 0;
+
+    // The first failure of each bucket (count if none).
+    std::vector<std::pair<size_t, code>> failures;
+
+    hash_list hashes;
+
+    // The roots of the merkle subtrees, chunk_size leaves each.
+    size_t chunk_size = 0;
+    hash_list roots;
+
+    code structure;
+    asio::time_point start_merkle;
+};
 
 void validate_block::check(block_const_ptr block, result_handler handler) const {
-    // The block hasn't been checked yet.
+    // Nothing to split, reports the empty block.
     if (block->transactions().empty()) {
-        handler(error::success);
+        handler(block->check());
         return;
     }
 
-    result_handler complete_handler = std::bind(&validate_block::handle_checked, this, _1, block, handler);
+    // block::check() is not used, it sets the time internally.
+    block->validation.start_check = asio::steady_clock::now();
 
-    // TODO: make configurable for each parallel segment.
-    // This one is more efficient with one thread than parallel.
-    auto const threads = std::min(size_t(1), priority_dispatch_.size());
-    auto const count = block->transactions().size();
-    auto const buckets = std::min(threads, count);
-    KTH_ASSERT(buckets != 0);
+    auto const& txs = block->transactions();
+    auto const count = txs.size();
+    auto const state = std::make_shared<check_state>(count);
 
-    auto const join_handler = synchronize(std::move(complete_handler), buckets, NAME "_check");
+    std::vector<size_t> sizes(count);
+    for (size_t tx = 0; tx < count; ++tx) {
+        sizes[tx] = txs[tx].serialized_size(true);
+        state->bytes += sizes[tx];
+    }
 
-    for (size_t bucket = 0; bucket < buckets; ++bucket) {
-        priority_dispatch_.concurrent(&validate_block::check_block, this, block, bucket, buckets, join_handler);
+    auto const threads = std::max(size_t(1), priority_dispatch_.size());
+    auto const buckets = std::clamp(state->bytes / min_bucket_bytes, size_t(1), std::min(threads, count));
+    auto const target = (state->bytes + buckets - 1) / buckets;
+
+    state->bounds.push_back(0);
+    size_t accumulated = 0;
+    for (size_t tx = 0; tx < count && state->bounds.size() < buckets; ++tx) {
+        accumulated += sizes[tx];
+        if (accumulated >= target * state->bounds.size()) {
+            state->bounds.push_back(tx + 1);
+        }
+    }
+
+    if (state->bounds.back() != count) {
+        state->bounds.push_back(count);
+    }
+
+    auto const ranges = state->bounds.size() - 1;
+    state->failures.assign(ranges, {count, error::success});
+
+    result_handler complete_handler = std::bind(&validate_block::handle_transactions_checked, this, _1, block, state, handler);
+    auto const join_handler = synchronize(std::move(complete_handler), ranges, NAME "_check");
+
+    for (size_t bucket = 0; bucket < ranges; ++bucket) {
+        priority_dispatch_.concurrent(&validate_block::check_transactions, this, block, state, bucket, join_handler);
     }
 }
 
-void validate_block::check_block(block_const_ptr block, size_t bucket, size_t buckets, result_handler handler) const {
+void validate_block::check_transactions(block_const_ptr block, check_state_ptr state, size_t bucket, result_handler handler) const {
     if (stopped()) {
         handler(error::service_stopped);
         return;
     }
 
+    constexpr auto max_block_size = static_absolute_max_block_size();
     auto const& txs = block->transactions();
+    auto& failure = state->failures[bucket];
+
+    for (auto tx = state->bounds[bucket]; tx < state->bounds[bucket + 1]; ++tx) {
+        // Generate each tx hash (stored in tx cache).
+        state->hashes[tx] = txs[tx].hash();
+
+        if (failure.second) {
+            continue;
+        }
 
-    // Generate each tx hash (stored in tx cache).
-    for (auto tx = bucket; tx < txs.size(); tx = ceiling_add(tx, buckets)) {
-        txs[tx].hash();
+        auto const ec = txs[tx].check(max_block_size, false);
+        if (ec) {
+            failure = {tx, ec};
+        }
     }
 
     handler(error::success);
 }
 
-void validate_block::handle_checked(code const& ec, block_const_ptr block, result_handler handler) const {
+void validate_block::handle_transactions_checked(code const& ec, block_const_ptr block, check_state_ptr state, result_handler handler) const {
     if (ec) {
         handler(ec);
         return;
     }
 
-    // Run context free checks, sets time internally.
-    handler(block->check());
+    state->start_merkle = asio::steady_clock::now();
+
+    // Full subtrees of a power of two leaves, about one per thread.
+    auto const count = state->hashes.size();
+    auto const threads = std::max(size_t(1), priority_dispatch_.size());
+    auto const per_thread = (count + threads - 1) / threads;
+    state->chunk_size = size_t(1) << ceiling_log2(std::max(per_thread, min_merkle_chunk));
+
+    auto const chunks = (count + state->chunk_size - 1) / state->chunk_size;
+    state->roots.resize(chunks);
+
+    result_handler complete_handler = std::bind(&validate_block::handle_checked, this, _1, block, state, handler);
+    auto const join_handler = synchronize(std::move(complete_handler), chunks + 1, NAME "_merkle");
+
+    priority_dispatch_.concurrent(&validate_block::check_structure, this, block, state, join_handler);
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        priority_dispatch_.concurrent(&validate_block::check_merkle, this, state, chunk, join_handler);
+    }
+}
+
+void validate_block::check_merkle(check_state_ptr state, size_t chunk, result_handler handler) const {
+    if (stopped()) {
+        handler(error::service_stopped);
+        return;
+    }
+
+    auto const& hashes = state->hashes;
+    auto const first = chunk * state->chunk_size;
+    auto const last = std::min(first + state->chunk_size, hashes.size());
+    auto root = block::generate_merkle_root(hash_list(hashes.begin() + first, hashes.begin() + last));
+
+    // A partial last subtree is completed by duplicating its (odd) node at
+    // each remaining level, as the whole tree would, unless it is the root.
+    if (state->roots.size() > 1) {
+        auto const levels = ceiling_log2(state->chunk_size);
+        for (auto level = ceiling_log2(last - first); level < levels; ++level) {
+            root = bitcoin_hash(build_chunk({root, root}));
+        }
+    }
+
+    state->roots[chunk] = root;
+    handler(error::success);
+}
+
+void validate_block::check_structure(block_const_ptr block, check_state_ptr state, result_handler handler) const {
+    if (stopped()) {
+        handler(error::service_stopped);
+        return;
+    }
+
+    // Context free non-tx checks, the merkle root is checked separately.
+    state->structure = block->check(false);
+    handler(error::success);
+}
+
+void validate_block::handle_checked(code const& ec, block_const_ptr block, check_state_ptr state, result_handler handler) const {
+    if (ec) {
+        handler(ec);
+        return;
+    }
+
+    auto const end = asio::steady_clock::now();
+    auto const& times = block->validation;
+    spdlog::debug("[blockchain] Checked block {} txs ({} bytes) in {} buckets: transactions {} us, merkle {} us.",
+        state->hashes.size(), state->bytes, state->failures.size(),
+        std::chrono::duration_cast<std::chrono::microseconds>(state->start_merkle - times.start_check).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(end - state->start_merkle).count());
+
+    // Errors are reported in the order of block::check().
+    if (state->structure) {
+        handler(state->structure);
+        return;
+    }
+
+    auto const root = state->roots.size() == 1 ? state->roots.front() : block::generate_merkle_root(state->roots);
+    if (root != block->header().merkle()) {
+        handler(error::merkle_mismatch);
+        return;
+    }
+
+    auto const failure = std::min_element(state->failures.begin(), state->failures.end(),
+        [](auto const& x, auto const& y) {
+            return x.first < y.first;
+        });
+
+    handler(failure->second);
 }
 
 // Accept sequence.
@@ -240,6 +407,37 @@ void validate_block::handle_accepted(code const& ec, block_const_ptr block, atom
 // Connect sequence.
 //-----------------------------------------------------------------------------
 // These checks require chain state, block state and perform script validation.
+// The inputs to verify are split in contiguous ranges of similar estimated
+// cost, the sigchecks are totaled for the whole block and the first failure
+// cancels the remaining ranges.
+
+namespace {
+
+// The script bytes approximate the verification cost, plus a fixed cost per
+// input (serialization, sighash).
+constexpr size_t input_base_cost = 64;
+
+size_t input_cost(domain::chain::input const& input) {
+    auto const& prevout = input.previous_output().validation.cache.get();
+    return input_base_cost + input.script().serialized_size(false) + prevout.script().serialized_size(false);
+}
+
+} // namespace
+
+struct validate_block::connect_state {
+    // The (tx, input) positions to verify, in block order.
+    std::vector<std::pair<uint32_t, uint32_t>> inputs;
+
+    // The input ranges, bucket i is [bounds[i], bounds[i + 1]).
+    std::vector<size_t> bounds;
+
+    // Block wide, cached transactions included.
+    atomic_counter sigchecks {0};
+    size_t max_sigchecks = 0;
+
+    // Set by the first failing range.
+    std::atomic<bool> cancelled {false};
+};
 
 void validate_block::connect(branch::const_ptr branch, result_handler handler) const {
     auto const block = branch->top();
@@ -265,89 +463,142 @@ void validate_block::connect(branch::const_ptr branch, result_handler handler) c
     hits_ = 0;
     queries_ = 0;
 
-    result_handler complete_handler = std::bind(&validate_block::handle_connected, this, _1, block, handler);
-
-    auto const threads = priority_dispatch_.size();
-    auto const buckets = std::min(threads, non_coinbase_inputs);
-    KTH_ASSERT(buckets != 0);
-
-    auto const join_handler = synchronize(std::move(complete_handler), buckets, NAME "_validate");
-
-    for (size_t bucket = 0; bucket < buckets; ++bucket) {
-        priority_dispatch_.concurrent(&validate_block::connect_inputs, this, block, bucket, buckets, join_handler);
-    }
-}
-
-void validate_block::connect_inputs(block_const_ptr block, size_t bucket, size_t buckets, result_handler handler) const {
-    KTH_ASSERT(bucket < buckets);
-    code ec(error::success);
     auto const forks = block->validation.state->enabled_forks();
     auto const& txs = block->transactions();
-    size_t position = 0;
+    auto const state = std::make_shared<connect_state>();
+    state->inputs.reserve(non_coinbase_inputs);
 
 #if defined(KTH_CURRENCY_BCH)
-    size_t block_sigchecks = 0;
+    state->max_sigchecks = block->validation.state->dynamic_max_block_sigchecks();
 #endif
 
+    std::vector<size_t> costs;
+    costs.reserve(non_coinbase_inputs);
+    size_t total_cost = 0;
+
     //TODO(fernando): count the coinbase sigchecks
 
     // Must skip coinbase here as it is already accounted for.
-    for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx) {
+    for (size_t tx = 1; tx < txs.size(); ++tx) {
+        auto const& transaction = txs[tx];
         ++queries_;
 
-        // The tx is pooled with current fork state so outputs are validated.
-        if (tx->validation.current) {
+        // The scripts were verified on pool acceptance with the same forks,
+        // pooled (current or validated) or not (i.e. evicted). The sigchecks
+        // recorded then count towards the block limit.
+        auto const cached = script_cache_.find(transaction.hash(), forks);
+        if (cached) {
             ++hits_;
+            state->sigchecks += *cached;
             continue;
         }
 
-        // The tx was validated before its insertion in the mempool
-        // TODO(fernando): what happend with Blockchain forks?
-        if (tx->validation.validated) {
-            ++hits_;
-            continue;
+        // A pooled tx without recorded sigchecks (i.e. evicted from the
+        // script cache) is verified again, otherwise it escapes the limit.
+
+        auto const& inputs = transaction.inputs();
+        for (size_t index = 0; index < inputs.size(); ++index) {
+            state->inputs.emplace_back(uint32_t(tx), uint32_t(index));
+            costs.push_back(input_cost(inputs[index]));
+            total_cost += costs.back();
         }
+    }
 
-        size_t input_index;
-        auto const& inputs = tx->inputs();
+#if defined(KTH_CURRENCY_BCH)
+    if (state->sigchecks > state->max_sigchecks) {
+        handler(error::block_sigchecks_limit);
+        return;
+    }
+#endif
 
-        for (input_index = 0; input_index < inputs.size(); ++input_index, ++position) {
-            if (position % buckets != bucket) {
-                continue;
-            }
+    result_handler complete_handler = std::bind(&validate_block::handle_connected, this, _1, block, handler);
 
-            if (stopped()) {
-                handler(error::service_stopped);
-                return;
-            }
+    // Everything was verified before.
+    if (state->inputs.empty()) {
+        complete_handler(error::success);
+        return;
+    }
+
+    auto const threads = std::max(size_t(1), priority_dispatch_.size());
+    auto const buckets = std::min(threads, state->inputs.size());
+    auto const target = (total_cost + buckets - 1) / buckets;
+
+    state->bounds.push_back(0);
+    size_t accumulated = 0;
+    for (size_t item = 0; item < costs.size() && state->bounds.size() < buckets; ++item) {
+        accumulated += costs[item];
+        if (accumulated >= target * state->bounds.size()) {
+            state->bounds.push_back(item + 1);
+        }
+    }
+
+    if (state->bounds.back() != state->inputs.size()) {
+        state->bounds.push_back(state->inputs.size());
+    }
+
+    auto const ranges = state->bounds.size() - 1;
+    auto const join_handler = synchronize(std::move(complete_handler), ranges, NAME "_validate");
 
-            auto const& prevout = inputs[input_index].previous_output();
+    for (size_t bucket = 0; bucket < ranges; ++bucket) {
+        priority_dispatch_.concurrent(&validate_block::connect_inputs, this, block, state, bucket, join_handler);
+    }
+}
+
+void validate_block::connect_inputs(block_const_ptr block, connect_state_ptr state, size_t bucket, result_handler handler) const {
+    KTH_ASSERT(bucket + 1 < state->bounds.size());
+    code ec(error::success);
+    auto const forks = block->validation.state->enabled_forks();
+    auto const& txs = block->transactions();
+    auto const last = state->bounds[bucket + 1];
+    uint32_t input_index = 0;
+    std::vector<uint32_t> input_indexes;
+
+    for (auto item = state->bounds[bucket]; item < last && ! ec;) {
+        // Another range failed, the result is already reported.
+        if (state->cancelled) {
+            handler(error::success);
+            return;
+        }
+
+        if (stopped()) {
+            handler(error::service_stopped);
+            return;
+        }
+
+        // The inputs of the same tx are verified in one batch sharing the
+        // transaction serialization and sighash precomputation.
+        auto const tx = state->inputs[item].first;
+        auto const& transaction = txs[tx];
+        input_indexes.clear();
 
-            if ( ! prevout.validation.cache.is_valid()) {
+        for (; item < last && state->inputs[item].first == tx; ++item) {
+            auto const index = state->inputs[item].second;
+            if ( ! transaction.inputs()[index].previous_output().validation.cache.is_valid()) {
+                input_index = index;
                 ec = error::missing_previous_output;
                 break;
             }
 
+            input_indexes.push_back(index);
+        }
+
+        if ( ! ec) {
             size_t sigchecks;
-            std::tie(ec, sigchecks) = validate_input::verify_script(*tx, input_index, forks);
-            if (ec != error::success) {
-                break;
-            }
+            std::tie(ec, sigchecks) = validate_input::verify_scripts(transaction, input_indexes, forks, input_index);
 
 #if defined(KTH_CURRENCY_BCH)
-            block_sigchecks += sigchecks;
-            // if (block_sigchecks > get_max_block_sigchecks(network_)) {
-            if (block_sigchecks > block->validation.state->dynamic_max_block_sigchecks()) {
+            auto const block_sigchecks = state->sigchecks += sigchecks;
+            if ( ! ec && block_sigchecks > state->max_sigchecks) {
+                input_index = input_indexes.back();
                 ec = error::block_sigchecks_limit;
-                break;
             }
 #endif
         }
 
         if (ec) {
+            state->cancelled = true;
             auto const height = block->validation.state->height();
-            dump(ec, *tx, input_index, forks, height);
-            break;
+            dump(ec, transaction, input_index, forks, height);
         }
     }
 
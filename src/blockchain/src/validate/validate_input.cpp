@@ -5,6 +5,7 @@
 #include <kth/blockchain/validate/validate_input.hpp>
 
 #include <cstdint>
+#include <vector>
 
 #include <kth/domain.hpp>
 
@@ -211,7 +212,7 @@ coins_t create_context_data(transaction const& tx, bool should_create_context) {
     coins.reserve(tx.inputs().size());
 
     for (auto const& input : tx.inputs()) {
-        auto const& prevout = input.previous_output().validation.cache;
+        auto const& prevout = input.previous_output().validation.cache.get();
         coins.emplace_back(prevout.to_data(true));
     }
     return coins;
@@ -249,6 +250,55 @@ std::pair<code, size_t> validate_input::verify_script(transaction const& tx, uin
     return {convert_result(res), sig_checks};
 }
 
+std::pair<code, size_t> validate_input::verify_scripts(transaction const& tx, std::vector<uint32_t> const& input_indexes, uint32_t forks, uint32_t& failed_index, bool store_signatures) {
+    constexpr bool prefix = false;
+
+    failed_index = 0;
+    if (input_indexes.empty()) {
+        return {error::success, 0};
+    }
+
+    auto const tx_data = tx.to_data(true);
+    bool const should_create_context = script::is_enabled(forks, domain::machine::rule_fork::bch_gauss);
+    auto const coins = create_context_data(tx, should_create_context);
+
+    // The script buffers must outlive the consensus call.
+    std::vector<data_chunk> locking_scripts;
+    std::vector<data_chunk> unlocking_scripts;
+    std::vector<consensus::verify_input> inputs;
+    locking_scripts.reserve(input_indexes.size());
+    unlocking_scripts.reserve(input_indexes.size());
+    inputs.reserve(input_indexes.size());
+
+    for (auto const input_index : input_indexes) {
+        KTH_ASSERT(input_index < tx.inputs().size());
+        auto const& input = tx.inputs()[input_index];
+        auto const& locking = locking_scripts.emplace_back(input.previous_output().validation.cache.script().to_data(false));
+        auto const& unlocking = unlocking_scripts.emplace_back(input.script().to_data(prefix));
+        inputs.push_back({input_index, locking.data(), locking.size(), unlocking.data(), unlocking.size()});
+    }
+
+    size_t sig_checks;
+    size_t failed_position;
+
+    auto res = consensus::verify_scripts(
+        tx_data.data(),
+        tx_data.size(),
+        coins,
+        inputs,
+        convert_flags(forks),
+        sig_checks,
+        failed_position,
+        store_signatures
+    );
+
+    if (failed_position < input_indexes.size()) {
+        failed_index = input_indexes[failed_position];
+    }
+
+    return {convert_result(res), sig_checks};
+}
+
 #else //WITH_CONSENSUS
 
 // #error Not supported, build using -o consensus=True
@@ -257,6 +307,18 @@ std::pair<code, size_t> validate_input::verify_script(transaction const& tx, uin
     return {script::verify(tx, input_index, forks), 0};
 }
 
+std::pair<code, size_t> validate_input::verify_scripts(transaction const& tx, std::vector<uint32_t> const& input_indexes, uint32_t forks, uint32_t& failed_index, bool /*store_signatures*/) {
+    failed_index = 0;
+    for (auto const input_index : input_indexes) {
+        auto const ec = script::verify(tx, input_index, forks);
+        if (ec) {
+            failed_index = input_index;
+            return {ec, 0};
+        }
+    }
+    return {error::success, 0};
+}
+
 #endif //WITH_CONSENSUS
 
 } // namespace kth::blockchain
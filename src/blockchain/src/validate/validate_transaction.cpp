@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include <kth/blockchain/interface/fast_chain.hpp>
 #include <kth/blockchain/pools/branch.hpp>
@@ -34,13 +35,14 @@ using namespace std::placeholders;
 
 
 #if defined(KTH_WITH_MEMPOOL)
-validate_transaction::validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings, mining::mempool const& mp)
+validate_transaction::validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache& scripts, mining::mempool const& mp)
 #else
-validate_transaction::validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings)
+validate_transaction::validate_transaction(dispatcher& dispatch, fast_chain const& chain, settings const& settings, script_cache& scripts)
 #endif
   : stopped_(true),
     retarget_(settings.retarget),
     dispatch_(dispatch),
+    script_cache_(scripts),
 
 #if defined(KTH_WITH_MEMPOOL)
     transaction_populator_(dispatch, chain, mp),
@@ -120,18 +122,28 @@ void validate_transaction::connect(transaction_const_ptr tx, result_handler hand
         return;
     }
 
+    // The scripts were verified before with the same forks (e.g. the tx was
+    // evicted and seen again).
+    if (script_cache_.find(tx->hash(), tx->validation.state->enabled_forks())) {
+        handler(error::success);
+        return;
+    }
+
+    auto const sigchecks = std::make_shared<atomic_counter>(0);
+    result_handler complete_handler = std::bind(&validate_transaction::handle_connected, this, _1, tx, sigchecks, handler);
+
     auto const buckets = std::min(dispatch_.size(), total_inputs);
-    auto const join_handler = synchronize(handler, buckets, NAME "_validate");
+    auto const join_handler = synchronize(std::move(complete_handler), buckets, NAME "_validate");
     KTH_ASSERT(buckets != 0);
 
     // If the priority threadpool is shut down when this is called the handler
     // will never be invoked, resulting in a threadpool.join indefinite hang.
     for (size_t bucket = 0; bucket < buckets; ++bucket) {
-        dispatch_.concurrent(&validate_transaction::connect_inputs, this, tx, bucket, buckets, join_handler);
+        dispatch_.concurrent(&validate_transaction::connect_inputs, this, tx, bucket, buckets, sigchecks, join_handler);
     }
 }
 
-void validate_transaction::connect_inputs(transaction_const_ptr tx, size_t bucket, size_t buckets, result_handler handler) const {
+void validate_transaction::connect_inputs(transaction_const_ptr tx, size_t bucket, size_t buckets, atomic_counter_ptr sigchecks, result_handler handler) const {
     KTH_ASSERT(bucket < buckets);
 
 #if defined(KTH_CURRENCY_BCH)
@@ -140,13 +152,9 @@ void validate_transaction::connect_inputs(transaction_const_ptr tx, size_t bucke
 
     auto const forks = tx->validation.state->enabled_forks();
     auto const& inputs = tx->inputs();
+    std::vector<uint32_t> input_indexes;
 
     for (auto input_index = bucket; input_index < inputs.size(); input_index = ceiling_add(input_index, buckets)) {
-        if (stopped()) {
-            handler(error::service_stopped);
-            return;
-        }
-
         auto const& prevout = inputs[input_index].previous_output();
 
         if ( ! prevout.validation.cache.is_valid()) {
@@ -154,21 +162,42 @@ void validate_transaction::connect_inputs(transaction_const_ptr tx, size_t bucke
             return;
         }
 
-        auto res = validate_input::verify_script(*tx, input_index, forks);
-        if (res.first != error::success) {
-            handler(res.first);
-            return;
-        }
+        input_indexes.push_back(input_index);
+    }
+
+    if (stopped()) {
+        handler(error::service_stopped);
+        return;
+    }
+
+    // The bucket inputs share the transaction serialization and sighash precomputation.
+    // The signatures are cached for the validation of the block that confirms the tx.
+    uint32_t failed_index;
+    auto res = validate_input::verify_scripts(*tx, input_indexes, forks, failed_index, true);
+    if (res.first != error::success) {
+        handler(res.first);
+        return;
+    }
+
+    *sigchecks += res.second;
 
 #if defined(KTH_CURRENCY_BCH)
-        tx_sigchecks += res.second;
-        if (tx_sigchecks > max_tx_sigchecks) {
-            handler(error::transaction_sigchecks_limit);
-            return;
-        }
-#endif
+    tx_sigchecks += res.second;
+    if (tx_sigchecks > max_tx_sigchecks) {
+        handler(error::transaction_sigchecks_limit);
+        return;
     }
+#endif
     handler(error::success);
 }
 
+void validate_transaction::handle_connected(code const& ec, transaction_const_ptr tx, atomic_counter_ptr sigchecks, result_handler handler) const {
+    // All the inputs were verified, the block validation can skip them.
+    if ( ! ec) {
+        script_cache_.add(tx->hash(), tx->validation.state->enabled_forks(), *sigchecks);
+    }
+
+    handler(ec);
+}
+
 } // namespace kth::blockchain
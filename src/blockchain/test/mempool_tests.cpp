@@ -84,9 +84,9 @@ kth::domain::chain::block get_block_from_template(mempool const& mp) {
     auto gbt = mp.get_block_template();
     transaction::list tx_list;
     for (auto const& elem : gbt.first) {
-        auto hash_index = mp.get_validated_txs_high();
-        auto it = hash_index.find(elem.txid());
-        tx_list.push_back((*it).second.second);
+        tx_list.push_back(mp.with_validated_txs_high([&elem](auto const& hash_index) {
+            return hash_index.find(elem.txid())->second.second;
+        }));
     }
     return block({}, tx_list);
 }
@@ -3732,4 +3732,99 @@ TEST_CASE("[mempool] testnet case 4") {
 
 
     REQUIRE(true);
-}
\ No newline at end of file
+}
+#if defined(KTH_CURRENCY_BCH)
+
+// Three independent 60 byte transactions paying 2, 1 and 3 satoshis of fee.
+std::vector<transaction> get_template_txs() {
+    transaction x {1, 1, {input{output_point{null_hash, 0}, script{}, 1}}, {output{48, script{}}}};
+    transaction y {1, 1, {input{output_point{hash_one, 0}, script{}, 1}}, {output{49, script{}}}};
+    transaction z {1, 1, {input{output_point{hash_two, 0}, script{}, 1}}, {output{47, script{}}}};
+    std::vector<transaction> res {x, y, z};
+
+    for (auto& tx : res) {
+        add_state(tx);
+        tx.inputs()[0].previous_output().validation.cache = output{50, script{}};
+        tx.inputs()[0].previous_output().validation.from_mempool = false;
+    }
+
+    return res;
+}
+
+bool in_ctor_order(mempool::block_template_t const& gbt) {
+    return std::is_sorted(gbt.first.begin(), gbt.first.end(), [](auto const& a, auto const& b) {
+        return ctor_less{}(a.txid(), b.txid());
+    });
+}
+
+TEST_CASE("[mempool] Block template in CTOR order") {
+    auto const txs = get_template_txs();
+
+    mempool mp(3 * 60);
+    for (auto const& tx : txs) {
+        REQUIRE(mp.add(tx) == error::success);
+    }
+
+    auto const gbt = mp.get_block_template();
+    REQUIRE(gbt.first.size() == 3);
+    REQUIRE(gbt.second == 6);
+    REQUIRE(in_ctor_order(gbt));
+}
+
+TEST_CASE("[mempool] Block template limited to the ABLA size") {
+    auto const txs = get_template_txs();
+
+    mempool mp(3 * 60);
+    for (auto const& tx : txs) {
+        REQUIRE(mp.add(tx) == error::success);
+    }
+
+    // Room for two of the three transactions.
+    auto const gbt = mp.get_block_template(2 * 60);
+    REQUIRE(gbt.first.size() == 2);
+    REQUIRE(in_ctor_order(gbt));
+
+    size_t size = 0;
+    uint64_t fees = 0;
+    for (auto const& elem : gbt.first) {
+        size += elem.size();
+        fees += elem.fee();
+    }
+
+    REQUIRE(size <= 2 * 60);
+    REQUIRE(gbt.second == fees);
+
+    // The full size is built apart, not served from the limited template.
+    REQUIRE(mp.get_block_template().first.size() == 3);
+}
+
+TEST_CASE("[mempool] Block template cache invalidated by a new block") {
+    auto const txs = get_template_txs();
+
+    mempool mp(3 * 60);
+    for (auto const& tx : txs) {
+        REQUIRE(mp.add(tx) == error::success);
+    }
+
+    auto const before = mp.get_block_template();
+    REQUIRE(before.first.size() == 3);
+
+    // Unchanged pool, same template.
+    auto const cached = mp.get_block_template();
+    REQUIRE(cached.first.size() == 3);
+    REQUIRE(cached.second == before.second);
+
+    // The tip changes, x is confirmed.
+    std::vector<transaction> confirmed {txs[0]};
+    REQUIRE(mp.remove(confirmed.begin(), confirmed.end(), 0) == error::success);
+
+    auto const after = mp.get_block_template();
+    REQUIRE(after.first.size() == 2);
+    REQUIRE(after.second == before.second - txs[0].fees());
+    REQUIRE(in_ctor_order(after));
+    REQUIRE(std::none_of(after.first.begin(), after.first.end(), [&](auto const& elem) {
+        return elem.txid() == txs[0].hash();
+    }));
+}
+
+#endif // KTH_CURRENCY_BCH
@@ -0,0 +1,95 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <kth/blockchain.hpp>
+
+using namespace kth;
+using namespace kth::blockchain;
+using namespace kth::domain::chain;
+
+namespace {
+
+block_const_ptr make_block(uint32_t nonce) {
+    header const head(header_basis{1, null_hash, null_hash, 0, 0, nonce});
+    return std::make_shared<domain::message::block const>(head, transaction::list{});
+}
+
+} // namespace
+
+TEST_CASE("recent blocks  construct capacity 0  disabled", "[recent blocks]") {
+    recent_blocks cache(0);
+    REQUIRE(cache.disabled());
+    auto const block = make_block(1);
+    cache.add(block, 1);
+
+    size_t height;
+    REQUIRE( ! cache.find(block->hash(), height));
+    REQUIRE(cache.size() == 0u);
+}
+
+TEST_CASE("recent blocks  add  found by hash and height", "[recent blocks]") {
+    recent_blocks cache(4);
+    auto const block = make_block(1);
+    cache.add(block, 10);
+
+    size_t height = 0;
+    REQUIRE(cache.find(block->hash(), height) == block);
+    REQUIRE(height == 10u);
+    REQUIRE(cache.find(10) == block);
+    REQUIRE( ! cache.find(11));
+}
+
+TEST_CASE("recent blocks  data  wire encoding shared", "[recent blocks]") {
+    recent_blocks cache(4);
+    auto const block = make_block(1);
+    cache.add(block, 10);
+
+    size_t height = 0;
+    auto const data = cache.data(block->hash(), height);
+    REQUIRE(data);
+    REQUIRE(height == 10u);
+    REQUIRE(*data == block->domain::chain::block::to_data());
+    REQUIRE(cache.data(block->hash(), height) == data);
+}
+
+TEST_CASE("recent blocks  full  least recently used evicted", "[recent blocks]") {
+    recent_blocks cache(2);
+    auto const block1 = make_block(1);
+    auto const block2 = make_block(2);
+    auto const block3 = make_block(3);
+    cache.add(block1, 1);
+    cache.add(block2, 2);
+
+    // Touch the first block, the second becomes the oldest.
+    size_t height;
+    REQUIRE(cache.find(block1->hash(), height));
+
+    cache.add(block3, 3);
+    REQUIRE(cache.size() == 2u);
+    REQUIRE(cache.find(block1->hash(), height));
+    REQUIRE( ! cache.find(block2->hash(), height));
+    REQUIRE(cache.find(block3->hash(), height));
+}
+
+TEST_CASE("recent blocks  reorganization  blocks above fork removed", "[recent blocks]") {
+    recent_blocks cache(8);
+    auto const block1 = make_block(1);
+    auto const block2 = make_block(2);
+    auto const block3 = make_block(3);
+    auto const other2 = make_block(4);
+    cache.add(block1, 1);
+    cache.add(block2, 2);
+    cache.add(block3, 3);
+
+    cache.add(other2, 2);
+
+    size_t height;
+    REQUIRE(cache.size() == 2u);
+    REQUIRE(cache.find(block1->hash(), height));
+    REQUIRE( ! cache.find(block2->hash(), height));
+    REQUIRE( ! cache.find(block3->hash(), height));
+    REQUIRE(cache.find(2) == other2);
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <kth/blockchain.hpp>
+
+using namespace kth;
+using namespace kth::blockchain;
+
+namespace {
+
+hash_digest make_hash(uint8_t seed, uint8_t salt = 0) {
+    hash_digest hash = null_hash;
+    hash[0] = seed;
+    hash[1] = salt;
+    return hash;
+}
+
+} // namespace
+
+TEST_CASE("script cache  construct capacity 0  disabled", "[script cache]") {
+    script_cache cache(0);
+    REQUIRE(cache.disabled());
+    cache.add(make_hash(1), 42, 3);
+    REQUIRE( ! cache.find(make_hash(1), 42));
+    REQUIRE(cache.size() == 0u);
+}
+
+TEST_CASE("script cache  add then find  hit with sigchecks", "[script cache]") {
+    script_cache cache(100);
+    cache.add(make_hash(1), 42, 3);
+    auto const sigchecks = cache.find(make_hash(1), 42);
+    REQUIRE(sigchecks);
+    REQUIRE(*sigchecks == 3u);
+    REQUIRE(cache.hits() == 1u);
+    REQUIRE(cache.misses() == 0u);
+}
+
+TEST_CASE("script cache  find other forks  miss", "[script cache]") {
+    script_cache cache(100);
+    cache.add(make_hash(1), 42, 3);
+    REQUIRE( ! cache.find(make_hash(1), 43));
+    REQUIRE(cache.misses() == 1u);
+}
+
+TEST_CASE("script cache  add existing  replaced", "[script cache]") {
+    script_cache cache(100);
+    cache.add(make_hash(1), 42, 3);
+    cache.add(make_hash(1), 43, 5);
+    REQUIRE(cache.size() == 1u);
+    REQUIRE( ! cache.find(make_hash(1), 42));
+    REQUIRE(*cache.find(make_hash(1), 43) == 5u);
+}
+
+TEST_CASE("script cache  shard full  oldest evicted", "[script cache]") {
+    // One entry per shard, same first byte means same shard.
+    script_cache cache(16);
+    cache.add(make_hash(1, 0), 42, 0);
+    cache.add(make_hash(1, 1), 42, 0);
+    REQUIRE( ! cache.find(make_hash(1, 0), 42));
+    REQUIRE(cache.find(make_hash(1, 1), 42));
+}
+
+TEST_CASE("script cache  clear  empty", "[script cache]") {
+    script_cache cache(100);
+    cache.add(make_hash(1), 42, 3);
+    cache.add(make_hash(2), 42, 3);
+    cache.clear();
+    REQUIRE(cache.size() == 0u);
+    REQUIRE( ! cache.find(make_hash(1), 42));
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <cstdint>
+#include <memory>
+
+#include <kth/blockchain.hpp>
+
+using namespace kth;
+using namespace kd::chain;
+using namespace kth::blockchain;
+
+// Start Test Suite: unconfirmed pool tests
+
+static
+transaction_const_ptr make_tx(uint32_t locktime) {
+    return std::make_shared<transaction const>(transaction{1, locktime, {}, {}});
+}
+
+TEST_CASE("unconfirmed pool  add  contains", "[unconfirmed pool]") {
+    unconfirmed_pool pool;
+    auto const tx = make_tx(1);
+    pool.add(tx, 0);
+    REQUIRE(pool.size() == 1u);
+    REQUIRE(pool.contains(tx->hash()));
+}
+
+TEST_CASE("unconfirmed pool  find  pooled only", "[unconfirmed pool]") {
+    unconfirmed_pool pool;
+    auto const tx = make_tx(1);
+    pool.add(tx, 0);
+    pool.add_extra(make_tx(2));
+    REQUIRE(pool.find(tx->hash()) == tx);
+    REQUIRE( ! pool.find(make_tx(2)->hash()));
+}
+
+TEST_CASE("unconfirmed pool  remove confirmed block  removed", "[unconfirmed pool]") {
+    unconfirmed_pool pool;
+    auto const tx1 = make_tx(1);
+    auto const tx2 = make_tx(2);
+    pool.add(tx1, 0);
+    pool.add(tx2, 0);
+
+    block const confirmed{header{}, {*tx1}};
+    pool.remove(confirmed);
+    REQUIRE( ! pool.contains(tx1->hash()));
+    REQUIRE(pool.contains(tx2->hash()));
+}
+
+TEST_CASE("unconfirmed pool  add extra beyond capacity  overwrites oldest", "[unconfirmed pool]") {
+    unconfirmed_pool pool(2);
+    pool.add_extra(make_tx(1));
+    pool.add_extra(make_tx(2));
+    pool.add_extra(make_tx(3));
+    REQUIRE(pool.extra_size() == 2u);
+
+    auto const snapshot = pool.take_snapshot();
+    REQUIRE(snapshot.pooled == 0u);
+    REQUIRE(snapshot.hashes.size() == 2u);
+    REQUIRE(snapshot.hashes[0] == make_tx(3)->hash());
+    REQUIRE(snapshot.hashes[1] == make_tx(2)->hash());
+}
+
+TEST_CASE("unconfirmed pool  take snapshot  pooled first", "[unconfirmed pool]") {
+    unconfirmed_pool pool;
+    pool.add(make_tx(1), 0);
+    pool.add_extra(make_tx(2));
+
+    auto const snapshot = pool.take_snapshot();
+    REQUIRE(snapshot.pooled == 1u);
+    REQUIRE(snapshot.transactions.size() == 2u);
+    REQUIRE(snapshot.hashes[0] == make_tx(1)->hash());
+    REQUIRE(snapshot.hashes[1] == snapshot.transactions[1]->hash());
+}
+
+TEST_CASE("unconfirmed pool  add paying output  indexed by address", "[unconfirmed pool]") {
+    using kd::wallet::payment_address;
+    short_hash const hash{{ 0x01, 0x02, 0x03 }};
+    payment_address const address(hash);
+    output const paying{1000, script{script::to_pay_public_key_hash_pattern(hash)}, {}};
+    auto const tx = std::make_shared<transaction const>(transaction{1, 0, {}, {output{}, paying}});
+
+    unconfirmed_pool pool;
+    pool.add(tx, 42);
+
+    auto const entries = pool.get_address_entries(address);
+    REQUIRE(entries.size() == 1u);
+    REQUIRE(entries[0].tx->hash() == tx->hash());
+    REQUIRE(entries[0].index == 1u);
+    REQUIRE( ! entries[0].input);
+    REQUIRE(entries[0].arrival_time == 42u);
+
+    pool.remove(tx->hash());
+    REQUIRE(pool.get_address_entries(address).empty());
+}
+
+// End Test Suite
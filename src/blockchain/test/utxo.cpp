@@ -97,7 +97,7 @@ domain::chain::block read_block(const std::string hex) {
 TEST_CASE("utxo  get utxo  not found  false", "[utxo tests]") {
     START_BLOCKCHAIN(instance, false);
 
-    domain::chain::output output;
+    domain::chain::prevout_cache output;
     size_t height;
     uint32_t median_time_past;
     bool coinbase;
@@ -114,7 +114,7 @@ TEST_CASE("utxo  get utxo  found  expected", "[utxo tests]") {
     REQUIRE(instance.insert(block1, 1));
     REQUIRE(instance.insert(block2, 2));
 
-    domain::chain::output output;
+    domain::chain::prevout_cache output;
     size_t height;
     uint32_t median_time_past;
     bool coinbase;
@@ -136,7 +136,7 @@ TEST_CASE("utxo  get utxo  above fork  false", "[utxo tests]") {
     REQUIRE(instance.insert(block1, 1));
     REQUIRE(instance.insert(block2, 2));
 
-    domain::chain::output output;
+    domain::chain::prevout_cache output;
     size_t height;
     uint32_t median_time_past;
     bool coinbase;
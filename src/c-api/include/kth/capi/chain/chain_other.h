@@ -42,6 +42,11 @@ void kth_chain_transaction_validate_sequential(kth_chain_t chain, void* ctx, kth
 KTH_EXPORT
 kth_bool_t kth_chain_is_stale(kth_chain_t chain);
 
+/// The multiset hash (ECMH) of the unspent outputs at height, available for
+/// the top and for the recent (reorganizable) blocks.
+KTH_EXPORT
+kth_bool_t kth_chain_get_utxo_set_hash(kth_chain_t chain, kth_size_t height, kth_hash_t* out_hash);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -32,6 +32,7 @@ void kth_chain_output_point_get_hash_out(kth_outputpoint_t op, kth_hash_t* out_h
 KTH_EXPORT
 uint32_t kth_chain_output_point_get_index(kth_outputpoint_t op);
 
+// Returns a copy, to be released with kth_chain_output_destruct.
 KTH_EXPORT
 kth_output_t kth_chain_output_point_get_cached_output(kth_outputpoint_t op);
 
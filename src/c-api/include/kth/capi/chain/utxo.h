@@ -48,6 +48,7 @@ uint32_t kth_chain_utxo_get_index(kth_utxo_t utxo);
 KTH_EXPORT
 uint64_t kth_chain_utxo_get_amount(kth_utxo_t utxo);
 
+// Returns a copy, to be released with kth_chain_output_destruct.
 KTH_EXPORT
 kth_output_t kth_chain_utxo_get_cached_output(kth_utxo_t utxo);
 
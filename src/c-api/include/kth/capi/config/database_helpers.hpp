@@ -34,6 +34,12 @@ Target database_settings_to_common(Source const& x) {
     res.db_max_size = x.db_max_size;
     res.safe_mode = x.safe_mode;
     res.cache_capacity = x.cache_capacity;
+    res.cache_size = x.cache_size;
+    res.ibd_batch_blocks = x.ibd_batch_blocks;
+    res.ibd_batch_size = x.ibd_batch_size;
+    res.ibd_flush_interval = x.ibd_flush_interval;
+    res.async_indexes = x.async_indexes;
+    res.rebuild_indexes = x.rebuild_indexes;
     return res;
 }
 
@@ -20,6 +20,12 @@ typedef struct {
     uint64_t db_max_size;
     kth_bool_t safe_mode;
     uint32_t cache_capacity;
+    uint32_t cache_size;
+    uint32_t ibd_batch_blocks;
+    uint32_t ibd_batch_size;
+    uint32_t ibd_flush_interval;
+    kth_bool_t async_indexes;
+    kth_bool_t rebuild_indexes;
 
 } kth_database_settings;
 
@@ -22,6 +22,7 @@ Target node_settings_to_common(Source const& x) {
     res.sync_peers = x.sync_peers;
     res.sync_timeout_seconds = x.sync_timeout_seconds;
     res.block_latency_seconds = x.block_latency_seconds;
+    res.transaction_trickle_milliseconds = x.transaction_trickle_milliseconds;
     res.refresh_transactions = x.refresh_transactions;
     res.compact_blocks_high_bandwidth = x.compact_blocks_high_bandwidth;
     res.ds_proofs_enabled = x.ds_proofs_enabled;
@@ -17,6 +17,7 @@ typedef struct {
     uint32_t sync_peers;
     uint32_t sync_timeout_seconds;
     uint32_t block_latency_seconds;
+    uint32_t transaction_trickle_milliseconds;
     kth_bool_t refresh_transactions;
     kth_bool_t compact_blocks_high_bandwidth;
     kth_bool_t ds_proofs_enabled;
@@ -145,6 +145,15 @@ kth_bool_t kth_chain_is_stale(kth_chain_t chain) {
     return kth::bool_to_int(safe_chain(chain).is_stale());
 }
 
+kth_bool_t kth_chain_get_utxo_set_hash(kth_chain_t chain, kth_size_t height, kth_hash_t* out_hash) {
+    kth::hash_digest hash;
+    if ( ! safe_chain(chain).get_utxo_set_hash(hash, height)) {
+        return kth::bool_to_int(false);
+    }
+    kth::copy_c_hash(hash, out_hash);
+    return kth::bool_to_int(true);
+}
+
 } // extern "C"
 
 
@@ -47,9 +47,9 @@ uint32_t kth_chain_output_point_get_index(kth_outputpoint_t op) {
     return kth_chain_output_point_const_cpp(op).index();
 }
 
+// The cached output is shared (i.e. with the utxo cache), the caller owns a copy.
 kth_output_t kth_chain_output_point_get_cached_output(kth_outputpoint_t op) {
-    auto& output = kth_chain_output_point_const_cpp(op).validation.cache;
-    return &output;
+    return kth::move_or_copy_and_leak(kth_chain_output_point_const_cpp(op).validation.cache.get());
 }
 
 void kth_chain_output_point_set_hash(kth_outputpoint_t op, kth_hash_t const* hash) {
@@ -111,9 +111,9 @@ uint64_t kth_chain_utxo_get_amount(kth_utxo_t utxo) {
     return kth_chain_utxo_const_cpp(utxo).amount();
 }
 
+// The cached output is shared (i.e. with the utxo cache), the caller owns a copy.
 kth_output_t kth_chain_utxo_get_cached_output(kth_utxo_t utxo) {
-    auto& output = kth_chain_utxo_const_cpp(utxo).point().validation.cache;
-    return &output;
+    return kth::move_or_copy_and_leak(kth_chain_utxo_const_cpp(utxo).point().validation.cache.get());
 }
 
 kth_bool_t kth_chain_utxo_has_token_data(kth_utxo_t utxo) {
@@ -366,6 +366,63 @@ typedef enum verify_flags_type {
     int64_t amount,
     std::vector<std::vector<uint8_t>> coins);
 
+/**
+ * Script data of a single transaction input, used by verify_scripts.
+ * The referenced buffers must remain valid during the call.
+ */
+typedef struct verify_input_type {
+    unsigned int tx_input_index;
+    unsigned char const* locking_script_data;
+    size_t locking_script_size;
+    unsigned char const* unlocking_script_data;
+    size_t unlocking_script_size;
+} verify_input;
+
+/**
+ * Verify a set of inputs of the same transaction. The transaction and the
+ * coins it spends are deserialized once and the signature hash midstate
+ * (hashPrevouts, hashSequence, hashOutputs, hashUtxos) is computed once
+ * and shared by all the verified inputs.
+ * Verification stops at the first failing input.
+ * @param[in]  transaction       The transaction with the scripts to verify.
+ * @param[in]  transaction_size  The byte length of the transaction.
+ * @param[in]  coins             The serialized outputs spent by every input
+ *                               of the transaction, in input order. Empty
+ *                               if no execution context is required.
+ * @param[in]  inputs            The inputs to verify (all or a subset).
+ * @param[in]  flags             Verification constraint flags.
+ * @param[out] sig_checks        The sum of the sigchecks of the verified inputs.
+ * @param[out] failed_input      The position in `inputs` of the failing
+ *                               input, `inputs.size()` on success.
+ * @param[in]  store_signatures  Add the verified signatures to the signature
+ *                               cache (transaction pool). Otherwise cache hits
+ *                               are removed (block validation).
+ * @returns                      A script verification result code.
+ */
+KC_API verify_result_type verify_scripts(
+    unsigned char const* transaction,
+    size_t transaction_size,
+    std::vector<std::vector<uint8_t>> const& coins,
+    std::vector<verify_input_type> const& inputs,
+    unsigned int flags,
+    size_t& sig_checks,
+    size_t& failed_input,
+    bool store_signatures = false);
+
+/**
+ * Resize (and clear) the process wide signature cache used by verify_scripts,
+ * 0 disables it. Must be called before any verification.
+ * @param[in]  entries  The maximum number of cached signatures (32 bytes each).
+ */
+KC_API void set_signature_cache_capacity(size_t entries);
+
+/**
+ * Signature cache statistics since the last resize.
+ * @param[out] hits     The number of signatures found in the cache.
+ * @param[out] queries  The number of signatures looked up.
+ */
+KC_API void get_signature_cache_stats(size_t& hits, size_t& queries);
+
 } // namespace kth::consensus
 
 #endif
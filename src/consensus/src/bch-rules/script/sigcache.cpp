@@ -0,0 +1,135 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <script/sigcache.h>
+
+#include <crypto/common.h>
+#include <crypto/sha256.h>
+#include <pubkey.h>
+#include <random.h>
+
+#include <algorithm>
+
+namespace {
+
+// 32 bytes per entry, 32 MiB.
+constexpr size_t DEFAULT_SIGNATURE_CACHE_ENTRIES = size_t(1) << 20;
+
+} // namespace
+
+SignatureCache::SignatureCache()
+    : salt_(GetRandHash()), stripes_(new std::mutex[STRIPES]) {
+    Resize(DEFAULT_SIGNATURE_CACHE_ENTRIES);
+}
+
+void SignatureCache::Resize(size_t entries) {
+    sets_.clear();
+    sets_.shrink_to_fit();
+    sets_mask_ = 0;
+    hits_ = 0;
+    queries_ = 0;
+
+    if (entries == 0) {
+        return;
+    }
+
+    // Round the number of sets down to a power of two (at least one).
+    size_t sets = 1;
+    while (sets * 2 * WAYS <= entries) {
+        sets *= 2;
+    }
+
+    sets_.resize(sets);
+    sets_mask_ = sets - 1;
+}
+
+uint256 SignatureCache::ComputeEntry(const uint256 &sighash, const CPubKey &pubkey, const std::vector<uint8_t> &sig) const {
+    uint256 entry;
+    CSHA256()
+        .Write(salt_.begin(), salt_.size())
+        .Write(sighash.begin(), sighash.size())
+        .Write(pubkey.begin(), pubkey.size())
+        .Write(sig.data(), sig.size())
+        .Finalize(entry.begin());
+    return entry;
+}
+
+size_t SignatureCache::Index(const uint256 &entry) const {
+    return size_t(ReadLE64(entry.begin())) & sets_mask_;
+}
+
+bool SignatureCache::Get(const uint256 &entry, bool erase) {
+    if (sets_.empty()) {
+        return false;
+    }
+
+    ++queries_;
+    auto const index = Index(entry);
+    std::lock_guard<std::mutex> lock(Stripe(index));
+    auto &set = sets_[index];
+
+    for (auto &way : set.ways) {
+        if (way == entry) {
+            if (erase) {
+                way.SetNull();
+            }
+            ++hits_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SignatureCache::Set(const uint256 &entry) {
+    if (sets_.empty()) {
+        return;
+    }
+
+    auto const index = Index(entry);
+    std::lock_guard<std::mutex> lock(Stripe(index));
+    auto &set = sets_[index];
+
+    // Already present, or fill a free way before replacing the oldest one.
+    for (auto const &way : set.ways) {
+        if (way == entry) {
+            return;
+        }
+    }
+
+    auto const free = std::find_if(std::begin(set.ways), std::end(set.ways), [](const uint256 &way) { return way.IsNull(); });
+    if (free != std::end(set.ways)) {
+        *free = entry;
+        return;
+    }
+
+    set.ways[set.next] = entry;
+    set.next = uint8_t((set.next + 1) % WAYS);
+}
+
+SignatureCache &GetSignatureCache() {
+    static SignatureCache cache;
+    return cache;
+}
+
+bool CachingTransactionSignatureChecker::VerifySignature(const std::vector<uint8_t> &vchSig, const CPubKey &vchPubKey,
+                                                         const uint256 &sighash) const {
+    auto &cache = GetSignatureCache();
+    if ( ! cache.Enabled()) {
+        return TransactionSignatureChecker::VerifySignature(vchSig, vchPubKey, sighash);
+    }
+
+    auto const entry = cache.ComputeEntry(sighash, vchPubKey, vchSig);
+    if (cache.Get(entry, ! store)) {
+        return true;
+    }
+
+    if ( ! TransactionSignatureChecker::VerifySignature(vchSig, vchPubKey, sighash)) {
+        return false;
+    }
+
+    if (store) {
+        cache.Set(entry);
+    }
+    return true;
+}
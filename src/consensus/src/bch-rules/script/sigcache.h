@@ -0,0 +1,78 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <script/interpreter.h>
+#include <uint256.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// Bounded set of the (sighash, pubkey, signature) triples known to verify.
+/// The entries are salted hashes of the triple, so an attacker cannot craft
+/// colliding entries. The cache is set associative: each entry can only live
+/// in the ways of one set, the oldest way of a full set is replaced.
+/// The sets are guarded by striped locks, so concurrent validation threads
+/// rarely contend. This class is thread safe (except Resize).
+class SignatureCache {
+public:
+    static constexpr size_t WAYS = 4;
+
+    SignatureCache();
+
+    /// Resize (and clear) the cache, 0 disables it.
+    /// Not thread safe, must be called before any verification.
+    void Resize(size_t entries);
+
+    bool Enabled() const { return ! sets_.empty(); }
+
+    uint256 ComputeEntry(const uint256 &sighash, const CPubKey &pubkey, const std::vector<uint8_t> &sig) const;
+
+    /// Lookup the entry, optionally removing it on hit.
+    bool Get(const uint256 &entry, bool erase);
+    void Set(const uint256 &entry);
+
+    size_t Hits() const { return hits_; }
+    size_t Queries() const { return queries_; }
+
+private:
+    struct Bucket {
+        uint256 ways[WAYS];
+        uint8_t next = 0;
+    };
+
+    static constexpr size_t STRIPES = 256;
+
+    size_t Index(const uint256 &entry) const;
+    std::mutex &Stripe(size_t index) const { return stripes_[index % STRIPES]; }
+
+    uint256 salt_;
+    std::vector<Bucket> sets_;
+    size_t sets_mask_ = 0;
+    mutable std::unique_ptr<std::mutex[]> stripes_;
+    std::atomic<size_t> hits_ {0};
+    std::atomic<size_t> queries_ {0};
+};
+
+/// The process wide signature cache, shared by all the checkers.
+SignatureCache &GetSignatureCache();
+
+/// Verifies signatures through the signature cache. Successful verifications
+/// are added to the cache only if store is set (transaction pool), otherwise
+/// (block validation) a hit removes the entry, as it is not expected again.
+class CachingTransactionSignatureChecker : public TransactionSignatureChecker {
+    bool store;
+
+public:
+    CachingTransactionSignatureChecker(const ScriptExecutionContext &contextIn, const PrecomputedTransactionData &txdataIn, bool storeIn)
+        : TransactionSignatureChecker(contextIn, txdataIn), store(storeIn) {}
+
+    bool VerifySignature(const std::vector<uint8_t> &vchSig, const CPubKey &vchPubKey,
+                         const uint256 &sighash) const override;
+};
@@ -20,6 +20,7 @@
 #include "pubkey.h"
 #include "script/interpreter.h"
 #include "script/script_error.h"
+#include "script/sigcache.h"
 #include "streams.h"
 #include "version.h"
 
@@ -291,6 +292,131 @@ verify_result_type verify_script(
     return script_error_to_verify_result(error);
 }
 
+// This function is published. The implementation exposes no satoshi internals.
+verify_result_type verify_scripts(
+    unsigned char const* transaction,
+    size_t transaction_size,
+    std::vector<std::vector<uint8_t>> const& coins,
+    std::vector<verify_input_type> const& inputs,
+    unsigned int flags,
+    size_t& sig_checks,
+    size_t& failed_input,
+    bool store_signatures) {
+
+    sig_checks = 0;
+    failed_input = 0;
+
+    if (transaction_size > 0 && transaction == nullptr) {
+        throw std::invalid_argument("transaction");
+    }
+
+    for (auto const& input : inputs) {
+        if (input.locking_script_size > 0 && input.locking_script_data == nullptr) {
+            throw std::invalid_argument("locking_script_data");
+        }
+
+        if (input.unlocking_script_size > 0 && input.unlocking_script_data == nullptr) {
+            throw std::invalid_argument("unlocking_script_data");
+        }
+    }
+
+    std::optional<CTransaction> txopt;
+
+    try {
+        transaction_istream stream(transaction, transaction_size);
+        txopt.emplace(deserialize, stream);
+    }
+    catch (const std::exception&) {
+        return verify_result_tx_invalid;
+    }
+
+    if ( ! txopt) {
+        return verify_result_tx_invalid;
+    }
+
+    auto const& tx = *txopt;
+
+    if (GetSerializeSize(tx, PROTOCOL_VERSION) != transaction_size) {
+        return verify_result_tx_size_invalid;
+    }
+
+    if ( ! coins.empty() && coins.size() != tx.vin.size()) {
+        return verify_result_tx_input_invalid;
+    }
+
+    const unsigned int script_flags = verify_flags_to_script_flags(flags);
+
+    // The coins are deserialized and the sighash midstate is computed only
+    // once, all the inputs share them.
+    std::vector<ScriptExecutionContext> contexts;
+    PrecomputedTransactionData txdata;
+
+    if ( ! coins.empty()) {
+        auto const output_getter = [&coins](size_t i) {
+            auto const& data = coins.at(i);
+            CDataStream stream(data, SER_NETWORK, PROTOCOL_VERSION);
+            CTxOut ret;
+            ::Unserialize(stream, ret);
+            return ret;
+        };
+
+        try {
+            contexts = ScriptExecutionContext::createForAllInputs(tx, output_getter);
+        }
+        catch (const std::exception&) {
+            return verify_result_tx_input_invalid;
+        }
+
+        if ( ! contexts.empty()) {
+            txdata.PopulateFromContext(contexts.front());
+        }
+    }
+
+    for (; failed_input < inputs.size(); ++failed_input) {
+        auto const& input = inputs[failed_input];
+
+        if (input.tx_input_index >= tx.vin.size()) {
+            return verify_result_tx_input_invalid;
+        }
+
+        CScript const locking_script(input.locking_script_data, input.locking_script_data + input.locking_script_size);
+        CScript const unlocking_script(input.unlocking_script_data, input.unlocking_script_data + input.unlocking_script_size);
+
+        ScriptError error;
+        ScriptExecutionMetrics metrics = {};
+
+        if ( ! contexts.empty()) {
+            CachingTransactionSignatureChecker checker(contexts[input.tx_input_index], txdata, store_signatures);
+            VerifyScript(unlocking_script, locking_script, script_flags, checker, metrics, &error);
+        } else {
+            ScriptExecutionContextOpt context = std::nullopt;
+            ContextOptSignatureChecker checker(context);
+            VerifyScript(unlocking_script, locking_script, script_flags, checker, metrics, &error);
+        }
+
+        sig_checks += metrics.nSigChecks;
+        auto const result = script_error_to_verify_result(error);
+
+        if (result != verify_result_eval_true) {
+            return result;
+        }
+    }
+
+    return verify_result_eval_true;
+}
+
+// This function is published. The implementation exposes no satoshi internals.
+void set_signature_cache_capacity(size_t entries) {
+    GetSignatureCache().Resize(entries);
+}
+
+// This function is published. The implementation exposes no satoshi internals.
+void get_signature_cache_stats(size_t& hits, size_t& queries) {
+    auto const& cache = GetSignatureCache();
+    hits = cache.Hits();
+    queries = cache.Queries();
+}
+
 char const* version() {
     return KTH_CONSENSUS_VERSION;
 }
@@ -177,6 +177,80 @@ TEST_CASE("consensus script verify valid true forkid long int", "[consensus scri
     size_t sig_checks;
     const verify_result result = test_verify(CONSENSUS_FORKID_TX, CONSENSUS_FORKID_TX_PREV_SCRIPT, sig_checks, 0, flags, 0, CONSENSUS_FORKID_TX_AMMOUT);
 }
+
+static
+verify_result test_verify_scripts(std::string const& transaction, std::vector<std::string> const& prevout_scripts, size_t& sig_checks, size_t& failed_input,
+    std::vector<uint32_t> const& tx_input_indexes, const uint32_t flags=verify_flags_p2sh) {
+    std::vector<std::vector<uint8_t>> coins;
+    auto const tx_data = decode_base16(transaction);
+    REQUIRE(tx_data);
+    REQUIRE(prevout_scripts.size() == tx_input_indexes.size());
+
+    std::vector<data_chunk> scripts;
+    std::vector<verify_input> inputs;
+    scripts.reserve(prevout_scripts.size());
+
+    for (size_t i = 0; i < prevout_scripts.size(); ++i) {
+        auto const prevout_script_data = decode_base16(prevout_scripts[i]);
+        REQUIRE(prevout_script_data);
+        auto const& script = scripts.emplace_back(*prevout_script_data);
+        inputs.push_back({tx_input_indexes[i], script.data(), script.size(), nullptr, 0});
+    }
+
+    return verify_scripts(&(*tx_data)[0], tx_data->size(), coins, inputs, flags, sig_checks, failed_input);
+}
+
+TEST_CASE("consensus script verify scripts null tx throws invalid argument", "[consensus script verify]") {
+    size_t sig_checks;
+    size_t failed_input;
+    std::vector<std::vector<uint8_t>> coins;
+    std::vector<verify_input> inputs;
+    REQUIRE_THROWS_AS(verify_scripts(NULL, 1, coins, inputs, 0, sig_checks, failed_input), std::invalid_argument);
+}
+
+TEST_CASE("consensus script verify scripts invalid tx tx invalid", "[consensus script verify]") {
+    size_t sig_checks;
+    size_t failed_input;
+    const verify_result result = test_verify_scripts("42", {"42"}, sig_checks, failed_input, {0});
+    REQUIRE(result == verify_result_tx_invalid);
+}
+
+TEST_CASE("consensus script verify scripts no inputs true", "[consensus script verify]") {
+    size_t sig_checks;
+    size_t failed_input;
+    const verify_result result = test_verify_scripts(consensus_script_verify_tx, {}, sig_checks, failed_input, {});
+    REQUIRE(result == verify_result_eval_true);
+    REQUIRE(sig_checks == 0);
+    REQUIRE(failed_input == 0);
+}
+
+TEST_CASE("consensus script verify scripts invalid input tx input invalid", "[consensus script verify]") {
+    size_t sig_checks;
+    size_t failed_input;
+    const verify_result result = test_verify_scripts(consensus_script_verify_tx, {consensus_script_verify_prevout_script}, sig_checks, failed_input, {1});
+    REQUIRE(result == verify_result_tx_input_invalid);
+    REQUIRE(failed_input == 0);
+}
+
+TEST_CASE("consensus script verify scripts matches single verify", "[consensus script verify]") {
+    size_t sig_checks;
+    size_t batch_sig_checks;
+    size_t failed_input;
+    auto const expected = test_verify(consensus_script_verify_tx, consensus_script_verify_prevout_script, sig_checks);
+    const verify_result result = test_verify_scripts(consensus_script_verify_tx, {consensus_script_verify_prevout_script}, batch_sig_checks, failed_input, {0});
+    REQUIRE(result == expected);
+    REQUIRE(batch_sig_checks == sig_checks);
+}
+
+TEST_CASE("consensus script verify scripts reports failed input", "[consensus script verify]") {
+    size_t sig_checks;
+    size_t failed_input;
+    const verify_result result = test_verify_scripts(consensus_script_verify_tx,
+        {consensus_script_verify_prevout_script, "76a914c564c740c6900b93afc9f1bdaef0a9d466adf6ef88ac"},
+        sig_checks, failed_input, {0, 0});
+    REQUIRE(result == verify_result_equalverify);
+    REQUIRE(failed_input == 1);
+}
 #else
 
 TEST_CASE("consensus script verify valid nested p2wpkh true", "[consensus script verify]") {
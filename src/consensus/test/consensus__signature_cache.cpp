@@ -0,0 +1,138 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <test_helpers.hpp>
+
+#if defined(KTH_CURRENCY_BCH)
+#include <bch-rules/primitives/transaction.h>
+#include <bch-rules/pubkey.h>
+#include <bch-rules/script/interpreter.h>
+#include <bch-rules/script/script_execution_context.h>
+#include <bch-rules/script/sigcache.h>
+#include <bch-rules/uint256.h>
+
+// Start Test Suite: consensus signature cache
+
+namespace {
+
+uint256 make_entry(uint8_t seed) {
+    // The leading bytes select the set, all these entries share set 0.
+    uint256 entry;
+    *(entry.begin() + 31) = seed;
+    return entry;
+}
+
+std::vector<uint8_t> const signature {0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01, 0x41};
+std::vector<uint8_t> const public_key(33, 0x02);
+
+} // namespace
+
+TEST_CASE("consensus signature cache  set then get  hit", "[consensus signature cache]") {
+    SignatureCache cache;
+    cache.Resize(64);
+    auto const entry = cache.ComputeEntry(uint256S("01"), CPubKey(public_key), signature);
+
+    REQUIRE( ! cache.Get(entry, false));
+    cache.Set(entry);
+    REQUIRE(cache.Get(entry, false));
+    REQUIRE(cache.Hits() == 1u);
+    REQUIRE(cache.Queries() == 2u);
+}
+
+TEST_CASE("consensus signature cache  get erase  removed", "[consensus signature cache]") {
+    SignatureCache cache;
+    cache.Resize(64);
+    auto const entry = make_entry(1);
+
+    cache.Set(entry);
+    REQUIRE(cache.Get(entry, true));
+    REQUIRE( ! cache.Get(entry, false));
+}
+
+TEST_CASE("consensus signature cache  compute entry  salted per cache", "[consensus signature cache]") {
+    SignatureCache cache1;
+    SignatureCache cache2;
+    auto const sighash = uint256S("01");
+    CPubKey const pubkey(public_key);
+
+    // Deterministic within a cache, unpredictable across caches.
+    REQUIRE(cache1.ComputeEntry(sighash, pubkey, signature) == cache1.ComputeEntry(sighash, pubkey, signature));
+    REQUIRE(cache1.ComputeEntry(sighash, pubkey, signature) != cache2.ComputeEntry(sighash, pubkey, signature));
+
+    // Every part of the triple is committed.
+    auto other_signature = signature;
+    other_signature.back() = 0x01;
+    REQUIRE(cache1.ComputeEntry(sighash, pubkey, signature) != cache1.ComputeEntry(uint256S("02"), pubkey, signature));
+    REQUIRE(cache1.ComputeEntry(sighash, pubkey, signature) != cache1.ComputeEntry(sighash, pubkey, other_signature));
+}
+
+TEST_CASE("consensus signature cache  set beyond ways  oldest replaced", "[consensus signature cache]") {
+    // A single set, every entry competes for the same ways.
+    SignatureCache cache;
+    cache.Resize(SignatureCache::WAYS);
+
+    for (size_t i = 0; i <= SignatureCache::WAYS; ++i) {
+        cache.Set(make_entry(uint8_t(i + 1)));
+    }
+
+    REQUIRE( ! cache.Get(make_entry(1), false));
+    for (size_t i = 1; i <= SignatureCache::WAYS; ++i) {
+        REQUIRE(cache.Get(make_entry(uint8_t(i + 1)), false));
+    }
+}
+
+TEST_CASE("consensus signature cache  resize 0  disabled", "[consensus signature cache]") {
+    SignatureCache cache;
+    cache.Resize(64);
+    cache.Set(make_entry(1));
+
+    cache.Resize(0);
+    REQUIRE( ! cache.Enabled());
+    cache.Set(make_entry(1));
+    REQUIRE( ! cache.Get(make_entry(1), false));
+    REQUIRE(cache.Queries() == 0u);
+
+    // Resizing clears the previous entries.
+    cache.Resize(64);
+    REQUIRE(cache.Enabled());
+    REQUIRE( ! cache.Get(make_entry(1), false));
+}
+
+TEST_CASE("consensus caching signature checker  cached signature  verified once", "[consensus signature cache]") {
+    CMutableTransaction mtx;
+    mtx.vin.resize(1);
+    mtx.vout.resize(1);
+    CTransaction const tx(mtx);
+    CTxOut const utxo(Amount::zero(), CScript());
+    ScriptExecutionContext const context(0, utxo, tx);
+    PrecomputedTransactionData const txdata(context);
+
+    auto& cache = GetSignatureCache();
+    cache.Resize(64);
+
+    auto const sighash = uint256S("01");
+    CPubKey const pubkey(public_key);
+
+    // Not a valid signature, and not cached.
+    CachingTransactionSignatureChecker const block_checker(context, txdata, false);
+    REQUIRE( ! block_checker.VerifySignature(signature, pubkey, sighash));
+
+    // Known to verify (i.e. by the pool), block validation consumes it.
+    cache.Set(cache.ComputeEntry(sighash, pubkey, signature));
+    REQUIRE(block_checker.VerifySignature(signature, pubkey, sighash));
+    REQUIRE( ! block_checker.VerifySignature(signature, pubkey, sighash));
+
+    // Failures are never stored.
+    CachingTransactionSignatureChecker const pool_checker(context, txdata, true);
+    REQUIRE( ! pool_checker.VerifySignature(signature, pubkey, sighash));
+    REQUIRE( ! cache.Get(cache.ComputeEntry(sighash, pubkey, signature), false));
+}
+
+// End Test Suite
+
+#endif // KTH_CURRENCY_BCH
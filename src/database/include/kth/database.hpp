@@ -15,6 +15,7 @@
 #include <kth/domain.hpp>
 #include <kth/database/data_base.hpp>
 #include <kth/database/define.hpp>
+#include <kth/database/indexer.hpp>
 #include <kth/database/settings.hpp>
 #include <kth/database/store.hpp>
 #include <kth/database/version.hpp>
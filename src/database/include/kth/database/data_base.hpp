@@ -6,14 +6,19 @@
 #define KTH_DATABASE_DATA_BASE_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <kth/domain.hpp>
 #include <kth/database/define.hpp>
 #include <kth/database/databases/internal_database.hpp>
 #include <kth/database/define.hpp>
+#include <kth/database/indexer.hpp>
 #include <kth/database/settings.hpp>
 #include <kth/database/store.hpp>
 
@@ -41,6 +46,11 @@ public:
 #if ! defined(KTH_DB_READONLY)
     /// Create and open all databases.
     bool create(domain::chain::block const& genesis);
+
+    /// Create and open all databases, loading the chain from a snapshot
+    /// file checked against the trusted values (see
+    /// internal_database::import_utxo_snapshot). Closed on failure.
+    bool create_from_snapshot(path const& file, domain::chain::block const& genesis, utxo_snapshot_trust const& trust);
 #endif
 
     /// Open all databases.
@@ -67,6 +77,9 @@ public:
     /// Returns store_block_duplicate if a block already exists at height.
     code insert(domain::chain::block const& block, size_t height);
 
+    /// Insert a block, batching the writes of old blocks (see settings).
+    code insert(block_const_ptr block, size_t height);
+
     /// Add an unconfirmed tx to the store (without indexing).
     /// Returns unspent_duplicate if existing unspent hash duplicate exists.
     code push(domain::chain::transaction const& tx, uint32_t forks);
@@ -118,6 +131,16 @@ private:
 
 #endif // ! defined(KTH_DB_READONLY)
 
+#if ! defined(KTH_DB_READONLY)
+    void start_indexers();
+    void stop_indexers();
+    void notify_indexers();
+
+    void start_flusher();
+    void stop_flusher();
+    void run_flusher();
+#endif // ! defined(KTH_DB_READONLY)
+
     code verify_insert(domain::chain::block const& block, size_t height);
     code verify_push(domain::chain::block const& block, size_t height) const;
 
@@ -134,6 +157,18 @@ private:
 
     std::atomic<bool> closed_;
     settings const& settings_;
+
+#if ! defined(KTH_DB_READONLY)
+    // Asynchronous indexes, empty unless enabled.
+    std::vector<std::unique_ptr<indexer>> indexers_;
+
+    // Commits the batched blocks once the flush interval expires, so the
+    // last batch is not held until the next block arrives.
+    std::thread flusher_;
+    bool flusher_stopped_ = true;
+    std::mutex flusher_mutex_;
+    std::condition_variable flusher_condition_;
+#endif // ! defined(KTH_DB_READONLY)
 };
 
 } // namespace kth::database
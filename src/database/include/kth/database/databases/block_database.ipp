@@ -6,6 +6,7 @@
 #define KTH_DATABASE_BLOCK_DATABASE_IPP_
 
 #include <kth/infrastructure/log/source.hpp>
+#include <kth/infrastructure/message/message_tools.hpp>
 
 namespace kth::database {
 
@@ -119,6 +120,160 @@ domain::chain::block internal_database_basis<Clock>::get_block(uint32_t height,
     return block;
 }
 
+//public
+template <typename Clock>
+std::pair<data_chunk, uint32_t> internal_database_basis<Clock>::get_block_data(hash_digest const& hash) const {
+    auto key = kth_db_make_value(hash.size(), const_cast<hash_digest&>(hash).data());
+
+    KTH_DB_txn* db_txn;
+    auto res = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
+    if (res != KTH_DB_SUCCESS) {
+        return {};
+    }
+
+    KTH_DB_val value;
+    if (kth_db_get(db_txn, dbi_block_header_by_hash_, &key, &value) != KTH_DB_SUCCESS) {
+        kth_db_txn_commit(db_txn);
+        return {};
+    }
+
+    auto const height = *static_cast<uint32_t*>(kth_db_get_data(value));
+    auto data = get_block_data(height, db_txn);
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return {};
+    }
+
+    return {std::move(data), height};
+}
+
+//public
+template <typename Clock>
+data_chunk internal_database_basis<Clock>::get_block_data(uint32_t height) const {
+    KTH_DB_txn* db_txn;
+    auto res = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
+    if (res != KTH_DB_SUCCESS) {
+        return {};
+    }
+
+    auto data = get_block_data(height, db_txn);
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return {};
+    }
+
+    return data;
+}
+
+//public
+template <typename Clock>
+hash_list internal_database_basis<Clock>::get_block_tx_hashes(uint32_t height) const {
+    if (db_mode_ == db_mode_type::pruned) {
+        return {};
+    }
+
+    KTH_DB_txn* db_txn;
+    auto res = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
+    if (res != KTH_DB_SUCCESS) {
+        return {};
+    }
+
+    auto key = kth_db_make_value(sizeof(height), &height);
+    KTH_DB_val value;
+    if (kth_db_get(db_txn, dbi_block_tx_hashes_db_, &key, &value) != KTH_DB_SUCCESS) {
+        kth_db_txn_commit(db_txn);
+        return {};
+    }
+
+    auto const size = kth_db_get_size(value);
+    auto const data = static_cast<uint8_t const*>(kth_db_get_data(value));
+
+    static_assert(sizeof(hash_digest) == hash_size, "hashes must be contiguous");
+    hash_list hashes(size / hash_size);
+    std::memcpy(hashes.data(), data, hashes.size() * hash_size);
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return {};
+    }
+
+    return hashes;
+}
+
+// The blocks and reorg tables store the wire format, in full mode the block
+// is assembled in one pass from the header and the stored transactions.
+template <typename Clock>
+data_chunk internal_database_basis<Clock>::get_block_data(uint32_t height, KTH_DB_txn* db_txn) const {
+    auto key = kth_db_make_value(sizeof(height), &height);
+    KTH_DB_val value;
+
+    if (db_mode_ == db_mode_type::blocks) {
+        if (kth_db_get(db_txn, dbi_block_db_, &key, &value) != KTH_DB_SUCCESS) {
+            return {};
+        }
+        return db_value_to_data_chunk(value);
+    }
+
+    if (db_mode_ == db_mode_type::pruned) {
+        if (kth_db_get(db_txn, dbi_reorg_block_, &key, &value) != KTH_DB_SUCCESS) {
+            return {};
+        }
+        return db_value_to_data_chunk(value);
+    }
+
+    // The header entry starts with the wire header, followed by the abla state.
+    auto const header_size = domain::chain::header::satoshi_fixed_size();
+    if (kth_db_get(db_txn, dbi_block_header_, &key, &value) != KTH_DB_SUCCESS || kth_db_get_size(value) < header_size) {
+        return {};
+    }
+
+    KTH_DB_cursor* cursor;
+    if (kth_db_cursor_open(db_txn, dbi_block_db_, &cursor) != KTH_DB_SUCCESS) {
+        return {};
+    }
+
+    KTH_DB_val tx_id_value;
+    if (kth_db_cursor_get(cursor, &key, &tx_id_value, MDB_SET) != KTH_DB_SUCCESS) {
+        kth_db_cursor_close(cursor);
+        return {};
+    }
+
+    size_t tx_count;
+    if (kth_db_cursor_count(cursor, &tx_count) != KTH_DB_SUCCESS) {
+        kth_db_cursor_close(cursor);
+        return {};
+    }
+
+    auto const header = static_cast<uint8_t const*>(kth_db_get_data(value));
+    data_chunk data(header, header + header_size);
+    data.resize(header_size + infrastructure::message::variable_uint_size(tx_count));
+    auto serial = make_unsafe_serializer(data.begin() + header_size);
+    serial.write_size_little_endian(tx_count);
+
+    int rc = KTH_DB_SUCCESS;
+    while (rc == KTH_DB_SUCCESS) {
+        uint64_t tx_id;
+        std::memcpy(&tx_id, kth_db_get_data(tx_id_value), sizeof(tx_id));
+
+        auto tx_key = kth_db_make_value(sizeof(tx_id), &tx_id);
+        KTH_DB_val tx_value;
+        if (kth_db_get(db_txn, dbi_transaction_db_, &tx_key, &tx_value) != KTH_DB_SUCCESS) {
+            kth_db_cursor_close(cursor);
+            return {};
+        }
+
+        byte_span const entry(static_cast<uint8_t const*>(kth_db_get_data(tx_value)), kth_db_get_size(tx_value));
+        if ( ! transaction_entry::to_wire(entry, data)) {
+            kth_db_cursor_close(cursor);
+            return {};
+        }
+
+        rc = kth_db_cursor_get(cursor, &key, &tx_id_value, MDB_NEXT_DUP);
+    }
+
+    kth_db_cursor_close(cursor);
+    return data;
+}
+
 
 #if ! defined(KTH_DB_READONLY)
 
@@ -162,6 +317,36 @@ result_code internal_database_basis<Clock>::insert_block(domain::chain::block co
         }
     }
 
+    if (db_mode_ == db_mode_type::full || db_mode_ == db_mode_type::blocks) {
+        return insert_block_tx_hashes(block, height, db_txn);
+    }
+
+    return result_code::success;
+}
+
+template <typename Clock>
+result_code internal_database_basis<Clock>::insert_block_tx_hashes(domain::chain::block const& block, uint32_t height, KTH_DB_txn* db_txn) {
+    auto key = kth_db_make_value(sizeof(height), &height);
+
+    auto const& txs = block.transactions();
+    data_chunk data;
+    data.reserve(txs.size() * hash_size);
+    for (auto const& tx : txs) {
+        extend_data(data, tx.hash());
+    }
+
+    auto value = kth_db_make_value(data.size(), data.data());
+    auto res = kth_db_put(db_txn, dbi_block_tx_hashes_db_, &key, &value, KTH_DB_APPEND);
+    if (res == KTH_DB_KEYEXIST) {
+        spdlog::info("[database] Duplicate key in Block Tx Hashes DB [insert_block_tx_hashes] {}", res);
+        return result_code::duplicated_key;
+    }
+
+    if (res != KTH_DB_SUCCESS) {
+        spdlog::info("[database] Error saving in Block Tx Hashes DB [insert_block_tx_hashes] {}", res);
+        return result_code::other;
+    }
+
     return result_code::success;
 }
 
@@ -205,6 +390,15 @@ result_code internal_database_basis<Clock>::remove_blocks_db(uint32_t height, KT
         }
     }
 
+    if (db_mode_ == db_mode_type::full || db_mode_ == db_mode_type::blocks) {
+        // Blocks stored before the index was added have no entry.
+        auto res = kth_db_del(db_txn, dbi_block_tx_hashes_db_, &key, NULL);
+        if (res != KTH_DB_SUCCESS && res != KTH_DB_NOTFOUND) {
+            spdlog::info("[database] Error deleting block tx hashes DB in LMDB [remove_blocks_db] - kth_db_del: {}", res);
+            return result_code::other;
+        }
+    }
+
     return result_code::success;
 }
 
@@ -39,6 +39,7 @@
 #define kth_db_cursor_close mdb_cursor_close
 #define kth_db_cursor_get mdb_cursor_get
 #define kth_db_cursor_del mdb_cursor_del
+#define kth_db_cursor_count mdb_cursor_count
 #define kth_db_txn_abort mdb_txn_abort
 #define kth_db_dbi_close mdb_dbi_close
 #define kth_db_env_sync mdb_env_sync
@@ -53,6 +54,7 @@
 #define kth_db_cursor_open mdb_cursor_open
 #define kth_db_env_close mdb_env_close
 #define kth_db_del mdb_del
+#define kth_db_drop mdb_drop
 
 inline
 auto const& kth_db_get_data(KTH_DB_val const& x) {
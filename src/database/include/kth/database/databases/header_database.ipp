@@ -16,6 +16,14 @@ template <typename Clock>
 result_code internal_database_basis<Clock>::push_block_header(domain::chain::block const& block, uint32_t height, KTH_DB_txn* db_txn) {
 
     auto valuearr = to_data_with_abla_state(block);             //TODO(fernando): podría estar afuera de la DBTx
+    auto const& state = block.validation.state;
+    if (state) {
+        auto const& abla = state->abla_state();
+        pushed_headers_.push_back({block.header(), abla.block_size, abla.control_block_size, abla.elastic_buffer_size});
+    } else {
+        pushed_headers_.push_back({block.header(), 0, 0, 0});
+    }
+
     auto key = kth_db_make_value(sizeof(height), &height);
     auto value = kth_db_make_value(valuearr.size(), valuearr.data());
 
@@ -110,6 +118,7 @@ result_code internal_database_basis<Clock>::remove_block_header(hash_digest cons
         return result_code::other;
     }
 
+    ++popped_headers_;
     return result_code::success;
 }
 
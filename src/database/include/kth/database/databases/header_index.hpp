@@ -0,0 +1,82 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_DATABASE_HEADER_INDEX_HPP_
+#define KTH_DATABASE_HEADER_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <kth/domain.hpp>
+#include <kth/database/define.hpp>
+
+#include <kth/infrastructure/utility/thread.hpp>
+
+namespace kth::database {
+
+/// In-memory copy of the header chain, one contiguous entry per height, so
+/// that header, hash, height and chain state queries do not read the store.
+/// The store remains the source of truth, the index is loaded on open and
+/// follows each committed push/pop.
+/// This class is thread safe.
+struct KD_API header_index {
+    /// The header fields (the previous hash is the hash of height - 1), the
+    /// ABLA state after the block and the chain work up to the block.
+    struct entry {
+        hash_digest hash;
+        hash_digest merkle;
+        uint32_t version;
+        uint32_t timestamp;
+        uint32_t bits;
+        uint32_t nonce;
+        uint64_t block_size;
+        uint64_t control_block_size;
+        uint64_t elastic_buffer_size;
+        uint256_t work;
+    };
+
+    header_index() = default;
+
+    // Non-copyable, non-movable
+    header_index(header_index const&) = delete;
+    header_index& operator=(header_index const&) = delete;
+
+    bool empty() const;
+    size_t size() const;
+
+    /// The height of the last entry, if any.
+    std::optional<uint32_t> top() const;
+
+    std::optional<entry> get(uint32_t height) const;
+    std::optional<uint32_t> find(hash_digest const& hash) const;
+
+    /// The header at height (invalid if not indexed).
+    domain::chain::header get_header(uint32_t height) const;
+
+    /// The headers in [from, to], stops at the top.
+    domain::chain::header::list get_headers(uint32_t from, uint32_t to) const;
+
+    /// Append the header as the next height, false if it doesn't link to the
+    /// top (the index is left unchanged).
+    bool push(domain::chain::header const& header, uint64_t block_size, uint64_t control_block_size, uint64_t elastic_buffer_size);
+
+    /// Remove the top entry, if any.
+    void pop();
+    void clear();
+
+private:
+    domain::chain::header to_header(uint32_t height) const;
+
+    // These are protected by mutex_.
+    std::vector<entry> entries_;
+    std::unordered_multimap<uint64_t, uint32_t> heights_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace kth::database
+
+#endif // KTH_DATABASE_HEADER_INDEX_HPP_
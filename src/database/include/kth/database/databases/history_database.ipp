@@ -47,7 +47,7 @@ result_code internal_database_basis<Clock>::insert_input_history(domain::chain::
 
         // This results in a complete and unambiguous history for the
         // address since standard outputs contain unambiguous address data.
-        for (auto const& address : prevout.validation.cache.addresses()) {
+        for (auto const& address : prevout.validation.cache.get().addresses()) {
             auto valuearr = history_entry::factory_to_data(id, inpoint, domain::chain::point_kind::spend, height, inpoint.index(), prevout.checksum());
             auto res = insert_history_db(address, valuearr, db_txn);
             if (res != result_code::success) {
@@ -91,7 +91,30 @@ result_code internal_database_basis<Clock>::insert_input_history(domain::chain::
                 }
             }
             else {
-                spdlog::info("[database] Error finding UTXO for input history [insert_input_history]");
+                // The output is spent when indexed after the block (asynchronous indexes).
+                auto const tx_entry = get_transaction(prevout.hash(), max_uint32, db_txn);
+                if ( ! tx_entry.is_valid() || prevout.index() >= tx_entry.transaction().outputs().size()) {
+                    spdlog::info("[database] Error finding UTXO for input history [insert_input_history]");
+                    return result_code::success;
+                }
+
+                uint64_t history_count = get_history_count(db_txn);
+                if (history_count == max_uint64) {
+                    spdlog::info("[database] Error getting history items count");
+                    return result_code::other;
+                }
+
+                uint64_t id = history_count;
+
+                auto const& out_output = tx_entry.transaction().outputs()[prevout.index()];
+                for (auto const& address : out_output.addresses()) {
+                    auto valuearr = history_entry::factory_to_data(id, inpoint, domain::chain::point_kind::spend, height, inpoint.index(), prevout.checksum());
+                    auto res = insert_history_db(address, valuearr, db_txn);
+                    if (res != result_code::success) {
+                        return res;
+                    }
+                    ++id;
+                }
             }
     }
 
@@ -155,42 +178,51 @@ domain::chain::history_compact::list internal_database_basis<Clock>::get_history
         return result;
     }
 
-    auto key_hash = kth_db_make_value(key.size(), const_cast<short_hash&>(key).data());
-    KTH_DB_val value;
-    int rc;
-    if ((rc = kth_db_cursor_get(cursor, &key_hash, &value, MDB_SET)) == 0) {
-
-        auto data = db_value_to_data_chunk(value);
-        byte_reader reader1(data);
-        auto entry_res = history_entry::from_data(reader1);
-
-        if (entry_res && (from_height == 0 || entry_res->height() >= from_height)) {
-            result.push_back(history_entry_to_history_compact(*entry_res));
+    // The entries are decoded in the mapped memory, without copying.
+    auto rc = seek_history(cursor, key, from_height);
+    for (; rc == KTH_DB_SUCCESS && result.size() < limit; rc = next_history(cursor)) {
+        auto const entry = read_history(cursor);
+        if (entry) {
+            result.push_back(history_entry_to_history_compact(*entry));
         }
+    }
 
-        while ((rc = kth_db_cursor_get(cursor, &key_hash, &value, MDB_NEXT_DUP)) == 0) {
-
-            if (limit > 0 && result.size() >= limit) {
-                break;
-            }
+    kth_db_cursor_close(cursor);
+    kth_db_txn_commit(db_txn);
+    return result;
+}
 
-            auto data = db_value_to_data_chunk(value);
-            byte_reader reader2(data);
-            auto entry_res2 = history_entry::from_data(reader2);
+template <typename Clock>
+domain::chain::history_compact::list internal_database_basis<Clock>::get_latest_history(short_hash const& key, size_t limit, size_t to_height) const {
 
-            if (entry_res2 && (from_height == 0 || entry_res2->height() >= from_height)) {
-                result.push_back(history_entry_to_history_compact(*entry_res2));
-            }
+    domain::chain::history_compact::list result;
 
-        }
+    if (limit == 0) {
+        return result;
     }
 
-    kth_db_cursor_close(cursor);
+    KTH_DB_txn* db_txn;
+    auto res = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
+    if (res != KTH_DB_SUCCESS) {
+        return result;
+    }
 
-    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+    KTH_DB_cursor* cursor;
+    if (kth_db_cursor_open(db_txn, dbi_history_db_, &cursor) != KTH_DB_SUCCESS) {
+        kth_db_txn_commit(db_txn);
         return result;
     }
 
+    auto rc = seek_history_last(cursor, key, to_height);
+    for (; rc == KTH_DB_SUCCESS && result.size() < limit; rc = previous_history(cursor)) {
+        auto const entry = read_history(cursor);
+        if (entry) {
+            result.push_back(history_entry_to_history_compact(*entry));
+        }
+    }
+
+    kth_db_cursor_close(cursor);
+    kth_db_txn_commit(db_txn);
     return result;
 }
 
@@ -216,53 +248,83 @@ std::vector<hash_digest> internal_database_basis<Clock>::get_history_txns(short_
         return result;
     }
 
-    auto key_hash = kth_db_make_value(key.size(), const_cast<short_hash&>(key).data());;
-    KTH_DB_val value;
-    int rc;
-    if ((rc = kth_db_cursor_get(cursor, &key_hash, &value, MDB_SET)) == 0) {
-
-        auto data = db_value_to_data_chunk(value);
-        byte_reader reader3(data);
-        auto entry_res3 = history_entry::from_data(reader3);
-
-        if (entry_res3 && (from_height == 0 || entry_res3->height() >= from_height)) {
+    auto rc = seek_history(cursor, key, from_height);
+    for (; rc == KTH_DB_SUCCESS && result.size() < limit; rc = next_history(cursor)) {
+        auto const entry = read_history(cursor);
+        if (entry) {
             // Avoid inserting the same tx
-            auto const& pair = temp.insert(entry_res3->point().hash());
-            if (pair.second){
+            auto const& pair = temp.insert(entry->point().hash());
+            if (pair.second) {
                 // Add valid txns to the result vector
                 result.push_back(*pair.first);
             }
         }
+    }
 
-        while ((rc = kth_db_cursor_get(cursor, &key_hash, &value, MDB_NEXT_DUP)) == 0) {
-
-            if (limit > 0 && result.size() >= limit) {
-                break;
-            }
-
-            auto data = db_value_to_data_chunk(value);
-            byte_reader reader4(data);
-            auto entry_res4 = history_entry::from_data(reader4);
+    kth_db_cursor_close(cursor);
+    kth_db_txn_commit(db_txn);
+    return result;
+}
 
-            if (entry_res4 && (from_height == 0 || entry_res4->height() >= from_height)) {
-                // Avoid inserting the same tx
-                auto const& pair = temp.insert(entry_res4->point().hash());
-                if (pair.second){
-                    // Add valid txns to the result vector
-                    result.push_back(*pair.first);
-                }
-            }
+// private
+// Position the cursor on the first entry of the address at or above height.
+template <typename Clock>
+int internal_database_basis<Clock>::seek_history(KTH_DB_cursor* cursor, short_hash const& key, size_t height) const {
+    auto key_hash = kth_db_make_value(key.size(), const_cast<short_hash&>(key).data());
+    auto seek = history_entry::seek_data(uint32_t(std::min(height, size_t(max_uint32))));
+    auto value = kth_db_make_value(seek.size(), seek.data());
+    return kth_db_cursor_get(cursor, &key_hash, &value, MDB_GET_BOTH_RANGE);
+}
 
+// private
+// Position the cursor on the last entry of the address at or below height.
+template <typename Clock>
+int internal_database_basis<Clock>::seek_history_last(KTH_DB_cursor* cursor, short_hash const& key, size_t height) const {
+    if (height < max_uint32) {
+        auto const rc = seek_history(cursor, key, height + 1);
+        if (rc == KTH_DB_SUCCESS) {
+            return previous_history(cursor);
         }
     }
 
-    kth_db_cursor_close(cursor);
+    // Every entry of the address is at or below height (or none).
+    auto key_hash = kth_db_make_value(key.size(), const_cast<short_hash&>(key).data());
+    KTH_DB_val value;
+    auto const rc = kth_db_cursor_get(cursor, &key_hash, &value, MDB_SET);
+    if (rc != KTH_DB_SUCCESS) {
+        return rc;
+    }
+    return kth_db_cursor_get(cursor, &key_hash, &value, MDB_LAST_DUP);
+}
 
-    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
-        return result;
+// private
+template <typename Clock>
+int internal_database_basis<Clock>::next_history(KTH_DB_cursor* cursor) const {
+    KTH_DB_val key;
+    KTH_DB_val value;
+    return kth_db_cursor_get(cursor, &key, &value, MDB_NEXT_DUP);
+}
+
+// private
+template <typename Clock>
+int internal_database_basis<Clock>::previous_history(KTH_DB_cursor* cursor) const {
+    KTH_DB_val key;
+    KTH_DB_val value;
+    return kth_db_cursor_get(cursor, &key, &value, MDB_PREV_DUP);
+}
+
+// private
+template <typename Clock>
+expect<history_entry> internal_database_basis<Clock>::read_history(KTH_DB_cursor* cursor) const {
+    KTH_DB_val key;
+    KTH_DB_val value;
+    auto const rc = kth_db_cursor_get(cursor, &key, &value, MDB_GET_CURRENT);
+    if (rc != KTH_DB_SUCCESS) {
+        return std::unexpected(error::not_found);
     }
 
-    return result;
+    byte_reader reader(db_value_to_byte_span(value));
+    return history_entry::from_data(reader);
 }
 
 #if ! defined(KTH_DB_READONLY)
@@ -284,7 +346,7 @@ result_code internal_database_basis<Clock>::remove_transaction_history_db(domain
         auto const& prevout = input.previous_output();
 
         if (prevout.validation.cache.is_valid()) {
-            for (auto const& address : prevout.validation.cache.addresses()) {
+            for (auto const& address : prevout.validation.cache.get().addresses()) {
                 auto res = remove_history_db(address.hash20(), height, db_txn);
                 if (res != result_code::success) {
                     return res;
@@ -331,35 +393,18 @@ result_code internal_database_basis<Clock>::remove_history_db(short_hash const&
         return result_code::other;
     }
 
-    auto key_hash = kth_db_make_value(key.size(), const_cast<short_hash&>(key).data());;
-    KTH_DB_val value;
-    int rc;
-    if ((rc = kth_db_cursor_get(cursor, &key_hash, &value, MDB_SET)) == 0) {
-
-        auto data = db_value_to_data_chunk(value);
-        byte_reader reader5(data);
-        auto entry_res5 = history_entry::from_data(reader5);
-
-        if (entry_res5 && entry_res5->height() == height) {
-
-            if (kth_db_cursor_del(cursor, 0) != KTH_DB_SUCCESS) {
-                kth_db_cursor_close(cursor);
-                return result_code::other;
-            }
+    // The entries of the height are contiguous, seek again after each
+    // deletion (the cursor position after a delete is not relied on).
+    auto rc = seek_history(cursor, key, height);
+    for (; rc == KTH_DB_SUCCESS; rc = seek_history(cursor, key, height)) {
+        auto const entry = read_history(cursor);
+        if ( ! entry || entry->height() != height) {
+            break;
         }
 
-        while ((rc = kth_db_cursor_get(cursor, &key_hash, &value, MDB_NEXT_DUP)) == 0) {
-
-            auto data = db_value_to_data_chunk(value);
-            byte_reader reader6(data);
-            auto entry_res6 = history_entry::from_data(reader6);
-
-            if (entry_res6 && entry_res6->height() == height) {
-                if (kth_db_cursor_del(cursor, 0) != KTH_DB_SUCCESS) {
-                    kth_db_cursor_close(cursor);
-                    return result_code::other;
-                }
-            }
+        if (kth_db_cursor_del(cursor, 0) != KTH_DB_SUCCESS) {
+            kth_db_cursor_close(cursor);
+            return result_code::other;
         }
     }
 
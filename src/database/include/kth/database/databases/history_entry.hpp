@@ -5,6 +5,9 @@
 #ifndef KTH_DATABASE_HISTORY_ENTRY_HPP_
 #define KTH_DATABASE_HISTORY_ENTRY_HPP_
 
+#include <array>
+#include <cstddef>
+
 #include <kth/domain.hpp>
 #include <kth/database/define.hpp>
 
@@ -31,6 +34,16 @@ struct KD_API history_entry {
     static
     size_t serialized_size(domain::chain::point const& point);
 
+    /// The entries of an address are sorted by height and then by id, these
+    /// are the offsets of the fields in the serialized entry.
+    static constexpr size_t id_offset = 0;
+    static constexpr size_t height_offset = sizeof(uint64_t) + std::tuple_size<domain::chain::point>::value + sizeof(uint8_t);
+    static constexpr size_t fixed_size = height_offset + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t);
+
+    /// A serialized entry that sorts before every entry at height or above.
+    static
+    std::array<uint8_t, fixed_size> seek_data(uint32_t height);
+
     data_chunk to_data() const;
     void to_data(std::ostream& stream) const;
 
@@ -0,0 +1,364 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_DATABASE_INDEX_DATABASE_IPP_
+#define KTH_DATABASE_INDEX_DATABASE_IPP_
+
+#include <kth/infrastructure/log/source.hpp>
+
+namespace kth::database {
+
+// The history and spend tables (full mode) are written either by the block
+// writer, in the write transaction of the block, or by index_blocks, in its
+// own write transactions (asynchronous indexes). In both cases the height of
+// the last indexed block is kept in the properties table, so the reorg
+// removes the entries of the indexed blocks only and the indexes can catch up
+// (or be rebuilt, see the rebuild_indexes setting) at any time.
+
+//public
+template <typename Clock>
+bool internal_database_basis<Clock>::async_indexes() const {
+    return async_indexes_;
+}
+
+//public
+template <typename Clock>
+std::optional<uint32_t> internal_database_basis<Clock>::get_index_height(index_kind kind) const {
+    if (db_mode_ != db_mode_type::full) {
+        return std::nullopt;
+    }
+
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn) != KTH_DB_SUCCESS) {
+        return std::nullopt;
+    }
+
+    auto const height = get_index_height(kind, db_txn);
+    kth_db_txn_commit(db_txn);
+    return height;
+}
+
+#if ! defined(KTH_DB_READONLY)
+
+//public
+template <typename Clock>
+result_code internal_database_basis<Clock>::index_blocks(index_kind kind, uint32_t max_entries, uint32_t& out_indexed) {
+    out_indexed = 0;
+
+    if (db_mode_ != db_mode_type::full) {
+        return result_code::other;
+    }
+
+    // The blocks and the spent outputs are read before the write transaction
+    // begins, so the block writer only waits for the index entries.
+    KTH_DB_txn* db_txn;
+    auto res0 = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
+    if (res0 != KTH_DB_SUCCESS) {
+        spdlog::error("[database] Error begining LMDB Transaction [index_blocks] {}", res0);
+        return result_code::other;
+    }
+
+    auto const indexed = get_index_height(kind, db_txn);
+    auto const first = indexed ? *indexed + 1 : 0;
+
+    std::vector<domain::chain::block> blocks;
+    size_t entries = 0;
+    while (entries < max_entries) {
+        auto block = get_block(first + uint32_t(blocks.size()), db_txn);
+        if ( ! block.is_valid()) {
+            break;
+        }
+
+        entries += index_entries(kind, block);
+        if (kind == index_kind::history) {
+            cache_spent_outputs(block, db_txn);
+        }
+        blocks.push_back(std::move(block));
+    }
+
+    kth_db_txn_commit(db_txn);
+
+    if (blocks.empty()) {
+        return result_code::success;
+    }
+
+    res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
+    if (res0 != KTH_DB_SUCCESS) {
+        spdlog::error("[database] Error begining LMDB Transaction [index_blocks] {}", res0);
+        return result_code::other;
+    }
+
+    // A reorganization in between is retried with the next notification.
+    auto const last = first + uint32_t(blocks.size()) - 1;
+    if (get_index_height(kind, db_txn) != indexed || get_header(last, db_txn).hash() != blocks.back().hash()) {
+        kth_db_txn_abort(db_txn);
+        return result_code::success;
+    }
+
+    auto height = first;
+    for (auto const& block : blocks) {
+        auto const res = index_block(kind, block, height++, db_txn);
+        if (res != result_code::success) {
+            kth_db_txn_abort(db_txn);
+            return res;
+        }
+    }
+
+    auto res = write_index_height(kind, last, db_txn);
+    if (res != result_code::success) {
+        kth_db_txn_abort(db_txn);
+        return res;
+    }
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return result_code::other;
+    }
+
+    out_indexed = uint32_t(blocks.size());
+    return result_code::success;
+}
+
+//public
+template <typename Clock>
+result_code internal_database_basis<Clock>::reset_index(index_kind kind) {
+    if (db_mode_ != db_mode_type::full) {
+        return result_code::other;
+    }
+
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+        return result_code::other;
+    }
+
+    // Empty the table, keeping it open.
+    auto const dbi = kind == index_kind::history ? dbi_history_db_ : dbi_spend_db_;
+    if (kth_db_drop(db_txn, dbi, 0) != KTH_DB_SUCCESS) {
+        kth_db_txn_abort(db_txn);
+        return result_code::other;
+    }
+
+    if (write_index_height(kind, empty_index_height, db_txn) != result_code::success) {
+        kth_db_txn_abort(db_txn);
+        return result_code::other;
+    }
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return result_code::other;
+    }
+
+    return result_code::success;
+}
+
+#endif // ! defined(KTH_DB_READONLY)
+
+// private
+template <typename Clock>
+// static
+property_code internal_database_basis<Clock>::index_property(index_kind kind) {
+    return kind == index_kind::history ? property_code::history_index : property_code::spend_index;
+}
+
+// private
+template <typename Clock>
+bool internal_database_basis<Clock>::inline_indexes() const {
+    return db_mode_ == db_mode_type::full && ! async_indexes_;
+}
+
+// private
+template <typename Clock>
+std::optional<uint32_t> internal_database_basis<Clock>::get_index_height(index_kind kind, KTH_DB_txn* db_txn) const {
+    auto code = index_property(kind);
+    auto key = kth_db_make_value(sizeof(code), &code);
+    KTH_DB_val value;
+
+    if (kth_db_get(db_txn, dbi_properties_, &key, &value) != KTH_DB_SUCCESS || kth_db_get_size(value) != sizeof(uint32_t)) {
+        return std::nullopt;
+    }
+
+    uint32_t height;
+    std::memcpy(&height, kth_db_get_data(value), sizeof(height));
+    if (height == empty_index_height) {
+        return std::nullopt;
+    }
+    return height;
+}
+
+#if ! defined(KTH_DB_READONLY)
+
+// private
+template <typename Clock>
+result_code internal_database_basis<Clock>::write_index_height(index_kind kind, uint32_t height, KTH_DB_txn* db_txn) {
+    auto code = index_property(kind);
+    auto key = kth_db_make_value(sizeof(code), &code);
+    auto value = kth_db_make_value(sizeof(height), &height);
+
+    auto res = kth_db_put(db_txn, dbi_properties_, &key, &value, 0);
+    if (res != KTH_DB_SUCCESS) {
+        spdlog::info("[database] Error saving the index height [write_index_height] {}", res);
+        return result_code::other;
+    }
+
+    return result_code::success;
+}
+
+// private
+// The entries of the block at height were removed (reorganization).
+template <typename Clock>
+result_code internal_database_basis<Clock>::unindex_height(index_kind kind, uint32_t height, KTH_DB_txn* db_txn) {
+    return write_index_height(kind, height == 0 ? empty_index_height : height - 1, db_txn);
+}
+
+// private
+// Same entries, and in the same order, as written by the block writer:
+// the outputs of every transaction first, then the inputs.
+template <typename Clock>
+result_code internal_database_basis<Clock>::index_block(index_kind kind, domain::chain::block const& block, uint32_t height, KTH_DB_txn* db_txn) {
+    auto const& txs = block.transactions();
+
+    if (kind == index_kind::history) {
+        for (auto const& tx : txs) {
+            auto const tx_hash = tx.hash();
+            uint32_t pos = 0;
+            for (auto const& output : tx.outputs()) {
+                auto res = insert_output_history(tx_hash, height, pos, output, db_txn);
+                if (res != result_code::success) {
+                    return res;
+                }
+                ++pos;
+            }
+        }
+    }
+
+    for (auto it = txs.begin() + 1; it != txs.end(); ++it) {
+        auto const tx_hash = it->hash();
+        uint32_t pos = 0;
+        for (auto const& input : it->inputs()) {
+            domain::chain::input_point const inpoint {tx_hash, pos};
+            auto res = kind == index_kind::history
+                ? insert_input_history(inpoint, height, input, db_txn)
+                : insert_spend(input.previous_output(), inpoint, db_txn);
+            if (res != result_code::success) {
+                return res;
+            }
+            ++pos;
+        }
+    }
+
+    return result_code::success;
+}
+
+// private
+// The history entries are the outputs and the inputs, the spend entries the
+// inputs (the coinbase input is not indexed).
+template <typename Clock>
+// static
+size_t internal_database_basis<Clock>::index_entries(index_kind kind, domain::chain::block const& block) {
+    auto const& txs = block.transactions();
+    auto const inputs = std::accumulate(txs.begin() + 1, txs.end(), size_t(0), [](size_t total, domain::chain::transaction const& tx) {
+        return total + tx.inputs().size();
+    });
+
+    if (kind == index_kind::spend) {
+        return inputs;
+    }
+
+    return std::accumulate(txs.begin(), txs.end(), inputs, [](size_t total, domain::chain::transaction const& tx) {
+        return total + tx.outputs().size();
+    });
+}
+
+// private
+// The outputs spent by the block, as insert_input_history would look them up.
+template <typename Clock>
+void internal_database_basis<Clock>::cache_spent_outputs(domain::chain::block const& block, KTH_DB_txn* db_txn) const {
+    auto const& txs = block.transactions();
+    for (auto it = txs.begin() + 1; it != txs.end(); ++it) {
+        for (auto const& input : it->inputs()) {
+            auto const& prevout = input.previous_output();
+            if (prevout.validation.cache.is_valid()) {
+                continue;
+            }
+
+            auto const entry = get_utxo(prevout, db_txn);
+            if (entry.is_valid()) {
+                prevout.validation.cache = entry.shared_output();
+                continue;
+            }
+
+            // The output is spent when indexed after the block.
+            auto const tx_entry = get_transaction(prevout.hash(), max_uint32, db_txn);
+            if (tx_entry.is_valid() && prevout.index() < tx_entry.transaction().outputs().size()) {
+                prevout.validation.cache = domain::chain::prevout_cache(tx_entry.transaction().outputs()[prevout.index()]);
+            }
+        }
+    }
+}
+
+// private
+// A store written before the index heights were kept is indexed up to the
+// top. The block writer catches up (synchronously) an index left behind by a
+// previous run with asynchronous indexes.
+template <typename Clock>
+bool internal_database_basis<Clock>::load_index_heights() {
+    if (db_mode_ != db_mode_type::full) {
+        return true;
+    }
+
+    uint32_t top;
+    if (get_last_height(top) != result_code::success) {
+        return true;
+    }
+
+    if (rebuild_indexes_) {
+        spdlog::info("[database] Rebuilding the history and spend indexes.");
+        if (reset_index(index_kind::history) != result_code::success || reset_index(index_kind::spend) != result_code::success) {
+            return false;
+        }
+    }
+
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    for (auto const kind : {index_kind::history, index_kind::spend}) {
+        auto code = index_property(kind);
+        auto key = kth_db_make_value(sizeof(code), &code);
+        KTH_DB_val value;
+        if (kth_db_get(db_txn, dbi_properties_, &key, &value) == KTH_DB_NOTFOUND && write_index_height(kind, top, db_txn) != result_code::success) {
+            kth_db_txn_abort(db_txn);
+            return false;
+        }
+    }
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    if (async_indexes_) {
+        return true;
+    }
+
+    for (auto const kind : {index_kind::history, index_kind::spend}) {
+        auto const height = get_index_height(kind);
+        if (height && *height < top) {
+            spdlog::info("[database] Indexing blocks {} to {}, please wait...", *height + 1, top);
+        }
+
+        uint32_t indexed;
+        do {
+            if (index_blocks(kind, index_entries_per_load, indexed) != result_code::success) {
+                return false;
+            }
+        } while (indexed > 0);
+    }
+
+    return true;
+}
+
+#endif // ! defined(KTH_DB_READONLY)
+
+} // namespace kth::database
+
+#endif // KTH_DATABASE_INDEX_DATABASE_IPP_
@@ -5,7 +5,12 @@
 #ifndef KTH_DATABASE_INTERNAL_DATABASE_HPP_
 #define KTH_DATABASE_INTERNAL_DATABASE_HPP_
 
+#include <chrono>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/interprocess/mapped_region.hpp>
@@ -20,10 +25,13 @@
 #include <kth/database/define.hpp>
 
 #include <kth/database/databases/header_abla_entry.hpp>
+#include <kth/database/databases/header_index.hpp>
 #include <kth/database/databases/result_code.hpp>
 #include <kth/database/databases/property_code.hpp>
 #include <kth/database/databases/tools.hpp>
+#include <kth/database/databases/utxo_cache.hpp>
 #include <kth/database/databases/utxo_entry.hpp>
+#include <kth/database/databases/utxo_snapshot.hpp>
 #include <kth/database/databases/history_entry.hpp>
 #include <kth/database/databases/transaction_entry.hpp>
 #include <kth/database/databases/transaction_unconfirmed_entry.hpp>
@@ -50,13 +58,19 @@
 
 namespace kth::database {
 
-constexpr size_t max_dbs_full_ = 13;        // KTH_DB_NEW_FULL
-constexpr size_t max_dbs_blocks_ = 8;      // KTH_DB_NEW_BLOCKS
-constexpr size_t max_dbs_pruned_ = 7;       // KTH_DB_NEW_PRUNED
+constexpr size_t max_dbs_full_ = 15;        // KTH_DB_NEW_FULL
+constexpr size_t max_dbs_blocks_ = 10;     // KTH_DB_NEW_BLOCKS
+constexpr size_t max_dbs_pruned_ = 8;       // KTH_DB_NEW_PRUNED
 
 constexpr size_t env_open_mode_ = 0664;
 constexpr int directory_exists = 0;
 
+// Index height property of an empty index.
+constexpr uint32_t empty_index_height = max_uint32;
+
+// Index entries written in each write transaction of the synchronous catch up.
+constexpr uint32_t index_entries_per_load = 100000;
+
 template <typename Clock = std::chrono::system_clock>
 struct KD_API internal_database_basis {
     using path = kth::path;
@@ -69,9 +83,11 @@ struct KD_API internal_database_basis {
     constexpr static char reorg_index_name[] = "reorg_index";
     constexpr static char reorg_block_name[] = "reorg_block";
     constexpr static char db_properties_name[] = "properties";
+    constexpr static char utxo_set_hash_name[] = "utxo_set_hash";
 
     //Blocks DB
     constexpr static char block_db_name[] = "blocks";
+    constexpr static char block_tx_hashes_db_name[] = "block_tx_hashes";
 
     //Transactions
     constexpr static char transaction_db_name[] = "transactions";
@@ -80,7 +96,9 @@ struct KD_API internal_database_basis {
     constexpr static char spend_db_name[] = "spend";
     constexpr static char transaction_unconfirmed_db_name[] = "transaction_unconfirmed";
 
-    internal_database_basis(path const& db_dir, db_mode_type mode, uint32_t reorg_pool_limit, uint64_t db_max_size, bool safe_mode);
+    internal_database_basis(path const& db_dir, db_mode_type mode, uint32_t reorg_pool_limit, uint64_t db_max_size, bool safe_mode, uint32_t cache_capacity = 0,
+                            uint32_t batch_blocks = 0, uint64_t batch_size = 0, uint32_t batch_interval = 0, bool async_indexes = false, uint64_t cache_size = 0,
+                            bool rebuild_indexes = false);
     ~internal_database_basis();
 
     // Non-copyable, non-movable
@@ -100,10 +118,41 @@ struct KD_API internal_database_basis {
     //TODO(fernando): optimization: consider passing a list of outputs to insert and a list of inputs to delete instead of an entire Block.
     //                  avoiding inserting and erasing internal spenders
     result_code push_block(domain::chain::block const& block, uint32_t height, uint32_t median_time_past);
+
+    /// Push an old block (initial block download) as part of a batch, the
+    /// batch is committed in a single write transaction once it reaches the
+    /// configured blocks/size/interval. Recent blocks are pushed directly.
+    /// If the commit fails the whole batch is dropped, none of its blocks
+    /// (this one included) are stored.
+    result_code import_block(std::shared_ptr<domain::chain::block const> block, uint32_t height, uint32_t median_time_past);
+
+    /// Commit the batched blocks, if any.
+    result_code flush_batch();
+
+    /// Commit the batched blocks if the batch is older than the flush
+    /// interval, flushed is set if any block was committed.
+    result_code flush_expired_batch(bool& flushed);
+
+    /// True if the block at height is batched but not committed yet.
+    bool is_batched(uint32_t height) const;
 #endif
 
     utxo_entry get_utxo(domain::chain::output_point const& point) const;
 
+    /// The in-memory unspent outputs cache (hit/miss counters).
+    utxo_cache const& get_utxo_cache() const;
+
+    /// The in-memory header chain (empty if not loaded, i.e. read only).
+    header_index const& get_header_index() const;
+
+    /// The multiset hash (ECMH) of the unspent outputs at the top, each
+    /// output hashed as its stored key and value (see utxo_snapshot.hpp).
+    std::optional<hash_digest> get_utxo_set_hash() const;
+
+    /// The multiset hash of the unspent outputs at height, available for the
+    /// top and for the blocks in the reorg pool.
+    std::optional<hash_digest> get_utxo_set_hash(uint32_t height) const;
+
     result_code get_last_height(uint32_t& out_height) const;
 
     std::pair<domain::chain::header, uint32_t> get_header(hash_digest const& hash) const;
@@ -124,11 +173,28 @@ struct KD_API internal_database_basis {
     std::pair<domain::chain::block, uint32_t> get_block(hash_digest const& hash) const;
     domain::chain::block get_block(uint32_t height) const;
 
+    /// The block in the wire format, read from the store without building the
+    /// block and transaction objects (empty if not found).
+    std::pair<data_chunk, uint32_t> get_block_data(hash_digest const& hash) const;
+    data_chunk get_block_data(uint32_t height) const;
+
+    /// The hashes of the transactions of the block, in block order, read
+    /// without the transactions (empty if not found or not indexed).
+    hash_list get_block_tx_hashes(uint32_t height) const;
+
     transaction_entry get_transaction(hash_digest const& hash, size_t fork_height) const;
 
+    /// The height and the position in its block of a confirmed transaction,
+    /// read without the transaction.
+    result_code get_transaction_position(hash_digest const& hash, uint32_t& out_height, uint32_t& out_position) const;
+
     domain::chain::history_compact::list get_history(short_hash const& key, size_t limit, size_t from_height) const;
     std::vector<hash_digest> get_history_txns(short_hash const& key, size_t limit, size_t from_height) const;
 
+    /// The latest entries of the address first, at or below to_height (for
+    /// pages going back in time).
+    domain::chain::history_compact::list get_latest_history(short_hash const& key, size_t limit, size_t to_height) const;
+
     domain::chain::input_point get_spend(domain::chain::output_point const& point) const;
 
     std::vector<transaction_unconfirmed_entry> get_all_transaction_unconfirmed() const;
@@ -139,14 +205,52 @@ struct KD_API internal_database_basis {
     result_code push_transaction_unconfirmed(domain::chain::transaction const& tx, uint32_t height);
 #endif // ! defined(KTH_DB_READONLY)
 
+    /// True if the history and spend tables (full mode) are written by
+    /// index_blocks instead of the block writer.
+    bool async_indexes() const;
+
+    /// The height of the last block in the index (full mode), nullopt if
+    /// nothing is indexed.
+    std::optional<uint32_t> get_index_height(index_kind kind) const;
+
+#if ! defined(KTH_DB_READONLY)
+    /// Index the blocks above the index height, up to about max_entries index
+    /// entries (at least one block), in a single write transaction. The blocks
+    /// are read before it begins. out_indexed is zero when the index is up to
+    /// date or a reorganization raced the read.
+    result_code index_blocks(index_kind kind, uint32_t max_entries, uint32_t& out_indexed);
+
+    /// Empty the index, to be rebuilt by index_blocks (on open if the
+    /// rebuild_indexes setting is set).
+    result_code reset_index(index_kind kind);
+#endif // ! defined(KTH_DB_READONLY)
+
+    /// Write the block headers and the unspent outputs to a snapshot file,
+    /// in a single read transaction (see utxo_snapshot.hpp).
+    result_code export_utxo_snapshot(path const& file) const;
+
+#if ! defined(KTH_DB_READONLY)
+    /// Load a snapshot file into a new (empty) pruned database, checking the
+    /// header chain (from genesis_hash, proof of work and checkpoints) and the
+    /// utxo commitment against the trusted values.
+    /// The database does not open until the import completes.
+    result_code import_utxo_snapshot(path const& file, hash_digest const& genesis_hash, utxo_snapshot_trust const& trust);
+#endif // ! defined(KTH_DB_READONLY)
+
 private:
 
 #if ! defined(KTH_DB_READONLY)
     bool create_db_mode_property();
+
+    bool create_snapshot_import_property(uint32_t height);
+
+    bool remove_snapshot_import_property();
 #endif
 
     bool verify_db_mode_property() const;
 
+    bool verify_snapshot_import_property() const;
+
     bool open_internal();
 
     bool is_old_block(domain::chain::block const& block) const;
@@ -159,10 +263,54 @@ private:
 
     bool open_databases();
 
+    bool load_header_index();
+
+    std::optional<multiset> read_utxo_set(KTH_DB_dbi dbi, uint32_t key, KTH_DB_txn* db_txn) const;
+
     utxo_entry get_utxo(domain::chain::output_point const& point, KTH_DB_txn* db_txn) const;
 
 #if ! defined(KTH_DB_READONLY)
-    result_code insert_reorg_pool(uint32_t height, KTH_DB_val& key, KTH_DB_txn* db_txn);
+    /// Writes are serialized, the deltas are shared by the write in progress.
+    template <typename F>
+    result_code write_deltas(F f);
+
+    bool batch_full() const;
+
+    result_code commit_batch();
+
+    result_code write_batch_utxos(KTH_DB_txn* db_txn);
+
+    result_code insert_reorg_pool(uint32_t height, KTH_DB_val& key, KTH_DB_val& value, KTH_DB_txn* db_txn);
+
+    result_code import_snapshot_chunks(utxo_snapshot_reader& reader, utxo_snapshot_header const& header, hash_digest const& genesis_hash, utxo_snapshot_trust const& trust);
+
+    void clear_snapshot_tables();
+
+    bool load_utxo_set();
+
+    result_code write_utxo_set(uint32_t height, bool by_height, KTH_DB_txn* db_txn);
+
+    result_code remove_utxo_set(uint32_t height, KTH_DB_txn* db_txn);
+#endif
+
+    static property_code index_property(index_kind kind);
+
+    bool inline_indexes() const;
+
+    std::optional<uint32_t> get_index_height(index_kind kind, KTH_DB_txn* db_txn) const;
+
+#if ! defined(KTH_DB_READONLY)
+    bool load_index_heights();
+
+    result_code write_index_height(index_kind kind, uint32_t height, KTH_DB_txn* db_txn);
+
+    result_code unindex_height(index_kind kind, uint32_t height, KTH_DB_txn* db_txn);
+
+    result_code index_block(index_kind kind, domain::chain::block const& block, uint32_t height, KTH_DB_txn* db_txn);
+
+    static size_t index_entries(index_kind kind, domain::chain::block const& block);
+
+    void cache_spent_outputs(domain::chain::block const& block, KTH_DB_txn* db_txn) const;
 
     result_code remove_utxo(uint32_t height, domain::chain::output_point const& point, bool insert_reorg, KTH_DB_txn* db_txn);
 
@@ -240,9 +388,13 @@ private:
 
     domain::chain::block get_block(hash_digest const& hash, KTH_DB_txn* db_txn) const;
 
+    data_chunk get_block_data(uint32_t height, KTH_DB_txn* db_txn) const;
+
 #if ! defined(KTH_DB_READONLY)
     result_code insert_block(domain::chain::block const& block, uint32_t height, uint64_t tx_count, KTH_DB_txn* db_txn);
 
+    result_code insert_block_tx_hashes(domain::chain::block const& block, uint32_t height, KTH_DB_txn* db_txn);
+
     result_code remove_transactions(domain::chain::block const& block, uint32_t height, KTH_DB_txn* db_txn);
 
     result_code insert_transaction(uint64_t id, domain::chain::transaction const& tx, uint32_t height, uint32_t median_time_past, uint32_t position , KTH_DB_txn* db_txn);
@@ -300,6 +452,16 @@ private:
 
     uint64_t get_history_count(KTH_DB_txn* db_txn) const;
 
+    int seek_history(KTH_DB_cursor* cursor, short_hash const& key, size_t height) const;
+
+    int seek_history_last(KTH_DB_cursor* cursor, short_hash const& key, size_t height) const;
+
+    int next_history(KTH_DB_cursor* cursor) const;
+
+    int previous_history(KTH_DB_cursor* cursor) const;
+
+    expect<history_entry> read_history(KTH_DB_cursor* cursor) const;
+
 // Data members ----------------------------
     path const db_dir_;
     uint32_t reorg_pool_limit_;                 //TODO(fernando): check if uint32_max is needed for NO-LIMIT???
@@ -307,10 +469,62 @@ private:
     bool env_created_ = false;
     bool db_opened_ = false;
     db_mode_type db_mode_;
+    bool const async_indexes_;
+    bool const rebuild_indexes_;
     uint64_t db_max_size_;
     bool safe_mode_;
     //bool fast_mode = false;
 
+    // Held by write_deltas for the whole write. The deltas below and the
+    // pending multiset are only used by the write in progress.
+    std::mutex write_mutex_;
+
+    // Committed utxo changes are applied to the cache after each write.
+    mutable utxo_cache utxo_cache_;
+    utxo_cache::delta utxo_delta_;
+
+    // Committed headers are applied to the index after each write.
+    struct pushed_header {
+        domain::chain::header header;
+        uint64_t block_size;
+        uint64_t control_block_size;
+        uint64_t elastic_buffer_size;
+    };
+
+    header_index header_index_;
+    std::vector<pushed_header> pushed_headers_;
+    size_t popped_headers_ = 0;
+
+    // Set once the index is out of sync, it stays empty until reloaded.
+    bool header_index_disabled_ = false;
+
+    // Initial block download batching.
+    struct batched_block {
+        std::shared_ptr<domain::chain::block const> block;
+        uint32_t height;
+        uint32_t median_time_past;
+    };
+
+    uint32_t const batch_blocks_;
+    uint64_t const batch_size_;
+    std::chrono::seconds const batch_interval_;
+
+    // These are protected by batch_mutex_.
+    std::vector<batched_block> batch_;
+    uint64_t batch_bytes_ = 0;
+    std::chrono::steady_clock::time_point batch_start_;
+    mutable std::mutex batch_mutex_;
+
+    // Outputs created while committing a batch, written at the end unless
+    // spent by a later block of the same batch.
+    std::unordered_map<domain::chain::point, data_chunk> batch_utxos_;
+    bool batching_utxos_ = false;
+
+    // Multiset of the unspent outputs, the committed one and the one of the
+    // write in progress (only used by the writer).
+    multiset utxo_set_;
+    multiset utxo_set_pending_;
+
     KTH_DB_env* env_;
     KTH_DB_dbi dbi_block_header_;
     KTH_DB_dbi dbi_block_header_by_hash_;
@@ -333,9 +547,19 @@ private:
 
     KTH_DB_dbi dbi_properties_;
 
+    KTH_DB_dbi dbi_utxo_set_hash_;
+    // dbi_utxo_set_hash_ structure:
+    //  key: height (blocks in the reorg pool)
+    //  value: utxo multiset after the block
+
     // Blocks DB
     KTH_DB_dbi dbi_block_db_;
 
+    KTH_DB_dbi dbi_block_tx_hashes_db_;
+    // dbi_block_tx_hashes_db_ structure:
+    //  key: height
+    //  value: the transaction hashes (32 bytes each), in block order
+
     // Transactions DB
     KTH_DB_dbi dbi_transaction_db_;
     KTH_DB_dbi dbi_transaction_hash_db_;
@@ -365,9 +589,14 @@ constexpr char internal_database_basis<Clock>::reorg_block_name[];
 template <typename Clock>
 constexpr char internal_database_basis<Clock>::db_properties_name[];             //key: propery, value: data
 
+template <typename Clock>
+constexpr char internal_database_basis<Clock>::utxo_set_hash_name[];              //key: block height, value: utxo multiset
+
 template <typename Clock>
 constexpr char internal_database_basis<Clock>::block_db_name[];                  //key: block height, value: block
-                                                                                 //key: block height, value: tx hashes
+
+template <typename Clock>
+constexpr char internal_database_basis<Clock>::block_tx_hashes_db_name[];        //key: block height, value: tx hashes
 template <typename Clock>
 constexpr char internal_database_basis<Clock>::transaction_db_name[];            //key: tx hash, value: tx
 
@@ -391,6 +620,7 @@ using internal_database = internal_database_basis<std::chrono::system_clock>;
 #include <kth/database/databases/block_database.ipp>
 #include <kth/database/databases/header_database.ipp>
 #include <kth/database/databases/history_database.ipp>
+#include <kth/database/databases/index_database.ipp>
 #include <kth/database/databases/spend_database.ipp>
 #include <kth/database/databases/transaction_unconfirmed_database.ipp>
 #include <kth/database/databases/internal_database.ipp>
@@ -8,18 +8,28 @@
 // #include <kth/infrastructure.hpp>
 #include <kth/infrastructure/log/source.hpp>
 
+#include <fstream>
+
 namespace kth::database {
 
 using utxo_pool_t = std::unordered_map<domain::chain::point, utxo_entry>;
 
 template <typename Clock>
-internal_database_basis<Clock>::internal_database_basis(path const& db_dir, db_mode_type mode, uint32_t reorg_pool_limit, uint64_t db_max_size, bool safe_mode)
+internal_database_basis<Clock>::internal_database_basis(path const& db_dir, db_mode_type mode, uint32_t reorg_pool_limit, uint64_t db_max_size, bool safe_mode, uint32_t cache_capacity,
+                                                        uint32_t batch_blocks, uint64_t batch_size, uint32_t batch_interval, bool async_indexes, uint64_t cache_size,
+                                                        bool rebuild_indexes)
     : db_dir_(db_dir)
     , db_mode_(mode)
+    , async_indexes_(async_indexes && mode == db_mode_type::full)
+    , rebuild_indexes_(rebuild_indexes && mode == db_mode_type::full)
     , reorg_pool_limit_(reorg_pool_limit)
     , limit_(blocks_to_seconds(reorg_pool_limit))
     , db_max_size_(db_max_size)
     , safe_mode_(safe_mode)
+    , utxo_cache_(cache_capacity, cache_size)
+    , batch_blocks_(batch_blocks)
+    , batch_size_(batch_size)
+    , batch_interval_(batch_interval)
 {}
 
 template <typename Clock>
@@ -84,6 +94,43 @@ bool internal_database_basis<Clock>::create_db_mode_property() {
     return true;
 }
 
+template <typename Clock>
+bool internal_database_basis<Clock>::create_snapshot_import_property(uint32_t height) {
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    auto code = property_code::snapshot_import;
+    auto key = kth_db_make_value(sizeof(code), &code);
+    auto value = kth_db_make_value(sizeof(height), &height);
+
+    if (kth_db_put(db_txn, dbi_properties_, &key, &value, KTH_DB_NOOVERWRITE) != KTH_DB_SUCCESS) {
+        kth_db_txn_abort(db_txn);
+        return false;
+    }
+
+    return kth_db_txn_commit(db_txn) == KTH_DB_SUCCESS;
+}
+
+template <typename Clock>
+bool internal_database_basis<Clock>::remove_snapshot_import_property() {
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    auto code = property_code::snapshot_import;
+    auto key = kth_db_make_value(sizeof(code), &code);
+
+    if (kth_db_del(db_txn, dbi_properties_, &key, NULL) != KTH_DB_SUCCESS) {
+        kth_db_txn_abort(db_txn);
+        return false;
+    }
+
+    return kth_db_txn_commit(db_txn) == KTH_DB_SUCCESS;
+}
+
 #endif // ! defined(KTH_DB_READONLY)
 
 
@@ -100,6 +147,63 @@ bool internal_database_basis<Clock>::open() {
         return false;
     }
 
+    ret = verify_snapshot_import_property();
+    if ( ! ret ) {
+        return false;
+    }
+
+#if ! defined(KTH_DB_READONLY)
+    // A read only process does not see the writes, it reads the store.
+    return load_header_index() && load_utxo_set() && load_index_heights();
+#else
+    return true;
+#endif
+}
+
+template <typename Clock>
+bool internal_database_basis<Clock>::load_header_index() {
+    header_index_.clear();
+    header_index_disabled_ = false;
+
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    KTH_DB_cursor* cursor;
+    if (kth_db_cursor_open(db_txn, dbi_block_header_, &cursor) != KTH_DB_SUCCESS) {
+        kth_db_txn_commit(db_txn);
+        return false;
+    }
+
+    KTH_DB_val key;
+    KTH_DB_val value;
+    auto result = true;
+    auto rc = kth_db_cursor_get(cursor, &key, &value, KTH_DB_FIRST);
+
+    for (; rc == KTH_DB_SUCCESS; rc = kth_db_cursor_get(cursor, &key, &value, KTH_DB_NEXT)) {
+        auto const height = *static_cast<uint32_t*>(kth_db_get_data(key));
+        auto const data = db_value_to_data_chunk(value);
+        byte_reader reader(data);
+        auto const entry = get_header_and_abla_state_from_data(reader);
+
+        if (height != header_index_.size() || ! entry ||
+            ! header_index_.push(std::get<0>(*entry), std::get<1>(*entry), std::get<2>(*entry), std::get<3>(*entry))) {
+            spdlog::error("[database] Inconsistent block header at height {} [load_header_index]", height);
+            result = false;
+            break;
+        }
+    }
+
+    kth_db_cursor_close(cursor);
+    kth_db_txn_commit(db_txn);
+
+    if ( ! result) {
+        header_index_.clear();
+        return false;
+    }
+
+    spdlog::info("[database] Loaded {} block headers into memory.", header_index_.size());
     return true;
 }
 
@@ -151,9 +255,38 @@ bool internal_database_basis<Clock>::verify_db_mode_property() const {
     return true;
 }
 
+// A snapshot import in progress (or interrupted) leaves the property.
+template <typename Clock>
+bool internal_database_basis<Clock>::verify_snapshot_import_property() const {
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    auto code = property_code::snapshot_import;
+    auto key = kth_db_make_value(sizeof(code), &code);
+    KTH_DB_val value;
+
+    auto const res = kth_db_get(db_txn, dbi_properties_, &key, &value);
+    if (res == KTH_DB_NOTFOUND) {
+        return kth_db_txn_commit(db_txn) == KTH_DB_SUCCESS;
+    }
+
+    if (res == KTH_DB_SUCCESS) {
+        auto const height = *static_cast<uint32_t*>(kth_db_get_data(value));
+        spdlog::error("[database] The snapshot import at height {} did not complete, remove the database directory and import again [verify_snapshot_import_property]", height);
+    }
+
+    kth_db_txn_abort(db_txn);
+    return false;
+}
+
 template <typename Clock>
 bool internal_database_basis<Clock>::close() {
     if (db_opened_) {
+#if ! defined(KTH_DB_READONLY)
+        flush_batch();
+#endif
 
         //TODO(fernando): check sync
         //Force synchronous flush (use with KTH_DB_NOSYNC or MDB_NOMETASYNC, with other flags do nothing)
@@ -165,9 +298,11 @@ bool internal_database_basis<Clock>::close() {
         kth_db_dbi_close(env_, dbi_reorg_index_);
         kth_db_dbi_close(env_, dbi_reorg_block_);
         kth_db_dbi_close(env_, dbi_properties_);
+        kth_db_dbi_close(env_, dbi_utxo_set_hash_);
 
         if (db_mode_ == db_mode_type::blocks || db_mode_ == db_mode_type::full) {
             kth_db_dbi_close(env_, dbi_block_db_);
+            kth_db_dbi_close(env_, dbi_block_tx_hashes_db_);
         }
 
         if (db_mode_ == db_mode_type::full) {
@@ -180,6 +315,8 @@ bool internal_database_basis<Clock>::close() {
         db_opened_ = false;
     }
 
+    header_index_.clear();
+
     if (env_created_) {
         kth_db_env_close(env_);
         env_created_ = false;
@@ -192,52 +329,267 @@ bool internal_database_basis<Clock>::close() {
 
 template <typename Clock>
 result_code internal_database_basis<Clock>::push_genesis(domain::chain::block const& block) {
+    return write_deltas([&]() {
+        KTH_DB_txn* db_txn;
+        auto res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
+        if (res0 != KTH_DB_SUCCESS) {
+            return result_code::other;
+        }
 
-    KTH_DB_txn* db_txn;
-    auto res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
-    if (res0 != KTH_DB_SUCCESS) {
-        return result_code::other;
-    }
+        auto res = push_genesis(block, db_txn);
+        if ( !  succeed(res)) {
+            kth_db_txn_abort(db_txn);
+            return res;
+        }
 
-    auto res = push_genesis(block, db_txn);
-    if ( !  succeed(res)) {
-        kth_db_txn_abort(db_txn);
+        auto res2 = kth_db_txn_commit(db_txn);
+        if (res2 != KTH_DB_SUCCESS) {
+            return result_code::other;
+        }
         return res;
+    });
+}
+
+//TODO(fernando): optimization: consider passing a list of outputs to insert and a list of inputs to delete instead of an entire Block.
+//                  avoiding inserting and erasing internal spenders
+
+template <typename Clock>
+result_code internal_database_basis<Clock>::push_block(domain::chain::block const& block, uint32_t height, uint32_t median_time_past) {
+    // Blocks are pushed in order, the batched ones go first. A failed batch
+    // is logged and dropped, it is not a failure of this block.
+    flush_batch();
+
+    return write_deltas([&]() {
+        KTH_DB_txn* db_txn;
+        auto res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
+        if (res0 != KTH_DB_SUCCESS) {
+            spdlog::error("[database] Error begining LMDB Transaction [push_block] {}", res0);
+            return result_code::other;
+        }
+
+        //TODO: save reorg blocks after the last checkpoint
+        auto res = push_block(block, height, median_time_past, ! is_old_block(block), db_txn);
+        if ( !  succeed(res)) {
+            kth_db_txn_abort(db_txn);
+            return res;
+        }
+
+        auto res2 = kth_db_txn_commit(db_txn);
+        if (res2 != KTH_DB_SUCCESS) {
+            spdlog::error("[database] Error commiting LMDB Transaction [push_block] {}", res2);
+            return result_code::other;
+        }
+
+        return res;
+    });
+}
+
+template <typename Clock>
+result_code internal_database_basis<Clock>::import_block(std::shared_ptr<domain::chain::block const> block, uint32_t height, uint32_t median_time_past) {
+    if (batch_blocks_ == 0 || ! is_old_block(*block)) {
+        return push_block(*block, height, median_time_past);
     }
 
-    auto res2 = kth_db_txn_commit(db_txn);
-    if (res2 != KTH_DB_SUCCESS) {
-        return result_code::other;
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+
+    if (batch_.empty()) {
+        batch_start_ = std::chrono::steady_clock::now();
+    }
+
+    batch_bytes_ += block->serialized_size();
+    batch_.push_back(batched_block{std::move(block), height, median_time_past});
+
+    if ( ! batch_full()) {
+        return result_code::success;
     }
+
+    return commit_batch();
+}
+
+template <typename Clock>
+result_code internal_database_basis<Clock>::flush_batch() {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    return commit_batch();
+}
+
+template <typename Clock>
+result_code internal_database_basis<Clock>::flush_expired_batch(bool& flushed) {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    flushed = false;
+
+    if (batch_.empty() || batch_interval_.count() == 0 || std::chrono::steady_clock::now() - batch_start_ < batch_interval_) {
+        return result_code::success;
+    }
+
+    auto const res = commit_batch();
+    flushed = succeed(res);
     return res;
 }
 
-//TODO(fernando): optimization: consider passing a list of outputs to insert and a list of inputs to delete instead of an entire Block.
-//                  avoiding inserting and erasing internal spenders
+template <typename Clock>
+bool internal_database_basis<Clock>::is_batched(uint32_t height) const {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    return std::any_of(batch_.begin(), batch_.end(), [height](batched_block const& x) {
+        return x.height == height;
+    });
+}
 
+// private
+// precondition: batch_mutex_ is locked.
 template <typename Clock>
-result_code internal_database_basis<Clock>::push_block(domain::chain::block const& block, uint32_t height, uint32_t median_time_past) {
+bool internal_database_basis<Clock>::batch_full() const {
+    if (batch_.size() >= batch_blocks_) {
+        return true;
+    }
 
-    KTH_DB_txn* db_txn;
-    auto res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
-    if (res0 != KTH_DB_SUCCESS) {
-        spdlog::error("[database] Error begining LMDB Transaction [push_block] {}", res0);
-        return result_code::other;
+    if (batch_size_ != 0 && batch_bytes_ >= batch_size_) {
+        return true;
     }
 
-    //TODO: save reorg blocks after the last checkpoint
-    auto res = push_block(block, height, median_time_past, ! is_old_block(block), db_txn);
-    if ( !  succeed(res)) {
-        kth_db_txn_abort(db_txn);
+    return batch_interval_.count() != 0 && std::chrono::steady_clock::now() - batch_start_ >= batch_interval_;
+}
+
+// private
+// precondition: batch_mutex_ is locked.
+template <typename Clock>
+result_code internal_database_basis<Clock>::commit_batch() {
+    if (batch_.empty()) {
+        return result_code::success;
+    }
+
+    auto const res = write_deltas([&]() {
+        KTH_DB_txn* db_txn;
+        auto res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
+        if (res0 != KTH_DB_SUCCESS) {
+            spdlog::error("[database] Error begining LMDB Transaction [commit_batch] {}", res0);
+            return result_code::other;
+        }
+
+        batching_utxos_ = true;
+        auto res = result_code::success;
+
+        // Old blocks, no reorg data is stored.
+        for (auto const& entry : batch_) {
+            auto const pushed = push_block(*entry.block, entry.height, entry.median_time_past, false, db_txn);
+            if ( ! succeed(pushed)) {
+                res = pushed;
+                break;
+            }
+        }
+
+        batching_utxos_ = false;
+
+        if (succeed(res)) {
+            res = write_batch_utxos(db_txn);
+        }
+
+        if (succeed(res)) {
+            res = write_utxo_set(batch_.back().height, false, db_txn);
+        }
+
+        batch_utxos_.clear();
+
+        if ( ! succeed(res)) {
+            kth_db_txn_abort(db_txn);
+            return res;
+        }
+
+        auto res2 = kth_db_txn_commit(db_txn);
+        if (res2 != KTH_DB_SUCCESS) {
+            spdlog::error("[database] Error commiting LMDB Transaction [commit_batch] {}", res2);
+            return result_code::other;
+        }
+
+        return result_code::success;
+    });
+
+    // The write was aborted. The batch is dropped, not retried, so a
+    // persistent failure does not block the later writes. None of its blocks
+    // are stored, they can be imported again.
+    if ( ! succeed(res)) {
+        spdlog::error("[database] Error committing {} batched blocks, heights {} to {} are not stored [commit_batch] {}",
+            batch_.size(), batch_.front().height, batch_.back().height, static_cast<int32_t>(res));
+        batch_.clear();
+        batch_bytes_ = 0;
         return res;
     }
 
-    auto res2 = kth_db_txn_commit(db_txn);
-    if (res2 != KTH_DB_SUCCESS) {
-        spdlog::error("[database] Error commiting LMDB Transaction [push_block] {}", res2);
-        return result_code::other;
+    spdlog::debug("[database] Committed {} blocks up to height {} ({} bytes) in a single write transaction.",
+        batch_.size(), batch_.back().height, batch_bytes_);
+
+    batch_.clear();
+    batch_bytes_ = 0;
+    return res;
+}
+
+// private
+template <typename Clock>
+result_code internal_database_basis<Clock>::write_batch_utxos(KTH_DB_txn* db_txn) {
+    for (auto const& [point, valuearr] : batch_utxos_) {
+        auto keyarr = point.to_data(KTH_INTERNAL_DB_WIRE);
+        auto key = kth_db_make_value(keyarr.size(), keyarr.data());
+        auto value = kth_db_make_value(valuearr.size(), const_cast<uint8_t*>(valuearr.data()));
+        auto res = kth_db_put(db_txn, dbi_utxo_, &key, &value, KTH_DB_NOOVERWRITE);
+
+        if (res == KTH_DB_KEYEXIST) {
+            // Duplicated coinbase (BIP30), the stored output is kept.
+            spdlog::debug("[database] Duplicate Key inserting UTXO [write_batch_utxos] {}", res);
+            utxo_set_pending_.remove(utxo_snapshot_element(keyarr, valuearr));
+            std::erase_if(utxo_delta_.created, [&point](auto const& x) {
+                return x.first == point;
+            });
+            continue;
+        }
+
+        if (res != KTH_DB_SUCCESS) {
+            spdlog::info("[database] Error inserting UTXO [write_batch_utxos] {}", res);
+            return result_code::other;
+        }
+    }
+
+    return result_code::success;
+}
+
+// The utxo and header changes recorded by f are applied to the cache and
+// the header index only if f commits.
+template <typename Clock>
+template <typename F>
+result_code internal_database_basis<Clock>::write_deltas(F f) {
+    // LMDB already allows a single write transaction, the lock also covers
+    // the deltas recorded before it begins and applied after it commits.
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    utxo_delta_.clear();
+    pushed_headers_.clear();
+    popped_headers_ = 0;
+    utxo_set_pending_ = utxo_set_;
+
+    auto const res = f();
+
+    if (succeed(res)) {
+        utxo_cache_.apply(utxo_delta_);
+        utxo_set_ = utxo_set_pending_;
+
+        if ( ! header_index_disabled_) {
+            for (; popped_headers_ > 0; --popped_headers_) {
+                header_index_.pop();
+            }
+
+            for (auto const& pushed : pushed_headers_) {
+                if ( ! header_index_.push(pushed.header, pushed.block_size, pushed.control_block_size, pushed.elastic_buffer_size)) {
+                    // Should not happen, the store is still consistent.
+                    spdlog::error("[database] Header index out of sync with the store, disabled.");
+                    header_index_.clear();
+                    header_index_disabled_ = true;
+                    break;
+                }
+            }
+        }
     }
 
+    utxo_delta_.clear();
+    pushed_headers_.clear();
+    popped_headers_ = 0;
     return res;
 }
 
@@ -268,6 +620,14 @@ utxo_entry internal_database_basis<Clock>::get_utxo(domain::chain::output_point
 template <typename Clock>
 utxo_entry internal_database_basis<Clock>::get_utxo(domain::chain::output_point const& point) const {
 
+    auto cached = utxo_cache_.find(point);
+    if (cached) {
+        return std::move(*cached);
+    }
+
+    // Taken before the read, a block committed meanwhile invalidates it.
+    auto const generation = utxo_cache_.generation();
+
     KTH_DB_txn* db_txn;
     auto res0 = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
     if (res0 != KTH_DB_SUCCESS) {
@@ -283,11 +643,34 @@ utxo_entry internal_database_basis<Clock>::get_utxo(domain::chain::output_point
         return {};
     }
 
+    if (ret.is_valid()) {
+        utxo_cache_.add_if_current(point, ret, generation);
+    }
+
     return ret;
 }
 
+template <typename Clock>
+utxo_cache const& internal_database_basis<Clock>::get_utxo_cache() const {
+    return utxo_cache_;
+}
+
+template <typename Clock>
+header_index const& internal_database_basis<Clock>::get_header_index() const {
+    return header_index_;
+}
+
 template <typename Clock>
 result_code internal_database_basis<Clock>::get_last_height(uint32_t& out_height) const {
+    if ( ! header_index_.empty()) {
+        auto const top = header_index_.top();
+        if ( ! top) {
+            return result_code::db_empty;
+        }
+        out_height = *top;
+        return result_code::success;
+    }
+
     KTH_DB_txn* db_txn;
     auto res = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
     if (res != KTH_DB_SUCCESS) {
@@ -303,6 +686,8 @@ result_code internal_database_basis<Clock>::get_last_height(uint32_t& out_height
     KTH_DB_val key;
     int rc;
     if ((rc = kth_db_cursor_get(cursor, &key, nullptr, KTH_DB_LAST)) != KTH_DB_SUCCESS) {
+        kth_db_cursor_close(cursor);
+        kth_db_txn_commit(db_txn);
         return result_code::db_empty;
     }
 
@@ -321,6 +706,14 @@ result_code internal_database_basis<Clock>::get_last_height(uint32_t& out_height
 
 template <typename Clock>
 std::pair<domain::chain::header, uint32_t> internal_database_basis<Clock>::get_header(hash_digest const& hash) const {
+    if ( ! header_index_.empty()) {
+        auto const height = header_index_.find(hash);
+        if ( ! height) {
+            return {};
+        }
+        return {header_index_.get_header(*height), *height};
+    }
+
     auto key  = kth_db_make_value(hash.size(), const_cast<hash_digest&>(hash).data());
 
     KTH_DB_txn* db_txn;
@@ -350,6 +743,10 @@ std::pair<domain::chain::header, uint32_t> internal_database_basis<Clock>::get_h
 
 template <typename Clock>
 domain::chain::header internal_database_basis<Clock>::get_header(uint32_t height) const {
+    if ( ! header_index_.empty()) {
+        return header_index_.get_header(height);
+    }
+
     KTH_DB_txn* db_txn;
     auto ret1 = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
     if (ret1 != KTH_DB_SUCCESS) {
@@ -367,6 +764,14 @@ domain::chain::header internal_database_basis<Clock>::get_header(uint32_t height
 
 template <typename Clock>
 std::optional<header_with_abla_state_t> internal_database_basis<Clock>::get_header_and_abla_state(uint32_t height) const {
+    if ( ! header_index_.empty()) {
+        auto const entry = header_index_.get(height);
+        if ( ! entry) {
+            return {};
+        }
+        return std::make_tuple(header_index_.get_header(height), entry->block_size, entry->control_block_size, entry->elastic_buffer_size);
+    }
+
     KTH_DB_txn* db_txn;
     auto zzz = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
     if (zzz != KTH_DB_SUCCESS) {
@@ -385,6 +790,10 @@ std::optional<header_with_abla_state_t> internal_database_basis<Clock>::get_head
 template <typename Clock>
 domain::chain::header::list internal_database_basis<Clock>::get_headers(uint32_t from, uint32_t to) const {
     // precondition: from <= to
+    if ( ! header_index_.empty()) {
+        return header_index_.get_headers(from, to);
+    }
+
     domain::chain::header::list list;
 
     KTH_DB_txn* db_txn;
@@ -436,6 +845,9 @@ domain::chain::header::list internal_database_basis<Clock>::get_headers(uint32_t
 
 template <typename Clock>
 result_code internal_database_basis<Clock>::pop_block(domain::chain::block& out_block) {
+    // A failed batch is logged and dropped.
+    flush_batch();
+
     uint32_t height;
 
     //TODO: (Mario) use only one transaction ?
@@ -464,6 +876,9 @@ result_code internal_database_basis<Clock>::pop_block(domain::chain::block& out_
 
 template <typename Clock>
 result_code internal_database_basis<Clock>::prune() {
+    // A failed batch is logged and dropped.
+    flush_batch();
+
     //TODO: (Mario) add overload with tx
     uint32_t last_height;
     auto res = get_last_height(last_height);
@@ -502,6 +917,15 @@ result_code internal_database_basis<Clock>::prune() {
         return res;
     }
 
+    for (auto height = first_height; height < remove_until; ++height) {
+        auto key = kth_db_make_value(sizeof(height), &height);
+        auto const deleted = kth_db_del(db_txn, dbi_utxo_set_hash_, &key, NULL);
+        if (deleted != KTH_DB_SUCCESS && deleted != KTH_DB_NOTFOUND) {
+            kth_db_txn_abort(db_txn);
+            return result_code::other;
+        }
+    }
+
     if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
         return result_code::other;
     }
@@ -756,17 +1180,27 @@ bool internal_database_basis<Clock>::set_fast_flags_environment(bool enabled) {
 }
 */
 
+// The entries of an address sorted by height and then by id, the insertion
+// order (see history_entry).
 inline
-int compare_uint64(KTH_DB_val const* a, KTH_DB_val const* b) {
-
-    //TODO(fernando): check this casts... something smells bad
-    uint64_t const va = *(uint64_t const *)kth_db_get_data(*a);
-    uint64_t const vb = *(uint64_t const *)kth_db_get_data(*b);
+int compare_history(KTH_DB_val const* a, KTH_DB_val const* b) {
+    auto const read = [](KTH_DB_val const* x, size_t offset, auto& out) {
+        std::memcpy(&out, static_cast<uint8_t const*>(kth_db_get_data(*x)) + offset, sizeof(out));
+    };
 
-    //std::println("va: {}", va);
-    //std::println("vb: {}", va);
+    uint32_t height_a;
+    uint32_t height_b;
+    read(a, history_entry::height_offset, height_a);
+    read(b, history_entry::height_offset, height_b);
+    if (height_a != height_b) {
+        return height_a < height_b ? -1 : 1;
+    }
 
-    return (va < vb) ? -1 : va > vb;
+    uint64_t id_a;
+    uint64_t id_b;
+    read(a, history_entry::id_offset, id_a);
+    read(b, history_entry::id_offset, id_b);
+    return (id_a < id_b) ? -1 : id_a > id_b;
 }
 
 template <typename Clock>
@@ -793,9 +1227,11 @@ bool internal_database_basis<Clock>::open_databases() {
     if ( ! open_db(reorg_index_name, KTH_DB_CONDITIONAL_CREATE | KTH_DB_DUPSORT | KTH_DB_INTEGERKEY | KTH_DB_DUPFIXED, &dbi_reorg_index_)) return false;
     if ( ! open_db(reorg_block_name, KTH_DB_CONDITIONAL_CREATE | KTH_DB_INTEGERKEY, &dbi_reorg_block_)) return false;
     if ( ! open_db(db_properties_name, KTH_DB_CONDITIONAL_CREATE | KTH_DB_INTEGERKEY, &dbi_properties_)) return false;
+    if ( ! open_db(utxo_set_hash_name, KTH_DB_CONDITIONAL_CREATE | KTH_DB_INTEGERKEY, &dbi_utxo_set_hash_)) return false;
 
     if (db_mode_ == db_mode_type::blocks || db_mode_ == db_mode_type::full) {
         if ( ! open_db(block_db_name, KTH_DB_CONDITIONAL_CREATE | KTH_DB_INTEGERKEY, &dbi_block_db_)) return false;
+        if ( ! open_db(block_tx_hashes_db_name, KTH_DB_CONDITIONAL_CREATE | KTH_DB_INTEGERKEY, &dbi_block_tx_hashes_db_)) return false;
     }
 
     if (db_mode_ == db_mode_type::full) {
@@ -806,7 +1242,7 @@ bool internal_database_basis<Clock>::open_databases() {
         if ( ! open_db(spend_db_name, KTH_DB_CONDITIONAL_CREATE, &dbi_spend_db_)) return false;
         if ( ! open_db(transaction_unconfirmed_db_name, KTH_DB_CONDITIONAL_CREATE, &dbi_transaction_unconfirmed_db_)) return false;
 
-        mdb_set_dupsort(db_txn, dbi_history_db_, compare_uint64);
+        mdb_set_dupsort(db_txn, dbi_history_db_, compare_history);
     }
 
     db_opened_ = kth_db_txn_commit(db_txn) == KTH_DB_SUCCESS;
@@ -824,7 +1260,7 @@ result_code internal_database_basis<Clock>::remove_inputs(hash_digest const& tx_
         domain::chain::input_point const inpoint {tx_id, pos};
         auto const& prevout = input.previous_output();
 
-        if (db_mode_ == db_mode_type::full) {
+        if (inline_indexes()) {
             auto res = insert_input_history(inpoint, height, input, db_txn);
             if (res != result_code::success) {
                 return res;
@@ -836,7 +1272,7 @@ result_code internal_database_basis<Clock>::remove_inputs(hash_digest const& tx_
             return res;
         }
 
-        if (db_mode_ == db_mode_type::full) {
+        if (inline_indexes()) {
             //insert in spend database
             res = insert_spend(prevout, inpoint, db_txn);
             if (res != result_code::success) {
@@ -859,7 +1295,7 @@ result_code internal_database_basis<Clock>::insert_outputs(hash_digest const& tx
             return res;
         }
 
-        if (db_mode_ == db_mode_type::full) {
+        if (inline_indexes()) {
             res = insert_output_history(tx_id, height, pos, output, db_txn);
             if (res != result_code::success) {
                 return res;
@@ -978,6 +1414,23 @@ result_code internal_database_basis<Clock>::push_block(domain::chain::block cons
         return res;
     }
 
+    if (inline_indexes()) {
+        for (auto const kind : {index_kind::history, index_kind::spend}) {
+            auto const written = write_index_height(kind, height, db_txn);
+            if (written != result_code::success) {
+                return written;
+            }
+        }
+    }
+
+    // A batch writes the multiset once, after its outputs.
+    if ( ! batching_utxos_) {
+        res = write_utxo_set(height, insert_reorg, db_txn);
+        if (res != result_code::success) {
+            return res;
+        }
+    }
+
     if (res == result_code::success_duplicate_coinbase)
         return res;
 
@@ -1009,15 +1462,28 @@ result_code internal_database_basis<Clock>::push_genesis(domain::chain::block co
             return res;
         }
 
+        // The genesis is indexed by the block writer, also with asynchronous
+        // indexes (it has no inputs).
         res = insert_output_history(hash, 0, 0, coinbase.outputs()[0], db_txn);
         if (res != result_code::success) {
             return res;
         }
+
+        for (auto const kind : {index_kind::history, index_kind::spend}) {
+            res = write_index_height(kind, 0, db_txn);
+            if (res != result_code::success) {
+                return res;
+            }
+        }
     } else if (db_mode_ == db_mode_type::blocks) {
         res = insert_block(block, 0, 0, db_txn);
     }
 
-    return res;
+    if (res != result_code::success) {
+        return res;
+    }
+
+    return write_utxo_set(0, false, db_txn);
 }
 
 template <typename Clock>
@@ -1130,6 +1596,11 @@ result_code internal_database_basis<Clock>::remove_block(domain::chain::block co
         return res;
     }
 
+    res = remove_utxo_set(height, db_txn);
+    if (res != result_code::success) {
+        return res;
+    }
+
     if (db_mode_ == db_mode_type::full) {
         //Transaction Database
         res = remove_transactions(block, height, db_txn);
@@ -1151,25 +1622,491 @@ result_code internal_database_basis<Clock>::remove_block(domain::chain::block co
 
 template <typename Clock>
 result_code internal_database_basis<Clock>::remove_block(domain::chain::block const& block, uint32_t height) {
+    return write_deltas([&]() {
+        KTH_DB_txn* db_txn;
+        auto res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
+        if (res0 != KTH_DB_SUCCESS) {
+            return result_code::other;
+        }
+
+        auto res = remove_block(block, height, db_txn);
+        if (res != result_code::success) {
+            kth_db_txn_abort(db_txn);
+            return res;
+        }
+
+        auto res2 = kth_db_txn_commit(db_txn);
+        if (res2 != KTH_DB_SUCCESS) {
+            return result_code::other;
+        }
+        return result_code::success;
+    });
+}
+
+#endif // ! defined(KTH_DB_READONLY)
+
+// UTXO snapshots.
+// ----------------------------------------------------------------------------
+
+template <typename Clock>
+result_code internal_database_basis<Clock>::export_utxo_snapshot(path const& file) const {
+    std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+    if ( ! stream) {
+        spdlog::error("[database] Failed to create snapshot file {} [export_utxo_snapshot]", file.string());
+        return result_code::other;
+    }
+
     KTH_DB_txn* db_txn;
-    auto res0 = kth_db_txn_begin(env_, NULL, 0, &db_txn);
-    if (res0 != KTH_DB_SUCCESS) {
+    if (kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn) != KTH_DB_SUCCESS) {
         return result_code::other;
     }
 
-    auto res = remove_block(block, height, db_txn);
-    if (res != result_code::success) {
+    utxo_snapshot_writer writer(stream);
+    auto result = writer.start() ? result_code::success : result_code::other;
+
+    // Both tables are read in key order, so the headers are sorted by height.
+    hash_digest abla_commitment = null_hash;
+    auto const write_table = [&](KTH_DB_dbi dbi, snapshot_chunk_kind kind, data_chunk& last) {
+        KTH_DB_cursor* cursor;
+        if (kth_db_cursor_open(db_txn, dbi, &cursor) != KTH_DB_SUCCESS) {
+            return result_code::other;
+        }
+
+        KTH_DB_val key;
+        KTH_DB_val value;
+        auto rc = kth_db_cursor_get(cursor, &key, &value, KTH_DB_FIRST);
+        for (; rc == KTH_DB_SUCCESS; rc = kth_db_cursor_get(cursor, &key, &value, KTH_DB_NEXT)) {
+            byte_span const key_span {static_cast<uint8_t const*>(kth_db_get_data(key)), kth_db_get_size(key)};
+            byte_span const value_span {static_cast<uint8_t const*>(kth_db_get_data(value)), kth_db_get_size(value)};
+            if ( ! writer.add(kind, key_span, value_span)) {
+                break;
+            }
+            if (kind == snapshot_chunk_kind::headers) {
+                byte_reader reader(value_span);
+                auto const entry = get_header_and_abla_state_from_data(reader);
+                if ( ! entry) {
+                    kth_db_cursor_close(cursor);
+                    return result_code::db_corrupt;
+                }
+                abla_commitment = utxo_snapshot_abla_link(abla_commitment, std::get<1>(*entry), std::get<2>(*entry), std::get<3>(*entry));
+                last.assign(value_span.begin(), value_span.end());
+            }
+        }
+
+        kth_db_cursor_close(cursor);
+        return rc == KTH_DB_NOTFOUND ? result_code::success : result_code::other;
+    };
+
+    data_chunk last_header;
+    data_chunk unused;
+    if (result == result_code::success) {
+        result = write_table(dbi_block_header_, snapshot_chunk_kind::headers, last_header);
+    }
+    if (result == result_code::success) {
+        result = write_table(dbi_utxo_, snapshot_chunk_kind::utxos, unused);
+    }
+
+    kth_db_txn_commit(db_txn);
+
+    if (result != result_code::success || writer.header().headers == 0) {
+        spdlog::error("[database] Failed to read the database [export_utxo_snapshot]");
+        return result_code::other;
+    }
+
+    byte_reader reader(last_header);
+    auto const entry = get_header_and_abla_state_from_data(reader);
+    if ( ! entry) {
+        return result_code::db_corrupt;
+    }
+
+    auto const height = writer.header().headers - 1;
+    if ( ! writer.finish(height, std::get<0>(*entry).hash(), abla_commitment)) {
+        spdlog::error("[database] Failed to write snapshot file {} [export_utxo_snapshot]", file.string());
+        return result_code::other;
+    }
+
+    spdlog::info("[database] Exported {} headers and {} unspent outputs at height {}, commitment {}, abla commitment {}.",
+        writer.header().headers, writer.header().utxos, height, encode_hash(writer.header().commitment), encode_hash(abla_commitment));
+    return result_code::success;
+}
+
+#if ! defined(KTH_DB_READONLY)
+
+template <typename Clock>
+result_code internal_database_basis<Clock>::import_utxo_snapshot(path const& file, hash_digest const& genesis_hash, utxo_snapshot_trust const& trust) {
+    if (db_mode_ != db_mode_type::pruned) {
+        spdlog::error("[database] Snapshots can only be imported into a pruned database [import_utxo_snapshot]");
+        return result_code::other;
+    }
+
+    uint32_t top;
+    if ( ! header_index_.empty() || get_last_height(top) != result_code::db_empty) {
+        spdlog::error("[database] Snapshots can only be imported into an empty database [import_utxo_snapshot]");
+        return result_code::other;
+    }
+
+    std::ifstream stream(file, std::ios::binary);
+    if ( ! stream) {
+        spdlog::error("[database] Failed to open snapshot file {} [import_utxo_snapshot]", file.string());
+        return result_code::other;
+    }
+
+    utxo_snapshot_reader reader(stream);
+    auto const header = reader.read_header();
+    if ( ! header) {
+        spdlog::error("[database] Invalid snapshot file header [import_utxo_snapshot]");
+        return result_code::db_corrupt;
+    }
+
+    // The file only has to match the trusted values, not itself.
+    if (header->block_hash != trust.block_hash || header->commitment != trust.commitment || header->abla_commitment != trust.abla_commitment) {
+        spdlog::error("[database] The snapshot block {}, commitment {} and abla commitment {} are not the trusted ones [import_utxo_snapshot]",
+            encode_hash(header->block_hash), encode_hash(header->commitment), encode_hash(header->abla_commitment));
+        return result_code::other;
+    }
+
+    // Each chunk commits separately, the database does not open until the
+    // property is removed (last).
+    if ( ! create_snapshot_import_property(header->height)) {
+        return result_code::other;
+    }
+
+    auto const result = import_snapshot_chunks(reader, *header, genesis_hash, trust);
+    if (result != result_code::success) {
+        clear_snapshot_tables();
+        return result;
+    }
+
+    if ( ! load_header_index()) {
+        clear_snapshot_tables();
+        return result_code::db_corrupt;
+    }
+
+    if ( ! remove_snapshot_import_property()) {
+        clear_snapshot_tables();
+        return result_code::other;
+    }
+
+    spdlog::info("[database] Accepted the snapshot commitment {} of block {} at height {}.", encode_hash(header->commitment), encode_hash(header->block_hash), header->height);
+    spdlog::info("[database] Imported {} headers and {} unspent outputs at height {}.", header->headers, header->utxos, header->height);
+    return result_code::success;
+}
+
+// private
+template <typename Clock>
+result_code internal_database_basis<Clock>::import_snapshot_chunks(utxo_snapshot_reader& reader, utxo_snapshot_header const& header, hash_digest const& genesis_hash, utxo_snapshot_trust const& trust) {
+    uint32_t headers = 0;
+    uint64_t utxos = 0;
+    hash_digest previous = null_hash;
+    hash_digest abla_commitment = null_hash;
+    multiset commitment;
+
+    // One write transaction per chunk (bounded by the chunk size).
+    while (true) {
+        auto const chunk = reader.read_chunk();
+        if ( ! chunk) {
+            spdlog::error("[database] Invalid snapshot chunk [import_utxo_snapshot]");
+            return result_code::db_corrupt;
+        }
+
+        if (chunk->kind == snapshot_chunk_kind::end) {
+            break;
+        }
+
+        // The headers come first.
+        if (chunk->kind == snapshot_chunk_kind::headers && utxos != 0) {
+            return result_code::db_corrupt;
+        }
+
+        KTH_DB_txn* db_txn;
+        if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+            return result_code::other;
+        }
+
+        auto result = result_code::success;
+        for (auto const& entry : chunk->entries) {
+            auto key = kth_db_make_value(entry.key.size(), const_cast<uint8_t*>(entry.key.data()));
+            auto value = kth_db_make_value(entry.value.size(), const_cast<uint8_t*>(entry.value.data()));
+
+            if (chunk->kind == snapshot_chunk_kind::headers) {
+                if (entry.key.size() != sizeof(uint32_t) || from_little_endian_unsafe<uint32_t>(entry.key) != headers) {
+                    result = result_code::db_corrupt;
+                    break;
+                }
+
+                byte_reader value_reader(entry.value);
+                auto const stored = get_header_and_abla_state_from_data(value_reader);
+                if ( ! stored || std::get<0>(*stored).previous_block_hash() != previous) {
+                    result = result_code::db_corrupt;
+                    break;
+                }
+
+                auto const& block_header = std::get<0>(*stored);
+                auto hash = block_header.hash();
+                if (headers == 0 && hash != genesis_hash) {
+                    result = result_code::db_corrupt;
+                    break;
+                }
+
+                // Context free, the trusted tip hash commits to the rest. The
+                // ABLA state (next block size limits) is committed separately.
+                if (block_header.check(trust.retarget) != error::success ||
+                    ! infrastructure::config::checkpoint::validate(hash, headers, trust.checkpoints)) {
+                    spdlog::error("[database] Invalid snapshot header {} at height {} [import_utxo_snapshot]", encode_hash(hash), headers);
+                    result = result_code::db_corrupt;
+                    break;
+                }
+
+                auto by_hash = kth_db_make_value(hash.size(), hash.data());
+                if (kth_db_put(db_txn, dbi_block_header_, &key, &value, KTH_DB_APPEND) != KTH_DB_SUCCESS ||
+                    kth_db_put(db_txn, dbi_block_header_by_hash_, &by_hash, &key, KTH_DB_NOOVERWRITE) != KTH_DB_SUCCESS) {
+                    result = result_code::db_corrupt;
+                    break;
+                }
+
+                abla_commitment = utxo_snapshot_abla_link(abla_commitment, std::get<1>(*stored), std::get<2>(*stored), std::get<3>(*stored));
+                previous = hash;
+                ++headers;
+            } else {
+                // Appending rejects unsorted or duplicated outputs.
+                if (kth_db_put(db_txn, dbi_utxo_, &key, &value, KTH_DB_APPEND) != KTH_DB_SUCCESS) {
+                    result = result_code::db_corrupt;
+                    break;
+                }
+
+                commitment.add(utxo_snapshot_element(entry.key, entry.value));
+                ++utxos;
+            }
+        }
+
+        if (result != result_code::success) {
+            kth_db_txn_abort(db_txn);
+            spdlog::error("[database] Invalid snapshot entry [import_utxo_snapshot]");
+            return result;
+        }
+
+        if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+            return result_code::other;
+        }
+    }
+
+    if (headers == 0 || headers != header.headers || headers - 1 != header.height ||
+        previous != header.block_hash || abla_commitment != header.abla_commitment ||
+        utxos != header.utxos || commitment.hash() != header.commitment) {
+        spdlog::error("[database] The snapshot does not match its commitment [import_utxo_snapshot]");
+        return result_code::db_corrupt;
+    }
+
+    // The commitment is the utxo set hash of the snapshot height.
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+        return result_code::other;
+    }
+
+    utxo_set_pending_ = commitment;
+    if (write_utxo_set(header.height, false, db_txn) != result_code::success) {
         kth_db_txn_abort(db_txn);
-        return res;
+        return result_code::other;
+    }
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return result_code::other;
+    }
+
+    utxo_set_ = commitment;
+    return result_code::success;
+}
+
+// private
+template <typename Clock>
+void internal_database_basis<Clock>::clear_snapshot_tables() {
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+        return;
+    }
+
+    auto code = property_code::utxo_set;
+    auto key = kth_db_make_value(sizeof(code), &code);
+    kth_db_del(db_txn, dbi_properties_, &key, NULL);
+
+    kth_db_drop(db_txn, dbi_block_header_, 0);
+    kth_db_drop(db_txn, dbi_block_header_by_hash_, 0);
+    kth_db_drop(db_txn, dbi_utxo_, 0);
+    kth_db_drop(db_txn, dbi_utxo_set_hash_, 0);
+    kth_db_txn_commit(db_txn);
+    header_index_.clear();
+    utxo_set_ = multiset{};
+}
+
+#endif // ! defined(KTH_DB_READONLY)
+
+// UTXO set hash.
+// ----------------------------------------------------------------------------
+
+// private
+template <typename Clock>
+std::optional<multiset> internal_database_basis<Clock>::read_utxo_set(KTH_DB_dbi dbi, uint32_t key_int, KTH_DB_txn* db_txn) const {
+    auto key = kth_db_make_value(sizeof(key_int), &key_int);
+    KTH_DB_val value;
+
+    if (kth_db_get(db_txn, dbi, &key, &value) != KTH_DB_SUCCESS || kth_db_get_size(value) != multiset_size) {
+        return std::nullopt;
+    }
+
+    multiset_data data;
+    std::copy_n(static_cast<uint8_t const*>(kth_db_get_data(value)), multiset_size, data.begin());
+    return multiset::from_data(data);
+}
+
+template <typename Clock>
+std::optional<hash_digest> internal_database_basis<Clock>::get_utxo_set_hash() const {
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn) != KTH_DB_SUCCESS) {
+        return std::nullopt;
+    }
+
+    auto const set = read_utxo_set(dbi_properties_, uint32_t(property_code::utxo_set), db_txn);
+    kth_db_txn_commit(db_txn);
+
+    if ( ! set) {
+        return std::nullopt;
+    }
+    return set->hash();
+}
+
+template <typename Clock>
+std::optional<hash_digest> internal_database_basis<Clock>::get_utxo_set_hash(uint32_t height) const {
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn) != KTH_DB_SUCCESS) {
+        return std::nullopt;
+    }
+
+    auto set = read_utxo_set(dbi_utxo_set_hash_, height, db_txn);
+
+    // Old blocks are not in the reorg pool, only the top is known.
+    if ( ! set) {
+        KTH_DB_cursor* cursor;
+        if (kth_db_cursor_open(db_txn, dbi_block_header_, &cursor) == KTH_DB_SUCCESS) {
+            KTH_DB_val key;
+            if (kth_db_cursor_get(cursor, &key, nullptr, KTH_DB_LAST) == KTH_DB_SUCCESS &&
+                *static_cast<uint32_t*>(kth_db_get_data(key)) == height) {
+                set = read_utxo_set(dbi_properties_, uint32_t(property_code::utxo_set), db_txn);
+            }
+            kth_db_cursor_close(cursor);
+        }
+    }
+
+    kth_db_txn_commit(db_txn);
+
+    if ( ! set) {
+        return std::nullopt;
+    }
+    return set->hash();
+}
+
+#if ! defined(KTH_DB_READONLY)
+
+// private
+// The databases created before the utxo set hash are hashed once, on open.
+template <typename Clock>
+bool internal_database_basis<Clock>::load_utxo_set() {
+    KTH_DB_txn* db_txn;
+    if (kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    auto const stored = read_utxo_set(dbi_properties_, uint32_t(property_code::utxo_set), db_txn);
+    if (stored) {
+        kth_db_txn_commit(db_txn);
+        utxo_set_ = *stored;
+        return true;
+    }
+
+    spdlog::info("[database] Computing the utxo set hash, please wait...");
+
+    KTH_DB_cursor* cursor;
+    if (kth_db_cursor_open(db_txn, dbi_utxo_, &cursor) != KTH_DB_SUCCESS) {
+        kth_db_txn_commit(db_txn);
+        return false;
+    }
+
+    multiset set;
+    size_t count = 0;
+    KTH_DB_val key;
+    KTH_DB_val value;
+    auto rc = kth_db_cursor_get(cursor, &key, &value, KTH_DB_FIRST);
+    for (; rc == KTH_DB_SUCCESS; rc = kth_db_cursor_get(cursor, &key, &value, KTH_DB_NEXT)) {
+        byte_span const key_span {static_cast<uint8_t const*>(kth_db_get_data(key)), kth_db_get_size(key)};
+        byte_span const value_span {static_cast<uint8_t const*>(kth_db_get_data(value)), kth_db_get_size(value)};
+        set.add(utxo_snapshot_element(key_span, value_span));
+        ++count;
     }
 
-    auto res2 = kth_db_txn_commit(db_txn);
-    if (res2 != KTH_DB_SUCCESS) {
+    kth_db_cursor_close(cursor);
+    kth_db_txn_commit(db_txn);
+
+    if (rc != KTH_DB_NOTFOUND) {
+        return false;
+    }
+
+    if (kth_db_txn_begin(env_, NULL, 0, &db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    utxo_set_pending_ = set;
+    if (write_utxo_set(0, false, db_txn) != result_code::success || kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return false;
+    }
+
+    utxo_set_ = set;
+    spdlog::info("[database] Computed the utxo set hash of {} unspent outputs.", count);
+    return true;
+}
+
+// private
+// Persist the pending multiset as the top one and, if by_height, as the one
+// of the block at height (reorg pool).
+template <typename Clock>
+result_code internal_database_basis<Clock>::write_utxo_set(uint32_t height, bool by_height, KTH_DB_txn* db_txn) {
+    auto data = utxo_set_pending_.to_data();
+    auto value = kth_db_make_value(data.size(), data.data());
+
+    auto code = property_code::utxo_set;
+    auto key = kth_db_make_value(sizeof(code), &code);
+    auto res = kth_db_put(db_txn, dbi_properties_, &key, &value, 0);
+    if (res != KTH_DB_SUCCESS) {
+        spdlog::info("[database] Error saving the utxo set hash [write_utxo_set] {}", res);
         return result_code::other;
     }
+
+    if ( ! by_height) {
+        return result_code::success;
+    }
+
+    auto key_height = kth_db_make_value(sizeof(height), &height);
+    res = kth_db_put(db_txn, dbi_utxo_set_hash_, &key_height, &value, 0);
+    if (res != KTH_DB_SUCCESS) {
+        spdlog::info("[database] Error saving the utxo set hash of height {} [write_utxo_set] {}", height, res);
+        return result_code::other;
+    }
+
     return result_code::success;
 }
 
+// private
+template <typename Clock>
+result_code internal_database_basis<Clock>::remove_utxo_set(uint32_t height, KTH_DB_txn* db_txn) {
+    auto key = kth_db_make_value(sizeof(height), &height);
+    auto const res = kth_db_del(db_txn, dbi_utxo_set_hash_, &key, NULL);
+    if (res != KTH_DB_SUCCESS && res != KTH_DB_NOTFOUND) {
+        spdlog::info("[database] Error deleting the utxo set hash of height {} [remove_utxo_set] {}", height, res);
+        return result_code::other;
+    }
+
+    // The pending multiset is the one of the previous block.
+    return write_utxo_set(height, false, db_txn);
+}
+
 #endif // ! defined(KTH_DB_READONLY)
 
 } // namespace kth::database
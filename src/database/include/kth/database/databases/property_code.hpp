@@ -17,6 +17,17 @@ namespace kth::database {
 
 enum class property_code {
     db_mode = 0,
+    utxo_set = 1,           // multiset (ECMH) of the unspent outputs
+    history_index = 2,      // height of the last block in the history table (asynchronous indexes)
+    spend_index = 3,        // height of the last block in the spend table (asynchronous indexes)
+    snapshot_import = 4,    // height of a snapshot import in progress (removed once complete)
+};
+
+/// The tables of the full mode that can be written by a background indexer
+/// instead of the block writer.
+enum class index_kind {
+    history,
+    spend,
 };
 
 enum class db_mode_type {
@@ -12,20 +12,9 @@ namespace kth::database {
 #if ! defined(KTH_DB_READONLY)
 
 template <typename Clock>
-result_code internal_database_basis<Clock>::insert_reorg_pool(uint32_t height, KTH_DB_val& key, KTH_DB_txn* db_txn) {
-    KTH_DB_val value;
-    //TODO: use cursors
-    auto res = kth_db_get(db_txn, dbi_utxo_, &key, &value);
-    if (res == KTH_DB_NOTFOUND) {
-        spdlog::info("[database] Key not found getting UTXO [insert_reorg_pool] {}", res);
-        return result_code::key_not_found;
-    }
-    if (res != KTH_DB_SUCCESS) {
-        spdlog::info("[database] Error getting UTXO [insert_reorg_pool] {}", res);
-        return result_code::other;
-    }
-
-    res = kth_db_put(db_txn, dbi_reorg_pool_, &key, &value, KTH_DB_NOOVERWRITE);
+result_code internal_database_basis<Clock>::insert_reorg_pool(uint32_t height, KTH_DB_val& key, KTH_DB_val& value, KTH_DB_txn* db_txn) {
+    // precondition: value is the stored utxo of key.
+    auto res = kth_db_put(db_txn, dbi_reorg_pool_, &key, &value, KTH_DB_NOOVERWRITE);
     if (res == KTH_DB_KEYEXIST) {
         spdlog::info("[database] Duplicate key inserting in reorg pool [insert_reorg_pool] {}", res);
         return result_code::duplicated_key;
@@ -88,6 +77,9 @@ result_code internal_database_basis<Clock>::insert_output_from_reorg_and_remove(
         return result_code::other;
     }
 
+    byte_span const value_span {static_cast<uint8_t const*>(kth_db_get_data(value)), kth_db_get_size(value)};
+    auto const element = utxo_snapshot_element(keyarr, value_span);
+
     res = kth_db_put(db_txn, dbi_utxo_, &key, &value, KTH_DB_NOOVERWRITE);
     if (res == KTH_DB_KEYEXIST) {
         spdlog::info("[database] Duplicate key inserting in UTXO [insert_output_from_reorg_and_remove] {}", res);
@@ -107,6 +99,10 @@ result_code internal_database_basis<Clock>::insert_output_from_reorg_and_remove(
         spdlog::info("[database] Error deleting in reorg pool [insert_output_from_reorg_and_remove] {}", res);
         return result_code::other;
     }
+
+    // The restored output is loaded into the cache on demand.
+    utxo_delta_.erased.push_back(point);
+    utxo_set_pending_.add(element);
     return result_code::success;
 }
 
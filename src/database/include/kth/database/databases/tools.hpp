@@ -43,6 +43,12 @@ data_chunk db_value_to_data_chunk(KTH_DB_val const& value) {
                       static_cast<uint8_t*>(kth_db_get_data(value)) + kth_db_get_size(value)};
 }
 
+// The value in the mapped memory, valid until the end of the transaction.
+inline
+byte_span db_value_to_byte_span(KTH_DB_val const& value) {
+    return {static_cast<uint8_t const*>(kth_db_get_data(value)), kth_db_get_size(value)};
+}
+
 } // namespace kth::database
 
 #endif // KTH_DATABASE_TOOLS_HPP_
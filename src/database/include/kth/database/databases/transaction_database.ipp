@@ -29,6 +29,43 @@ transaction_entry internal_database_basis<Clock>::get_transaction(hash_digest co
 
 }
 
+//public
+template <typename Clock>
+result_code internal_database_basis<Clock>::get_transaction_position(hash_digest const& hash, uint32_t& out_height, uint32_t& out_position) const {
+    if (db_mode_ != db_mode_type::full) {
+        return result_code::key_not_found;
+    }
+
+    KTH_DB_txn* db_txn;
+    auto res = kth_db_txn_begin(env_, NULL, KTH_DB_RDONLY, &db_txn);
+    if (res != KTH_DB_SUCCESS) {
+        return result_code::other;
+    }
+
+    auto key = kth_db_make_value(hash.size(), const_cast<hash_digest&>(hash).data());
+    KTH_DB_val value;
+    if (kth_db_get(db_txn, dbi_transaction_hash_db_, &key, &value) != KTH_DB_SUCCESS) {
+        kth_db_txn_commit(db_txn);
+        return result_code::key_not_found;
+    }
+
+    // Only the trailing fields of the entry are read.
+    KTH_DB_val entry;
+    if (kth_db_get(db_txn, dbi_transaction_db_, &value, &entry) != KTH_DB_SUCCESS) {
+        kth_db_txn_commit(db_txn);
+        return result_code::key_not_found;
+    }
+
+    byte_span const data(static_cast<uint8_t const*>(kth_db_get_data(entry)), kth_db_get_size(entry));
+    auto const valid = transaction_entry::read_height_position(data, out_height, out_position);
+
+    if (kth_db_txn_commit(db_txn) != KTH_DB_SUCCESS) {
+        return result_code::other;
+    }
+
+    return valid ? result_code::success : result_code::other;
+}
+
 #if ! defined(KTH_DB_READONLY)
 
 template <typename Clock>
@@ -161,18 +198,26 @@ result_code internal_database_basis<Clock>::insert_transaction(uint64_t id, doma
 template <typename Clock>
 result_code internal_database_basis<Clock>::remove_transactions(domain::chain::block const& block, uint32_t height, KTH_DB_txn* db_txn) {
 
+    // The asynchronous indexes may not have reached the block.
+    auto const history_height = get_index_height(index_kind::history, db_txn);
+    auto const spend_height = get_index_height(index_kind::spend, db_txn);
+    auto const history = history_height && *history_height >= height;
+    auto const spend = spend_height && *spend_height >= height;
+
     auto const& txs = block.transactions();
     uint32_t pos = 0;
     for (auto const& tx : txs) {
 
         auto const& hash = tx.hash();
 
-        auto res0 = remove_transaction_history_db(tx, height, db_txn);
-        if (res0 != result_code::success) {
-            return res0;
+        if (history) {
+            auto res0 = remove_transaction_history_db(tx, height, db_txn);
+            if (res0 != result_code::success) {
+                return res0;
+            }
         }
 
-        if (pos > 0) {
+        if (pos > 0 && spend) {
             auto res0 = remove_transaction_spend_db(tx, db_txn);
             if (res0 != result_code::success && res0 != result_code::key_not_found) {
                 return res0;
@@ -213,6 +258,20 @@ result_code internal_database_basis<Clock>::remove_transactions(domain::chain::b
         ++pos;
     }
 
+    if (history) {
+        auto res = unindex_height(index_kind::history, height, db_txn);
+        if (res != result_code::success) {
+            return res;
+        }
+    }
+
+    if (spend) {
+        auto res = unindex_height(index_kind::spend, height, db_txn);
+        if (res != result_code::success) {
+            return res;
+        }
+    }
+
 
     /*auto key = kth_db_make_value(sizeof(height), &height);
     KTH_DB_val value;
@@ -54,6 +54,16 @@ struct KD_API transaction_entry {
     static
     expect<transaction_entry> from_data(byte_reader& reader);
 
+    /// Append the wire encoding of the transaction of a stored entry, reading
+    /// the entry bytes directly (no transaction object is built).
+    static
+    bool to_wire(byte_span data, data_chunk& out);
+
+    /// The height and position of a stored entry, read from its trailing
+    /// fields (the transaction is not read).
+    static
+    bool read_height_position(byte_span data, uint32_t& out_height, uint32_t& out_position);
+
     bool confirmed() const;
 
     //TODO(kth): we don't have spent information
@@ -0,0 +1,117 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_DATABASE_UTXO_CACHE_HPP_
+#define KTH_DATABASE_UTXO_CACHE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <kth/domain.hpp>
+#include <kth/database/define.hpp>
+#include <kth/database/databases/utxo_entry.hpp>
+
+namespace kth::database {
+
+/// Bounded in-memory cache of unspent outputs in front of the utxo table.
+/// Entries are distributed in independently locked shards, each one evicting
+/// its least recently used entries once its share of the entry capacity or of
+/// the (approximate) memory size is reached. A capacity of zero disables the
+/// cache, a size of zero bounds it by entries only.
+/// This class is thread safe.
+struct KD_API utxo_cache {
+    using point_t = domain::chain::point;
+
+    /// The utxo changes of a block, applied once the database commits.
+    struct delta {
+        std::vector<std::pair<point_t, utxo_entry>> created;
+        std::vector<point_t> erased;
+
+        bool empty() const;
+        void clear();
+    };
+
+    explicit
+    utxo_cache(size_t capacity, size_t max_size = 0);
+
+    // Non-copyable, non-movable
+    utxo_cache(utxo_cache const&) = delete;
+    utxo_cache& operator=(utxo_cache const&) = delete;
+
+    bool disabled() const;
+    size_t capacity() const;
+    size_t max_size() const;
+    size_t size() const;
+
+    /// The approximate memory used by the entries, in bytes.
+    size_t bytes() const;
+
+    /// Lookup an entry, counts a hit or a miss.
+    std::optional<utxo_entry> find(point_t const& point) const;
+
+    /// Insert or refresh an entry (as most recently used).
+    void add(point_t const& point, utxo_entry const& entry);
+    void remove(point_t const& point);
+
+    /// Insert an entry read from the database only if no delta was applied
+    /// since the generation was taken (the read could be stale otherwise).
+    void add_if_current(point_t const& point, utxo_entry const& entry, size_t generation);
+
+    /// Insert the created entries and then drop the erased ones.
+    void apply(delta const& changes);
+    void clear();
+
+    /// Incremented each time the cache is changed by a delta.
+    size_t generation() const;
+
+    size_t hits() const;
+    size_t misses() const;
+    float hit_rate() const;
+
+private:
+    static constexpr size_t shard_count = 16;
+
+    struct shard {
+        using lru_list = std::list<point_t>;
+
+        struct item {
+            utxo_entry entry;
+            lru_list::iterator position;
+            size_t bytes;
+        };
+
+        std::mutex mutex;
+        lru_list lru;
+        std::unordered_map<point_t, item> map;
+        size_t bytes = 0;
+    };
+
+    static
+    size_t entry_bytes(utxo_entry const& entry);
+
+    shard& shard_for(point_t const& point) const;
+    void add(shard& target, point_t const& point, utxo_entry const& entry);
+    static
+    void remove(shard& target, point_t const& point);
+
+    size_t const capacity_;
+    size_t const shard_capacity_;
+    size_t const max_size_;
+    size_t const shard_max_size_;
+    mutable std::array<shard, shard_count> shards_;
+    std::atomic<size_t> generation_ {0};
+    mutable std::atomic<size_t> hits_ {0};
+    mutable std::atomic<size_t> misses_ {0};
+};
+
+} // namespace kth::database
+
+#endif // KTH_DATABASE_UTXO_CACHE_HPP_
@@ -16,12 +16,38 @@ result_code internal_database_basis<Clock>::remove_utxo(uint32_t height, domain:
     auto keyarr = point.to_data(KTH_INTERNAL_DB_WIRE);      //TODO(fernando): podría estar afuera de la DBTx
     auto key = kth_db_make_value(keyarr.size(), keyarr.data());                 //TODO(fernando): podría estar afuera de la DBTx
 
+    // Created and spent in the same batch, never written.
+    if (batching_utxos_) {
+        auto const batched = batch_utxos_.find(point);
+        if (batched != batch_utxos_.end()) {
+            utxo_set_pending_.remove(utxo_snapshot_element(keyarr, batched->second));
+            batch_utxos_.erase(batched);
+            utxo_delta_.erased.push_back(point);
+            return result_code::success;
+        }
+    }
+
+    KTH_DB_val value;
+    auto res = kth_db_get(db_txn, dbi_utxo_, &key, &value);
+    if (res == KTH_DB_NOTFOUND) {
+        spdlog::info("[database] Key not found getting UTXO [remove_utxo] {}", res);
+        return result_code::key_not_found;
+    }
+    if (res != KTH_DB_SUCCESS) {
+        spdlog::info("[database] Error getting UTXO [remove_utxo] {}", res);
+        return result_code::other;
+    }
+
+    // The value is only valid until the next write.
+    byte_span const value_span {static_cast<uint8_t const*>(kth_db_get_data(value)), kth_db_get_size(value)};
+    utxo_set_pending_.remove(utxo_snapshot_element(keyarr, value_span));
+
     if (insert_reorg) {
-        auto res0 = insert_reorg_pool(height, key, db_txn);
+        auto res0 = insert_reorg_pool(height, key, value, db_txn);
         if (res0 != result_code::success) return res0;
     }
 
-    auto res = kth_db_del(db_txn, dbi_utxo_, &key, NULL);
+    res = kth_db_del(db_txn, dbi_utxo_, &key, NULL);
     if (res == KTH_DB_NOTFOUND) {
         spdlog::info("[database] Key not found deleting UTXO [remove_utxo] {}", res);
         return result_code::key_not_found;
@@ -30,6 +56,8 @@ result_code internal_database_basis<Clock>::remove_utxo(uint32_t height, domain:
         spdlog::info("[database] Error deleting UTXO [remove_utxo] {}", res);
         return result_code::other;
     }
+
+    utxo_delta_.erased.push_back(point);
     return result_code::success;
 }
 
@@ -40,7 +68,14 @@ result_code internal_database_basis<Clock>::insert_utxo(domain::chain::output_po
 
     auto key = kth_db_make_value(keyarr.size(), keyarr.data());                           //TODO(fernando): podría estar afuera de la DBTx
     auto value = kth_db_make_value(valuearr.size(), valuearr.data());                       //TODO(fernando): podría estar afuera de la DBTx
-    auto res = kth_db_put(db_txn, dbi_utxo_, &key, &value, KTH_DB_NOOVERWRITE);
+
+    // Hashed before the value is moved into the batch.
+    auto const element = utxo_snapshot_element(keyarr, valuearr);
+
+    // Deferred to the end of the batch, see write_batch_utxos.
+    auto res = batching_utxos_
+        ? (batch_utxos_.try_emplace(point, std::move(valuearr)).second ? KTH_DB_SUCCESS : KTH_DB_KEYEXIST)
+        : kth_db_put(db_txn, dbi_utxo_, &key, &value, KTH_DB_NOOVERWRITE);
 
     if (res == KTH_DB_KEYEXIST) {
         spdlog::debug("[database] Duplicate Key inserting UTXO [insert_utxo] {}", res);
@@ -50,6 +85,19 @@ result_code internal_database_basis<Clock>::insert_utxo(domain::chain::output_po
         spdlog::info("[database] Error inserting UTXO [insert_utxo] {}", res);
         return result_code::other;
     }
+
+    utxo_set_pending_.add(element);
+
+    // fixed_data: height (4 bytes), median time past (4 bytes), coinbase (1 byte).
+    if ( ! utxo_cache_.disabled()) {
+        byte_reader reader(fixed_data);
+        auto const height = reader.read_little_endian<uint32_t>();
+        auto const median_time_past = reader.read_little_endian<uint32_t>();
+        auto const coinbase = reader.read_byte();
+        if (height && median_time_past && coinbase) {
+            utxo_delta_.created.emplace_back(point, utxo_entry{output, *height, *median_time_past, *coinbase != 0});
+        }
+    }
     return result_code::success;
 }
 
@@ -18,6 +18,9 @@ struct KD_API utxo_entry {
 
     // Getters
     domain::chain::output const& output() const;
+
+    /// The output shared with the copies of this entry (not copied).
+    domain::chain::prevout_cache const& shared_output() const;
     uint32_t height() const;
     uint32_t median_time_past() const;
     bool coinbase() const;
@@ -31,7 +34,7 @@ struct KD_API utxo_entry {
 
     template <typename W, KTH_IS_WRITER(W)>
     void to_data(W& sink) const {
-        output_.to_data(sink, false);
+        output().to_data(sink, false);
         to_data_fixed(sink, height_, median_time_past_, coinbase_);
     }
 
@@ -71,7 +74,8 @@ private:
     constexpr static
     size_t serialized_size_fixed();
 
-    domain::chain::output output_;
+    // Copies of the entry (i.e. from the utxo cache) share the output.
+    domain::chain::prevout_cache output_;
     uint32_t height_ = max_uint32;
     uint32_t median_time_past_ = max_uint32;
     bool coinbase_;
@@ -0,0 +1,142 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_DATABASE_UTXO_SNAPSHOT_HPP_
+#define KTH_DATABASE_UTXO_SNAPSHOT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include <kth/infrastructure/config/checkpoint.hpp>
+#include <kth/infrastructure/math/hash.hpp>
+#include <kth/infrastructure/math/multiset.hpp>
+#include <kth/infrastructure/utility/data.hpp>
+#include <kth/database/define.hpp>
+
+namespace kth::database {
+
+// UTXO snapshot file layout (integers are little endian):
+//
+//  header:  magic (4), version (4), height (4), block hash (32),
+//           headers (4), utxos (8), utxo commitment (32),
+//           abla commitment (32), checksum (4)
+//  chunks:  kind (1), entries (4), payload size (4), payload, checksum (4)
+//  end:     kind (1) = 0
+//
+// A payload is a sequence of entries (varint size + key, varint size + value),
+// with the keys and values as stored in the block header and utxo tables.
+// The checksums are bitcoin checksums of the preceding header fields and of
+// the payload. The commitment is the ECMH of the utxo entries (key + value).
+// The block hash commits to the headers but not to the ABLA state stored with
+// each of them, the abla commitment chains those (see utxo_snapshot_abla_link).
+
+enum class snapshot_chunk_kind : uint8_t {
+    end = 0,
+    headers = 1,
+    utxos = 2
+};
+
+struct KD_API utxo_snapshot_header {
+    static constexpr uint32_t magic = 0x70616e73;     // "snap"
+    static constexpr uint32_t version = 2;
+    static constexpr size_t serialized_size = 124;
+
+    data_chunk to_data() const;
+
+    /// Parse and check the magic, version and checksum.
+    static
+    std::optional<utxo_snapshot_header> from_data(byte_span data);
+
+    uint32_t height = 0;
+    hash_digest block_hash = null_hash;
+    uint32_t headers = 0;
+    uint64_t utxos = 0;
+    hash_digest commitment = null_hash;
+    hash_digest abla_commitment = null_hash;
+};
+
+/// The values a snapshot is checked against, obtained out of band (i.e. not
+/// from the snapshot file itself).
+struct KD_API utxo_snapshot_trust {
+    hash_digest block_hash = null_hash;
+    hash_digest commitment = null_hash;
+    hash_digest abla_commitment = null_hash;
+    infrastructure::config::checkpoint::list checkpoints;
+    bool retarget = true;
+};
+
+struct KD_API utxo_snapshot_chunk {
+    struct entry {
+        byte_span key;
+        byte_span value;
+    };
+
+    snapshot_chunk_kind kind = snapshot_chunk_kind::end;
+    data_chunk payload;
+
+    // Views into the payload.
+    std::vector<entry> entries;
+};
+
+/// The ECMH element of an unspent output.
+KD_API data_chunk utxo_snapshot_element(byte_span key, byte_span value);
+
+/// The abla commitment up to a header, from the commitment up to the previous
+/// one (null_hash before genesis) and the ABLA state stored with the header.
+KD_API hash_digest utxo_snapshot_abla_link(hash_digest const& previous, uint64_t block_size, uint64_t control_block_size, uint64_t elastic_buffer_size);
+
+/// Streams the entries in chunks of about chunk_size bytes, the header is
+/// written last (over a placeholder), once the counts and commitment are known.
+class KD_API utxo_snapshot_writer {
+public:
+    static constexpr size_t chunk_size = 1024 * 1024;
+
+    explicit
+    utxo_snapshot_writer(std::ostream& stream);
+
+    /// Write the header placeholder, before any entry.
+    bool start();
+
+    /// All the headers (by height) must be added before the utxos.
+    bool add(snapshot_chunk_kind kind, byte_span key, byte_span value);
+
+    /// Flush the last chunk, write the end marker and the final header.
+    bool finish(uint32_t height, hash_digest const& block_hash, hash_digest const& abla_commitment);
+
+    utxo_snapshot_header const& header() const;
+
+private:
+    bool flush();
+
+    std::ostream& stream_;
+    std::streampos start_;
+    snapshot_chunk_kind kind_ = snapshot_chunk_kind::end;
+    data_chunk payload_;
+    uint32_t entries_ = 0;
+    multiset utxos_;
+    utxo_snapshot_header header_;
+};
+
+class KD_API utxo_snapshot_reader {
+public:
+    explicit
+    utxo_snapshot_reader(std::istream& stream);
+
+    /// Read the header, must be the first call.
+    std::optional<utxo_snapshot_header> read_header();
+
+    /// The next chunk (of kind end at the end), nullopt if corrupt.
+    std::optional<utxo_snapshot_chunk> read_chunk();
+
+private:
+    std::istream& stream_;
+};
+
+} // namespace kth::database
+
+#endif // KTH_DATABASE_UTXO_SNAPSHOT_HPP_
@@ -0,0 +1,59 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_DATABASE_INDEXER_HPP
+#define KTH_DATABASE_INDEXER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <kth/database/define.hpp>
+#include <kth/database/databases/internal_database.hpp>
+
+#include <kth/infrastructure/utility/noncopyable.hpp>
+
+namespace kth::database {
+
+#if ! defined(KTH_DB_READONLY)
+
+/// Background writer of an asynchronous index (full mode), on its own thread.
+/// The blocks stored since the last notification are indexed in short write
+/// transactions (bounded by index entries), so the block writer is not stalled.
+/// This class is thread safe.
+struct KD_API indexer : noncopyable {
+    indexer(internal_database& db, index_kind kind, uint32_t entries_per_write);
+    ~indexer();
+
+    /// Start the thread, catching up with the stored blocks.
+    void start();
+
+    /// Stop and join the thread, idempotent.
+    void stop();
+
+    /// New blocks were stored (or removed).
+    void notify();
+
+private:
+    void run();
+
+    internal_database& db_;
+    index_kind const kind_;
+    uint32_t const entries_per_write_;
+    std::atomic<bool> stopped_;
+    std::thread thread_;
+
+    // This is protected by mutex_.
+    bool pending_ = false;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+#endif // ! defined(KTH_DB_READONLY)
+
+} // namespace kth::database
+
+#endif
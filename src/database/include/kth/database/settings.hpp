@@ -25,6 +25,19 @@ struct KD_API settings {
     uint64_t db_max_size;
     bool safe_mode;
     uint32_t cache_capacity;
+    uint32_t cache_size;                // MiB
+
+    /// Initial block download write batching (old blocks only).
+    uint32_t ibd_batch_blocks;
+    uint32_t ibd_batch_size;            // MiB
+    uint32_t ibd_flush_interval;        // seconds
+
+    /// Write the history and spend tables (full mode) on background threads.
+    bool async_indexes;
+
+    /// Empty the history and spend tables (full mode) on open, to be indexed
+    /// again from the stored blocks.
+    bool rebuild_indexes;
 };
 
 } // namespace kth::database
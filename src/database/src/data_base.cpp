@@ -5,6 +5,7 @@
 #include <kth/database/data_base.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
@@ -31,6 +32,13 @@ using namespace std::placeholders;
 
 #define NAME "data_base"
 
+// Index entries (outputs and inputs) written in each write transaction of the
+// asynchronous indexes, the block writer waits for at most one of these.
+constexpr uint32_t index_entries_per_write = 10000;
+
+// How often the batched blocks are checked against the flush interval.
+constexpr std::chrono::seconds flusher_period {1};
+
 // A failure after begin_write is returned without calling end_write.
 // This purposely leaves the local flush lock (as enabled) and inverts the
 // sequence lock. The former prevents usagage after restart and the latter
@@ -73,6 +81,24 @@ bool data_base::create(block const& genesis) {
     // push(genesis, 0);
     push_genesis(genesis);
 
+    closed_ = false;
+    start_indexers();
+    start_flusher();
+    return true;
+}
+
+bool data_base::create_from_snapshot(path const& file, block const& genesis, utxo_snapshot_trust const& trust) {
+    start();
+
+    if ( ! internal_db_->create()) {
+        return false;
+    }
+
+    if (internal_db_->import_utxo_snapshot(file, genesis.hash(), trust) != result_code::success) {
+        internal_db_->close();
+        return false;
+    }
+
     closed_ = false;
     return true;
 }
@@ -84,6 +110,13 @@ bool data_base::open() {
     start();
     auto const opened = internal_db_->open();
     closed_ = false;
+
+#if ! defined(KTH_DB_READONLY)
+    if (opened) {
+        start_indexers();
+        start_flusher();
+    }
+#endif
     return opened;
 }
 
@@ -95,6 +128,11 @@ bool data_base::close() {
     }
 
     closed_ = true;
+
+#if ! defined(KTH_DB_READONLY)
+    stop_flusher();
+    stop_indexers();
+#endif
     auto const closed = internal_db_->close();
     return closed;
 }
@@ -105,9 +143,93 @@ void data_base::start() {
         internal_db_dir,
         settings_.db_mode,
         settings_.reorg_pool_limit,
-        settings_.db_max_size, settings_.safe_mode);
+        settings_.db_max_size, settings_.safe_mode,
+        settings_.cache_capacity,
+        settings_.ibd_batch_blocks,
+        uint64_t(settings_.ibd_batch_size) * 1024 * 1024,
+        settings_.ibd_flush_interval,
+        settings_.async_indexes,
+        uint64_t(settings_.cache_size) * 1024 * 1024,
+        settings_.rebuild_indexes);
+}
+
+#if ! defined(KTH_DB_READONLY)
+
+// private
+void data_base::start_indexers() {
+    if ( ! internal_db_->async_indexes()) {
+        return;
+    }
+
+    for (auto const kind : {index_kind::history, index_kind::spend}) {
+        indexers_.push_back(std::make_unique<indexer>(*internal_db_, kind, index_entries_per_write));
+        indexers_.back()->start();
+    }
 }
 
+// private
+void data_base::stop_indexers() {
+    for (auto& index : indexers_) {
+        index->stop();
+    }
+    indexers_.clear();
+}
+
+// private
+void data_base::notify_indexers() {
+    for (auto& index : indexers_) {
+        index->notify();
+    }
+}
+
+// private
+void data_base::start_flusher() {
+    if (settings_.ibd_batch_blocks == 0 || settings_.ibd_flush_interval == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(flusher_mutex_);
+        flusher_stopped_ = false;
+    }
+
+    flusher_ = std::thread(&data_base::run_flusher, this);
+}
+
+// private
+void data_base::stop_flusher() {
+    {
+        std::lock_guard<std::mutex> lock(flusher_mutex_);
+        flusher_stopped_ = true;
+    }
+
+    flusher_condition_.notify_one();
+
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+}
+
+// private
+void data_base::run_flusher() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(flusher_mutex_);
+            if (flusher_condition_.wait_for(lock, flusher_period, [this] { return flusher_stopped_; })) {
+                return;
+            }
+        }
+
+        // A failed batch is logged and dropped by the database.
+        bool flushed;
+        if (succeed(internal_db_->flush_expired_batch(flushed)) && flushed) {
+            notify_indexers();
+        }
+    }
+}
+
+#endif // ! defined(KTH_DB_READONLY)
+
 // Readers.
 // ----------------------------------------------------------------------------
 
@@ -143,7 +265,7 @@ code data_base::verify_insert(block const& block, size_t height) {
 
     auto res = internal_db_->get_header(height);
 
-    if (res.is_valid()) {
+    if (res.is_valid() || internal_db_->is_batched(height)) {
         return error::store_block_duplicate;
     }
 
@@ -188,6 +310,25 @@ code data_base::insert(domain::chain::block const& block, size_t height) {
         return error::database_insert_failed;   //TODO(fernando): create a new operation_failed
     }
 
+    notify_indexers();
+    return error::success;
+}
+
+code data_base::insert(block_const_ptr block, size_t height) {
+
+    auto const median_time_past = block->header().validation.median_time_past;
+
+    auto const ec = verify_insert(*block, height);
+
+    if (ec) return ec;
+
+    // Old blocks are committed in batches (initial block download).
+    auto res = internal_db_->import_block(block, height, median_time_past);
+    if ( ! succeed(res)) {
+        return error::database_insert_failed;   //TODO(fernando): create a new operation_failed
+    }
+
+    notify_indexers();
     return error::success;
 }
 #endif //! defined(KTH_DB_READONLY)
@@ -216,6 +357,8 @@ code data_base::push(block const& block, size_t height) {
     if ( ! succeed(res)) {
         return error::database_push_failed;   //TODO(fernando): create a new operation_failed
     }
+
+    notify_indexers();
     return error::success;
 }
 
@@ -326,6 +469,8 @@ void data_base::do_push(block_const_ptr block, size_t height, uint32_t median_ti
         return;
     }
     block->validation.end_push = asio::steady_clock::now();
+    notify_indexers();
+
     // This is the end of the block sub-sequence.
     handler(error::success);
 }
@@ -0,0 +1,147 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/database/databases/header_index.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace kth::database {
+
+namespace {
+
+// The hashes are uniformly distributed, 8 bytes are enough as a map key
+// (collisions are resolved against the full hash of the entry).
+uint64_t to_key(hash_digest const& hash) {
+    uint64_t key;
+    std::memcpy(&key, hash.data(), sizeof(key));
+    return key;
+}
+
+} // namespace
+
+bool header_index::empty() const {
+    shared_lock lock(mutex_);
+    return entries_.empty();
+}
+
+size_t header_index::size() const {
+    shared_lock lock(mutex_);
+    return entries_.size();
+}
+
+std::optional<uint32_t> header_index::top() const {
+    shared_lock lock(mutex_);
+    if (entries_.empty()) {
+        return std::nullopt;
+    }
+    return uint32_t(entries_.size() - 1);
+}
+
+std::optional<header_index::entry> header_index::get(uint32_t height) const {
+    shared_lock lock(mutex_);
+    if (height >= entries_.size()) {
+        return std::nullopt;
+    }
+    return entries_[height];
+}
+
+std::optional<uint32_t> header_index::find(hash_digest const& hash) const {
+    shared_lock lock(mutex_);
+    auto const [first, last] = heights_.equal_range(to_key(hash));
+    for (auto it = first; it != last; ++it) {
+        if (entries_[it->second].hash == hash) {
+            return it->second;
+        }
+    }
+    return std::nullopt;
+}
+
+domain::chain::header header_index::get_header(uint32_t height) const {
+    shared_lock lock(mutex_);
+    if (height >= entries_.size()) {
+        return {};
+    }
+    return to_header(height);
+}
+
+domain::chain::header::list header_index::get_headers(uint32_t from, uint32_t to) const {
+    domain::chain::header::list list;
+
+    shared_lock lock(mutex_);
+    if (from > to || from >= entries_.size()) {
+        return list;
+    }
+
+    auto const last = std::min(size_t(to), entries_.size() - 1);
+    list.reserve(last - from + 1);
+    for (auto height = from; height <= last; ++height) {
+        list.push_back(to_header(height));
+    }
+    return list;
+}
+
+bool header_index::push(domain::chain::header const& header, uint64_t block_size, uint64_t control_block_size, uint64_t elastic_buffer_size) {
+    auto const hash = header.hash();
+
+    unique_lock lock(mutex_);
+    auto const previous = entries_.empty() ? null_hash : entries_.back().hash;
+    if (header.previous_block_hash() != previous) {
+        return false;
+    }
+
+    auto const work = entries_.empty() ? uint256_t(0) : entries_.back().work;
+    auto const height = uint32_t(entries_.size());
+
+    entries_.push_back(entry{
+        hash,
+        header.merkle(),
+        header.version(),
+        header.timestamp(),
+        header.bits(),
+        header.nonce(),
+        block_size,
+        control_block_size,
+        elastic_buffer_size,
+        work + header.proof()
+    });
+
+    heights_.emplace(to_key(hash), height);
+    return true;
+}
+
+void header_index::pop() {
+    unique_lock lock(mutex_);
+    if (entries_.empty()) {
+        return;
+    }
+
+    auto const height = uint32_t(entries_.size() - 1);
+    auto const [first, last] = heights_.equal_range(to_key(entries_.back().hash));
+    for (auto it = first; it != last; ++it) {
+        if (it->second == height) {
+            heights_.erase(it);
+            break;
+        }
+    }
+
+    entries_.pop_back();
+}
+
+void header_index::clear() {
+    unique_lock lock(mutex_);
+    entries_.clear();
+    entries_.shrink_to_fit();
+    heights_.clear();
+}
+
+// private
+// precondition: mutex_ is locked and height is indexed.
+domain::chain::header header_index::to_header(uint32_t height) const {
+    auto const& item = entries_[height];
+    auto const& previous = height == 0 ? null_hash : entries_[height - 1].hash;
+    return domain::chain::header(item.version, previous, item.merkle, item.timestamp, item.bits, item.nonce);
+}
+
+} // namespace kth::database
@@ -4,6 +4,7 @@
 
 #include <kth/database/databases/history_entry.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 
@@ -63,6 +64,14 @@ size_t history_entry::serialized_size(domain::chain::point const& point) {
     return sizeof(uint64_t) + point.serialized_size(false) + sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t);
 }
 
+// static
+std::array<uint8_t, history_entry::fixed_size> history_entry::seek_data(uint32_t height) {
+    std::array<uint8_t, fixed_size> data {};
+    auto const bytes = to_little_endian(height);
+    std::copy(bytes.begin(), bytes.end(), data.begin() + height_offset);
+    return data;
+}
+
 // Deserialization.
 //-----------------------------------------------------------------------------
 
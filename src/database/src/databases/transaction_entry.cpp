@@ -12,6 +12,86 @@
 
 namespace kth::database {
 
+namespace {
+
+// The stored transaction (transaction::to_data(sink, false)) is: the outputs,
+// each prefixed by its 4 byte spender height, the inputs, with 2 byte point
+// indexes, and then the locktime and the version as varints. Counts, values,
+// scripts and sequences have the same encoding as in the wire format.
+
+constexpr size_t spender_height_size = sizeof(uint32_t);
+
+bool skip_script(byte_reader& reader) {
+    auto const size = reader.read_size_little_endian();
+    return size && reader.skip(*size);
+}
+
+// Walk the stored outputs, appending them in the wire format if out is set.
+bool walk_outputs(byte_reader& reader, byte_span data, data_chunk* out) {
+    auto const start = reader.position();
+    auto const count = reader.read_size_little_endian();
+    if ( ! count) {
+        return false;
+    }
+
+    if (out != nullptr) {
+        extend_data(*out, data.subspan(start, reader.position() - start));
+    }
+
+    for (size_t i = 0; i < *count; ++i) {
+        if ( ! reader.skip(spender_height_size)) {
+            return false;
+        }
+
+        auto const begin = reader.position();
+        if ( ! reader.skip(sizeof(uint64_t)) || ! skip_script(reader)) {
+            return false;
+        }
+
+        if (out != nullptr) {
+            extend_data(*out, data.subspan(begin, reader.position() - begin));
+        }
+    }
+    return true;
+}
+
+// Walk the stored inputs, appending them in the wire format if out is set.
+bool walk_inputs(byte_reader& reader, byte_span data, data_chunk* out) {
+    auto const start = reader.position();
+    auto const count = reader.read_size_little_endian();
+    if ( ! count) {
+        return false;
+    }
+
+    if (out != nullptr) {
+        extend_data(*out, data.subspan(start, reader.position() - start));
+    }
+
+    for (size_t i = 0; i < *count; ++i) {
+        auto const hash = reader.read_bytes(hash_size);
+        auto const index = reader.read_little_endian<uint16_t>();
+        if ( ! hash || ! index) {
+            return false;
+        }
+
+        // Script and sequence.
+        auto const begin = reader.position();
+        if ( ! skip_script(reader) || ! reader.skip(sizeof(uint32_t))) {
+            return false;
+        }
+
+        if (out != nullptr) {
+            uint32_t const wire_index = *index == max_uint16 ? domain::chain::point::null_index : *index;
+            extend_data(*out, *hash);
+            extend_data(*out, to_little_endian(wire_index));
+            extend_data(*out, data.subspan(begin, reader.position() - begin));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 // void write_position(writer& serial, uint32_t position) {
 //     serial.KTH_POSITION_WRITER(position);
 // }
@@ -92,6 +172,69 @@ expect<transaction_entry> transaction_entry::from_data(byte_reader& reader) {
     return transaction_entry(std::move(*tx), *height, *median_time_past, *position);
 }
 
+// static
+bool transaction_entry::to_wire(byte_span data, data_chunk& out) {
+    // Locate the inputs and read the trailing fields, the wire format starts
+    // with the version, which is stored last.
+    byte_reader reader(data);
+    if ( ! walk_outputs(reader, data, nullptr)) {
+        return false;
+    }
+
+    auto const inputs = data.subspan(reader.position());
+    if ( ! walk_inputs(reader, data, nullptr)) {
+        return false;
+    }
+
+    auto const locktime = reader.read_variable_little_endian();
+    auto const version = reader.read_variable_little_endian();
+    if ( ! locktime || ! version) {
+        return false;
+    }
+
+    extend_data(out, to_little_endian(uint32_t(*version)));
+
+    byte_reader inputs_reader(inputs);
+    byte_reader outputs_reader(data);
+    if ( ! walk_inputs(inputs_reader, inputs, &out) || ! walk_outputs(outputs_reader, data, &out)) {
+        return false;
+    }
+
+    extend_data(out, to_little_endian(uint32_t(*locktime)));
+    return true;
+}
+
+// static
+bool transaction_entry::read_height_position(byte_span data, uint32_t& out_height, uint32_t& out_position) {
+    auto const trailer_size = sizeof(uint32_t) + sizeof(uint32_t) + position_size;
+    if (data.size() < trailer_size) {
+        return false;
+    }
+
+    byte_reader reader(data.last(trailer_size));
+    auto const height = reader.read_little_endian<uint32_t>();
+    if ( ! height || ! reader.skip(sizeof(uint32_t))) {
+        return false;
+    }
+
+    if constexpr (position_size == sizeof(uint32_t)) {
+        auto const position = reader.read_little_endian<uint32_t>();
+        if ( ! position) {
+            return false;
+        }
+        out_position = *position;
+    } else {
+        auto const position = reader.read_little_endian<uint16_t>();
+        if ( ! position) {
+            return false;
+        }
+        out_position = *position;
+    }
+
+    out_height = *height;
+    return true;
+}
+
 // Serialization.
 //-----------------------------------------------------------------------------
 
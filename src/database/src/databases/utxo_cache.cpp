@@ -0,0 +1,217 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/database/databases/utxo_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace kth::database {
+
+// Delta.
+//-----------------------------------------------------------------------------
+
+bool utxo_cache::delta::empty() const {
+    return created.empty() && erased.empty();
+}
+
+void utxo_cache::delta::clear() {
+    created.clear();
+    erased.clear();
+}
+
+// Cache.
+//-----------------------------------------------------------------------------
+
+utxo_cache::utxo_cache(size_t capacity, size_t max_size)
+    : capacity_(capacity)
+    , shard_capacity_(capacity == 0 ? 0 : std::max(size_t(1), capacity / shard_count))
+    , max_size_(max_size)
+    , shard_max_size_(max_size / shard_count)
+{}
+
+bool utxo_cache::disabled() const {
+    return capacity_ == 0;
+}
+
+size_t utxo_cache::capacity() const {
+    return capacity_;
+}
+
+size_t utxo_cache::max_size() const {
+    return max_size_;
+}
+
+size_t utxo_cache::size() const {
+    size_t total = 0;
+    for (auto& target : shards_) {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        total += target.map.size();
+    }
+    return total;
+}
+
+size_t utxo_cache::bytes() const {
+    size_t total = 0;
+    for (auto& target : shards_) {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        total += target.bytes;
+    }
+    return total;
+}
+
+// The txid is a uniformly distributed hash, its first byte is enough to
+// spread the points across the shards.
+utxo_cache::shard& utxo_cache::shard_for(point_t const& point) const {
+    return shards_[(point.hash()[0] ^ point.index()) % shard_count];
+}
+
+std::optional<utxo_entry> utxo_cache::find(point_t const& point) const {
+    if (disabled()) {
+        return std::nullopt;
+    }
+
+    auto& target = shard_for(point);
+    std::lock_guard<std::mutex> lock(target.mutex);
+
+    auto const it = target.map.find(point);
+    if (it == target.map.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    ++hits_;
+    target.lru.splice(target.lru.begin(), target.lru, it->second.position);
+    return it->second.entry;
+}
+
+void utxo_cache::add(point_t const& point, utxo_entry const& entry) {
+    if (disabled()) {
+        return;
+    }
+
+    auto& target = shard_for(point);
+    std::lock_guard<std::mutex> lock(target.mutex);
+    add(target, point, entry);
+}
+
+void utxo_cache::add_if_current(point_t const& point, utxo_entry const& entry, size_t generation) {
+    if (disabled()) {
+        return;
+    }
+
+    auto& target = shard_for(point);
+    std::lock_guard<std::mutex> lock(target.mutex);
+
+    // The generation is bumped before a delta touches any shard, so checking
+    // it under the shard lock orders this insertion before the delta.
+    if (generation_ != generation) {
+        return;
+    }
+
+    add(target, point, entry);
+}
+
+void utxo_cache::remove(point_t const& point) {
+    if (disabled()) {
+        return;
+    }
+
+    auto& target = shard_for(point);
+    std::lock_guard<std::mutex> lock(target.mutex);
+    remove(target, point);
+}
+
+void utxo_cache::apply(delta const& changes) {
+    if (disabled()) {
+        return;
+    }
+
+    ++generation_;
+
+    for (auto const& [point, entry] : changes.created) {
+        add(point, entry);
+    }
+
+    for (auto const& point : changes.erased) {
+        remove(point);
+    }
+}
+
+void utxo_cache::clear() {
+    ++generation_;
+    for (auto& target : shards_) {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.map.clear();
+        target.lru.clear();
+        target.bytes = 0;
+    }
+}
+
+size_t utxo_cache::generation() const {
+    return generation_;
+}
+
+size_t utxo_cache::hits() const {
+    return hits_;
+}
+
+size_t utxo_cache::misses() const {
+    return misses_;
+}
+
+float utxo_cache::hit_rate() const {
+    size_t const queries = hits_ + misses_;
+    return queries == 0 ? 0.0f : (hits_ * 1.0f / queries);
+}
+
+// private static
+// The map and list nodes plus the serialized entry, the script dominates.
+size_t utxo_cache::entry_bytes(utxo_entry const& entry) {
+    constexpr size_t overhead = sizeof(shard::item) + 2 * sizeof(point_t) + 4 * sizeof(void*);
+    return overhead + entry.serialized_size();
+}
+
+// private
+// precondition: target.mutex is locked.
+void utxo_cache::add(shard& target, point_t const& point, utxo_entry const& entry) {
+    auto const bytes = entry_bytes(entry);
+    auto const it = target.map.find(point);
+    if (it != target.map.end()) {
+        target.bytes = target.bytes - it->second.bytes + bytes;
+        it->second.entry = entry;
+        it->second.bytes = bytes;
+        target.lru.splice(target.lru.begin(), target.lru, it->second.position);
+        return;
+    }
+
+    auto const full = [&]() {
+        return target.map.size() >= shard_capacity_ ||
+            (shard_max_size_ != 0 && target.bytes + bytes > shard_max_size_);
+    };
+
+    while ( ! target.lru.empty() && full()) {
+        auto const oldest = target.lru.back();
+        remove(target, oldest);
+    }
+
+    target.lru.push_front(point);
+    target.map.emplace(point, shard::item{entry, target.lru.begin(), bytes});
+    target.bytes += bytes;
+}
+
+// private static
+// precondition: target.mutex is locked.
+void utxo_cache::remove(shard& target, point_t const& point) {
+    auto const it = target.map.find(point);
+    if (it == target.map.end()) {
+        return;
+    }
+
+    target.bytes -= it->second.bytes;
+    target.lru.erase(it->second.position);
+    target.map.erase(it);
+}
+
+} // namespace kth::database
@@ -17,6 +17,10 @@ utxo_entry::utxo_entry(domain::chain::output output, uint32_t height, uint32_t m
 {}
 
 domain::chain::output const& utxo_entry::output() const {
+    return output_.get();
+}
+
+domain::chain::prevout_cache const& utxo_entry::shared_output() const {
     return output_;
 }
 
@@ -34,7 +38,7 @@ bool utxo_entry::coinbase() const {
 
 // private
 void utxo_entry::reset() {
-    output_ = domain::chain::output{};
+    output_.reset();
     height_ = max_uint32;
     median_time_past_ = max_uint32;
     coinbase_ = false;
@@ -56,7 +60,7 @@ size_t utxo_entry::serialized_size_fixed() {
 }
 
 size_t utxo_entry::serialized_size() const {
-    return output_.serialized_size(false) + serialized_size_fixed();
+    return output().serialized_size(false) + serialized_size_fixed();
 }
 
 // Serialization.
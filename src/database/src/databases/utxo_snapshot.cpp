@@ -0,0 +1,282 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/database/databases/utxo_snapshot.hpp>
+
+#include <kth/infrastructure/math/checksum.hpp>
+#include <kth/infrastructure/utility/byte_reader.hpp>
+#include <kth/infrastructure/utility/endian.hpp>
+
+namespace kth::database {
+
+namespace {
+
+// Chunk prefix: kind, entries, payload size.
+constexpr size_t chunk_prefix_size = 1 + 4 + 4;
+
+template <typename Int>
+void append_little_endian(data_chunk& out, Int value) {
+    extend_data(out, to_little_endian(value));
+}
+
+void append_size(data_chunk& out, size_t size) {
+    if (size < 0xfd) {
+        out.push_back(uint8_t(size));
+    } else if (size <= max_uint16) {
+        out.push_back(0xfd);
+        append_little_endian(out, uint16_t(size));
+    } else if (size <= max_uint32) {
+        out.push_back(0xfe);
+        append_little_endian(out, uint32_t(size));
+    } else {
+        out.push_back(0xff);
+        append_little_endian(out, uint64_t(size));
+    }
+}
+
+bool write(std::ostream& stream, byte_span data) {
+    stream.write(reinterpret_cast<char const*>(data.data()), data.size());
+    return bool(stream);
+}
+
+bool read(std::istream& stream, data_chunk& out, size_t size) {
+    out.resize(size);
+    stream.read(reinterpret_cast<char*>(out.data()), size);
+    return stream.gcount() == std::streamsize(size);
+}
+
+} // namespace
+
+// utxo_snapshot_header
+// ----------------------------------------------------------------------------
+
+data_chunk utxo_snapshot_header::to_data() const {
+    data_chunk data;
+    data.reserve(serialized_size);
+    append_little_endian(data, magic);
+    append_little_endian(data, version);
+    append_little_endian(data, height);
+    extend_data(data, block_hash);
+    append_little_endian(data, headers);
+    append_little_endian(data, utxos);
+    extend_data(data, commitment);
+    extend_data(data, abla_commitment);
+    append_little_endian(data, bitcoin_checksum(data));
+    return data;
+}
+
+std::optional<utxo_snapshot_header> utxo_snapshot_header::from_data(byte_span data) {
+    if (data.size() != serialized_size) {
+        return std::nullopt;
+    }
+
+    auto const checksum_size = sizeof(uint32_t);
+    auto const body = data.first(serialized_size - checksum_size);
+    auto const checksum = from_little_endian_unsafe<uint32_t>(data.last(checksum_size));
+    if (bitcoin_checksum(body) != checksum) {
+        return std::nullopt;
+    }
+
+    byte_reader reader(body);
+    auto const magic_read = reader.read_little_endian<uint32_t>();
+    auto const version_read = reader.read_little_endian<uint32_t>();
+    if ( ! magic_read || *magic_read != magic || ! version_read || *version_read != version) {
+        return std::nullopt;
+    }
+
+    auto const height = reader.read_little_endian<uint32_t>();
+    auto const block_hash = reader.read_packed<hash_digest>();
+    auto const headers = reader.read_little_endian<uint32_t>();
+    auto const utxos = reader.read_little_endian<uint64_t>();
+    auto const commitment = reader.read_packed<hash_digest>();
+    auto const abla_commitment = reader.read_packed<hash_digest>();
+    if ( ! height || ! block_hash || ! headers || ! utxos || ! commitment || ! abla_commitment) {
+        return std::nullopt;
+    }
+
+    utxo_snapshot_header header;
+    header.height = *height;
+    header.block_hash = *block_hash;
+    header.headers = *headers;
+    header.utxos = *utxos;
+    header.commitment = *commitment;
+    header.abla_commitment = *abla_commitment;
+    return header;
+}
+
+data_chunk utxo_snapshot_element(byte_span key, byte_span value) {
+    return build_chunk({key, value});
+}
+
+hash_digest utxo_snapshot_abla_link(hash_digest const& previous, uint64_t block_size, uint64_t control_block_size, uint64_t elastic_buffer_size) {
+    data_chunk data;
+    data.reserve(hash_size + 3 * sizeof(uint64_t));
+    extend_data(data, previous);
+    append_little_endian(data, block_size);
+    append_little_endian(data, control_block_size);
+    append_little_endian(data, elastic_buffer_size);
+    return bitcoin_hash(data);
+}
+
+// utxo_snapshot_writer
+// ----------------------------------------------------------------------------
+
+utxo_snapshot_writer::utxo_snapshot_writer(std::ostream& stream)
+    : stream_(stream)
+{}
+
+bool utxo_snapshot_writer::start() {
+    start_ = stream_.tellp();
+    payload_.reserve(chunk_size + chunk_size / 8);
+    return write(stream_, utxo_snapshot_header{}.to_data());
+}
+
+bool utxo_snapshot_writer::add(snapshot_chunk_kind kind, byte_span key, byte_span value) {
+    if (kind == snapshot_chunk_kind::end) {
+        return false;
+    }
+
+    if (kind != kind_ || payload_.size() >= chunk_size) {
+        if ( ! flush()) {
+            return false;
+        }
+        kind_ = kind;
+    }
+
+    append_size(payload_, key.size());
+    extend_data(payload_, key);
+    append_size(payload_, value.size());
+    extend_data(payload_, value);
+    ++entries_;
+
+    if (kind == snapshot_chunk_kind::headers) {
+        ++header_.headers;
+    } else {
+        ++header_.utxos;
+        utxos_.add(utxo_snapshot_element(key, value));
+    }
+    return true;
+}
+
+bool utxo_snapshot_writer::flush() {
+    if (entries_ == 0) {
+        return true;
+    }
+
+    data_chunk prefix;
+    prefix.reserve(chunk_prefix_size);
+    prefix.push_back(uint8_t(kind_));
+    append_little_endian(prefix, entries_);
+    append_little_endian(prefix, uint32_t(payload_.size()));
+
+    auto const checksum = to_little_endian(bitcoin_checksum(payload_));
+    auto const written = write(stream_, prefix) && write(stream_, payload_) && write(stream_, checksum);
+
+    payload_.clear();
+    entries_ = 0;
+    return written;
+}
+
+bool utxo_snapshot_writer::finish(uint32_t height, hash_digest const& block_hash, hash_digest const& abla_commitment) {
+    if ( ! flush() || ! write(stream_, to_chunk(uint8_t(snapshot_chunk_kind::end)))) {
+        return false;
+    }
+
+    header_.height = height;
+    header_.block_hash = block_hash;
+    header_.commitment = utxos_.hash();
+    header_.abla_commitment = abla_commitment;
+
+    auto const end = stream_.tellp();
+    stream_.seekp(start_);
+    auto const written = write(stream_, header_.to_data());
+    stream_.seekp(end);
+    return written && bool(stream_.flush());
+}
+
+utxo_snapshot_header const& utxo_snapshot_writer::header() const {
+    return header_;
+}
+
+// utxo_snapshot_reader
+// ----------------------------------------------------------------------------
+
+utxo_snapshot_reader::utxo_snapshot_reader(std::istream& stream)
+    : stream_(stream)
+{}
+
+std::optional<utxo_snapshot_header> utxo_snapshot_reader::read_header() {
+    data_chunk data;
+    if ( ! read(stream_, data, utxo_snapshot_header::serialized_size)) {
+        return std::nullopt;
+    }
+    return utxo_snapshot_header::from_data(data);
+}
+
+std::optional<utxo_snapshot_chunk> utxo_snapshot_reader::read_chunk() {
+    data_chunk prefix;
+    if ( ! read(stream_, prefix, 1)) {
+        return std::nullopt;
+    }
+
+    utxo_snapshot_chunk chunk;
+    chunk.kind = snapshot_chunk_kind(prefix[0]);
+    if (chunk.kind == snapshot_chunk_kind::end) {
+        return chunk;
+    }
+
+    if (chunk.kind != snapshot_chunk_kind::headers && chunk.kind != snapshot_chunk_kind::utxos) {
+        return std::nullopt;
+    }
+
+    if ( ! read(stream_, prefix, chunk_prefix_size - 1)) {
+        return std::nullopt;
+    }
+
+    auto const entries = from_little_endian_unsafe<uint32_t>(byte_span(prefix).first(4));
+    auto const size = from_little_endian_unsafe<uint32_t>(byte_span(prefix).last(4));
+
+    // A corrupt size must not cause a huge allocation.
+    if (size > utxo_snapshot_writer::chunk_size * 2) {
+        return std::nullopt;
+    }
+
+    data_chunk checksum;
+    if ( ! read(stream_, chunk.payload, size) || ! read(stream_, checksum, sizeof(uint32_t))) {
+        return std::nullopt;
+    }
+
+    if (bitcoin_checksum(chunk.payload) != from_little_endian_unsafe<uint32_t>(checksum)) {
+        return std::nullopt;
+    }
+
+    chunk.entries.reserve(entries);
+    byte_reader reader(chunk.payload);
+    while ( ! reader.is_exhausted()) {
+        auto const key_size = reader.read_size_little_endian();
+        if ( ! key_size) {
+            return std::nullopt;
+        }
+        auto const key = reader.read_bytes(*key_size);
+        if ( ! key) {
+            return std::nullopt;
+        }
+        auto const value_size = reader.read_size_little_endian();
+        if ( ! value_size) {
+            return std::nullopt;
+        }
+        auto const value = reader.read_bytes(*value_size);
+        if ( ! value) {
+            return std::nullopt;
+        }
+        chunk.entries.push_back({*key, *value});
+    }
+
+    if (chunk.entries.size() != entries) {
+        return std::nullopt;
+    }
+    return chunk;
+}
+
+} // namespace kth::database
@@ -0,0 +1,98 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/database/indexer.hpp>
+
+#include <kth/infrastructure/log/source.hpp>
+
+namespace kth::database {
+
+#if ! defined(KTH_DB_READONLY)
+
+namespace {
+
+char const* index_name(index_kind kind) {
+    return kind == index_kind::history ? "history" : "spend";
+}
+
+} // namespace
+
+indexer::indexer(internal_database& db, index_kind kind, uint32_t entries_per_write)
+    : db_(db)
+    , kind_(kind)
+    , entries_per_write_(entries_per_write == 0 ? 1 : entries_per_write)
+    , stopped_(true)
+{}
+
+indexer::~indexer() {
+    stop();
+}
+
+void indexer::start() {
+    if ( ! stopped_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = false;
+        pending_ = true;
+    }
+
+    thread_ = std::thread(&indexer::run, this);
+}
+
+void indexer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+
+    condition_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void indexer::notify() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = true;
+    }
+
+    condition_.notify_one();
+}
+
+// private
+void indexer::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return stopped_ || pending_; });
+            if (stopped_) {
+                return;
+            }
+            pending_ = false;
+        }
+
+        // A failure is retried on the next notification.
+        uint32_t indexed;
+        do {
+            if (db_.index_blocks(kind_, entries_per_write_, indexed) != result_code::success) {
+                spdlog::error("[database] Error writing the {} index.", index_name(kind_));
+                break;
+            }
+        } while (indexed > 0 && ! stopped_);
+
+        auto const height = db_.get_index_height(kind_);
+        if (height) {
+            spdlog::debug("[database] The {} index is at height {}.", index_name(kind_), *height);
+        }
+    }
+}
+
+#endif // ! defined(KTH_DB_READONLY)
+
+} // namespace kth::database
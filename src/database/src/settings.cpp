@@ -43,6 +43,12 @@ settings::settings()
     , db_max_size(get_db_max_size_mainnet(db_mode))
     , safe_mode(true)
     , cache_capacity(0)
+    , cache_size(256)
+    , ibd_batch_blocks(500)
+    , ibd_batch_size(256)
+    , ibd_flush_interval(60)
+    , async_indexes(false)
+    , rebuild_indexes(false)
 {}
 
 settings::settings(domain::config::network context)
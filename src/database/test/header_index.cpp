@@ -0,0 +1,100 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <kth/database.hpp>
+
+using namespace kth;
+using namespace kth::domain::chain;
+using namespace kth::database;
+
+namespace {
+
+header make_header(hash_digest const& previous, uint32_t nonce) {
+    return header{1, previous, null_hash, 1000 + nonce, 0x207fffff, nonce};
+}
+
+} // namespace
+
+TEST_CASE("header index  construct  empty", "[header index]") {
+    header_index const index;
+    REQUIRE(index.empty());
+    REQUIRE(index.size() == 0u);
+    REQUIRE( ! index.top());
+    REQUIRE( ! index.get(0));
+    REQUIRE( ! index.get_header(0).is_valid());
+}
+
+TEST_CASE("header index  push linked  found", "[header index]") {
+    header_index index;
+    auto const genesis = make_header(null_hash, 0);
+    auto const next = make_header(genesis.hash(), 1);
+
+    REQUIRE(index.push(genesis, 1, 2, 3));
+    REQUIRE(index.push(next, 4, 5, 6));
+    REQUIRE(index.size() == 2u);
+    REQUIRE(*index.top() == 1u);
+    REQUIRE(*index.find(genesis.hash()) == 0u);
+    REQUIRE(*index.find(next.hash()) == 1u);
+    REQUIRE(index.get_header(1) == next);
+
+    auto const entry = index.get(1);
+    REQUIRE(entry);
+    REQUIRE(entry->block_size == 4u);
+    REQUIRE(entry->control_block_size == 5u);
+    REQUIRE(entry->elastic_buffer_size == 6u);
+    REQUIRE(entry->work == genesis.proof() + next.proof());
+}
+
+TEST_CASE("header index  push unlinked  false", "[header index]") {
+    header_index index;
+    auto const genesis = make_header(null_hash, 0);
+
+    REQUIRE(index.push(genesis, 0, 0, 0));
+    REQUIRE( ! index.push(make_header(null_hash, 1), 0, 0, 0));
+    REQUIRE(index.size() == 1u);
+}
+
+TEST_CASE("header index  get headers  stops at top", "[header index]") {
+    header_index index;
+    auto previous = null_hash;
+    for (uint32_t nonce = 0; nonce < 5; ++nonce) {
+        auto const item = make_header(previous, nonce);
+        REQUIRE(index.push(item, 0, 0, 0));
+        previous = item.hash();
+    }
+
+    auto const headers = index.get_headers(2, 10);
+    REQUIRE(headers.size() == 3u);
+    REQUIRE(headers.back().hash() == previous);
+    REQUIRE(index.get_headers(5, 10).empty());
+    REQUIRE(index.get_headers(3, 2).empty());
+}
+
+TEST_CASE("header index  pop  not found", "[header index]") {
+    header_index index;
+    auto const genesis = make_header(null_hash, 0);
+    auto const next = make_header(genesis.hash(), 1);
+    REQUIRE(index.push(genesis, 0, 0, 0));
+    REQUIRE(index.push(next, 0, 0, 0));
+
+    index.pop();
+    REQUIRE(index.size() == 1u);
+    REQUIRE( ! index.find(next.hash()));
+    REQUIRE(*index.find(genesis.hash()) == 0u);
+
+    // The popped height can be replaced by another header.
+    auto const other = make_header(genesis.hash(), 2);
+    REQUIRE(index.push(other, 0, 0, 0));
+    REQUIRE(*index.find(other.hash()) == 1u);
+}
+
+TEST_CASE("header index  clear  empty", "[header index]") {
+    header_index index;
+    REQUIRE(index.push(make_header(null_hash, 0), 0, 0, 0));
+    index.clear();
+    REQUIRE(index.empty());
+    REQUIRE(index.push(make_header(null_hash, 0), 0, 0, 0));
+}
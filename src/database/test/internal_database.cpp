@@ -3,6 +3,9 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
 #include <print>
 #include <tuple>
 
@@ -769,6 +772,183 @@ TEST_CASE("internal database  insert block genesis and get transaction", "[None]
     REQUIRE(tx2.is_valid() == true);
 }
 
+TEST_CASE("internal database  get block data  equals wire encoding", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = get_block(orig_enc);
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = get_block(spender_enc);
+
+    // Full mode assembles the block from the stored transactions.
+    for (auto const mode : {db_mode_type::full, db_mode_type::blocks}) {
+        std::error_code ec;
+        remove_all(DIRECTORY, ec);
+        REQUIRE(create_directories(DIRECTORY, ec));
+
+        internal_database db(db_path, mode, 10000000, db_size, true);
+        REQUIRE(db.open());
+        REQUIRE(db.push_block(orig, 0, 1) == result_code::success);
+        REQUIRE(db.push_block(spender, 1, 1) == result_code::success);
+
+        REQUIRE(db.get_block_data(0) == orig.to_data());
+        REQUIRE(db.get_block_data(1) == spender.to_data());
+        REQUIRE(db.get_block_data(2).empty());
+
+        auto const by_hash = db.get_block_data(spender.hash());
+        REQUIRE(by_hash.first == spender.to_data());
+        REQUIRE(by_hash.second == 1u);
+    }
+}
+
+TEST_CASE("internal database  get block tx hashes and transaction position  stored index", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = get_block(orig_enc);
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = get_block(spender_enc);
+
+    internal_database db(db_path, db_mode_type::full, 10000000, db_size, true);
+    REQUIRE(db.open());
+    REQUIRE(db.push_block(orig, 0, 1) == result_code::success);
+    REQUIRE(db.push_block(spender, 1, 1) == result_code::success);
+
+    REQUIRE(db.get_block_tx_hashes(1) == spender.to_hashes());
+    REQUIRE(db.get_block_tx_hashes(2).empty());
+
+    uint32_t height;
+    uint32_t position;
+    REQUIRE(db.get_transaction_position(spender.transactions()[1].hash(), height, position) == result_code::success);
+    REQUIRE(height == 1u);
+    REQUIRE(position == 1u);
+    REQUIRE(db.get_transaction_position(null_hash, height, position) == result_code::key_not_found);
+
+    domain::chain::block out_block;
+    REQUIRE(db.pop_block(out_block) == result_code::success);
+    REQUIRE(db.get_block_tx_hashes(1).empty());
+}
+
+TEST_CASE("internal database  async indexes  written by index blocks", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = get_block(orig_enc);
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = get_block(spender_enc);
+
+    hash_digest txid;
+    REQUIRE(decode_hash(txid, "f5d8ee39a430901c91a5917b9f2dc19d6d1a0e9cea205b009ca73dd04470b9a6"));
+    auto const address = domain::wallet::payment_address("1JBSCVF6VM6QjFZyTnbpLjoCJTQEqVbepG");
+
+    internal_database db(db_path, db_mode_type::full, 10000000, db_size, true, 0, 0, 0, 0, true);
+    REQUIRE(db.open());
+    REQUIRE(db.async_indexes());
+    REQUIRE(db.push_block(orig, 0, 1) == result_code::success);
+    REQUIRE(db.push_block(spender, 1, 1) == result_code::success);
+
+    // The block writer does not index.
+    REQUIRE( ! db.get_index_height(index_kind::history));
+    REQUIRE(db.get_history(address.hash20(), max_uint32, 0).empty());
+    REQUIRE( ! db.get_spend(output_point{txid, 0}).is_valid());
+
+    // Bounded by entries: the first block has a single output, the second
+    // two outputs and an input (the coinbase input is not indexed).
+    uint32_t indexed;
+    REQUIRE(db.index_blocks(index_kind::history, 1, indexed) == result_code::success);
+    REQUIRE(indexed == 1u);
+    REQUIRE(db.index_blocks(index_kind::history, 10, indexed) == result_code::success);
+    REQUIRE(indexed == 1u);
+    REQUIRE(db.index_blocks(index_kind::spend, 1, indexed) == result_code::success);
+    REQUIRE(indexed == 2u);
+    REQUIRE(db.index_blocks(index_kind::spend, 1, indexed) == result_code::success);
+    REQUIRE(indexed == 0u);
+
+    REQUIRE(db.get_index_height(index_kind::history) == 1u);
+    REQUIRE(db.get_index_height(index_kind::spend) == 1u);
+
+    // The spent output is read from the transactions table.
+    auto const history = db.get_history(address.hash20(), max_uint32, 0);
+    REQUIRE(history.size() == 2u);
+    REQUIRE(history[1].kind == point_kind::spend);
+    REQUIRE(history[1].height == 1u);
+    REQUIRE(db.get_spend(output_point{txid, 0}).is_valid());
+
+    // The reorganization removes the indexed entries.
+    domain::chain::block out_block;
+    REQUIRE(db.pop_block(out_block) == result_code::success);
+    REQUIRE(db.get_index_height(index_kind::history) == 0u);
+    REQUIRE(db.get_index_height(index_kind::spend) == 0u);
+    REQUIRE(db.get_history(address.hash20(), max_uint32, 0).size() == 1u);
+    REQUIRE( ! db.get_spend(output_point{txid, 0}).is_valid());
+
+    REQUIRE(db.reset_index(index_kind::history) == result_code::success);
+    REQUIRE( ! db.get_index_height(index_kind::history));
+    REQUIRE(db.get_history(address.hash20(), max_uint32, 0).empty());
+}
+
+TEST_CASE("internal database  rebuild indexes  indexed again on open", "[None]") {
+    auto const genesis = get_genesis();
+    auto const address = domain::wallet::payment_address("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa");
+
+    {
+        internal_database db(db_path, db_mode_type::full, 10000000, db_size, true);
+        REQUIRE(db.open());
+        REQUIRE(db.push_block(genesis, 0, 1) == result_code::success);
+        REQUIRE(db.reset_index(index_kind::history) == result_code::success);
+        REQUIRE(db.get_history(address.hash20(), max_uint32, 0).empty());
+    }
+
+    internal_database db(db_path, db_mode_type::full, 10000000, db_size, true, 0, 0, 0, 0, false, 0, true);
+    REQUIRE(db.open());
+    REQUIRE(db.get_index_height(index_kind::history) == 0u);
+    REQUIRE(db.get_index_height(index_kind::spend) == 0u);
+    REQUIRE(db.get_history(address.hash20(), max_uint32, 0).size() == 1u);
+}
+
+TEST_CASE("internal database  get history  seek by height both directions", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = get_block(orig_enc);
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = get_block(spender_enc);
+
+    auto const address = domain::wallet::payment_address("1JBSCVF6VM6QjFZyTnbpLjoCJTQEqVbepG");
+
+    internal_database db(db_path, db_mode_type::full, 10000000, db_size, true);
+    REQUIRE(db.open());
+    REQUIRE(db.push_block(orig, 0, 1) == result_code::success);
+    REQUIRE(db.push_block(spender, 1, 1) == result_code::success);
+
+    auto history = db.get_history(address.hash20(), max_uint32, 1);
+    REQUIRE(history.size() == 1u);
+    REQUIRE(history[0].height == 1u);
+    REQUIRE(history[0].kind == point_kind::spend);
+
+    history = db.get_history(address.hash20(), 1, 0);
+    REQUIRE(history.size() == 1u);
+    REQUIRE(history[0].height == 0u);
+
+    REQUIRE(db.get_history(address.hash20(), max_uint32, 2).empty());
+
+    // The latest entries first.
+    history = db.get_latest_history(address.hash20(), max_uint32, max_uint32);
+    REQUIRE(history.size() == 2u);
+    REQUIRE(history[0].height == 1u);
+    REQUIRE(history[1].height == 0u);
+
+    history = db.get_latest_history(address.hash20(), max_uint32, 0);
+    REQUIRE(history.size() == 1u);
+    REQUIRE(history[0].height == 0u);
+
+    REQUIRE(db.get_latest_history(null_short_hash, max_uint32, max_uint32).empty());
+}
+
 TEST_CASE("internal database  insert duplicate block by hash", "[None]") {
     auto const genesis = get_genesis();
 
@@ -1030,6 +1210,247 @@ TEST_CASE("internal database  old blocks 0", "[None]") {
     );
 }
 
+TEST_CASE("internal database  import old blocks  committed in a single batch", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = std::make_shared<domain::chain::block const>(get_block(orig_enc));
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = std::make_shared<domain::chain::block const>(get_block(spender_enc));
+
+    // A year later, both blocks are old.
+    using my_clock = dummy_clock<1284613427 + 365 * 24 * 60 * 60>;
+
+    internal_database_basis<my_clock> db(db_path, db_mode_type::full, 86, db_size, true, 0, 2);
+    REQUIRE(db.open());
+
+    REQUIRE(db.import_block(orig, 0, 1) == result_code::success);
+    REQUIRE(db.is_batched(0));
+    REQUIRE( ! db.get_header(0).is_valid());
+
+    REQUIRE(db.import_block(spender, 1, 1) == result_code::success);
+    REQUIRE( ! db.is_batched(0));
+    REQUIRE(db.get_header(0).is_valid());
+    REQUIRE(db.get_header(1).is_valid());
+
+    // Created and spent within the batch.
+    REQUIRE( ! db.get_utxo(output_point{orig->transactions()[0].hash(), 0}).is_valid());
+    REQUIRE(db.get_utxo(output_point{spender->transactions()[0].hash(), 0}).is_valid());
+    REQUIRE(db.get_utxo(output_point{spender->transactions()[1].hash(), 0}).is_valid());
+}
+
+TEST_CASE("internal database  import old blocks  failed batch dropped", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = std::make_shared<domain::chain::block const>(get_block(orig_enc));
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = std::make_shared<domain::chain::block const>(get_block(spender_enc));
+
+    using my_clock = dummy_clock<1284613427 + 365 * 24 * 60 * 60>;
+
+    internal_database_basis<my_clock> db(db_path, db_mode_type::full, 86, db_size, true, 0, 2);
+    REQUIRE(db.open());
+    REQUIRE(db.push_block(*orig, 0, 1) == result_code::success);
+
+    // The header at height 0 is already stored, the batch can't be committed.
+    REQUIRE(db.import_block(orig, 0, 1) == result_code::success);
+    REQUIRE(db.import_block(spender, 1, 1) != result_code::success);
+    REQUIRE( ! db.is_batched(0));
+    REQUIRE( ! db.is_batched(1));
+    REQUIRE( ! db.get_header(1).is_valid());
+
+    // The failed batch does not block the later writes.
+    REQUIRE(db.import_block(spender, 1, 1) == result_code::success);
+    REQUIRE(db.flush_batch() == result_code::success);
+    REQUIRE(db.get_header(1).is_valid());
+}
+
+TEST_CASE("internal database  flush expired batch  kept until the interval expires", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = std::make_shared<domain::chain::block const>(get_block(orig_enc));
+
+    using my_clock = dummy_clock<1284613427 + 365 * 24 * 60 * 60>;
+
+    // Flushed after an hour (or by an explicit flush).
+    internal_database_basis<my_clock> db(db_path, db_mode_type::full, 86, db_size, true, 0, 10, 0, 3600);
+    REQUIRE(db.open());
+    REQUIRE(db.import_block(orig, 0, 1) == result_code::success);
+
+    bool flushed;
+    REQUIRE(db.flush_expired_batch(flushed) == result_code::success);
+    REQUIRE( ! flushed);
+    REQUIRE(db.is_batched(0));
+
+    REQUIRE(db.flush_batch() == result_code::success);
+    REQUIRE( ! db.is_batched(0));
+    REQUIRE(db.get_header(0).is_valid());
+
+    REQUIRE(db.flush_expired_batch(flushed) == result_code::success);
+    REQUIRE( ! flushed);
+}
+
+// The utxo set hash element of an output, as stored.
+data_chunk utxo_set_element(output_point const& point, output const& out, uint32_t height, bool coinbase) {
+    auto const key = point.to_data(KTH_INTERNAL_DB_WIRE);
+    auto const value = utxo_entry::to_data_with_fixed(out, utxo_entry::to_data_fixed(height, 1, coinbase));
+    return utxo_snapshot_element(key, value);
+}
+
+TEST_CASE("internal database  utxo set hash  follows push and pop", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = get_block(orig_enc);
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = get_block(spender_enc);
+
+    auto const& orig_coinbase = orig.transactions()[0];
+    auto const& spender_coinbase = spender.transactions()[0];
+    auto const& spender_tx = spender.transactions()[1];
+
+    multiset at0;
+    at0.add(utxo_set_element(output_point{orig_coinbase.hash(), 0}, orig_coinbase.outputs()[0], 0, true));
+
+    // The orig coinbase output is spent.
+    multiset at1;
+    at1.add(utxo_set_element(output_point{spender_coinbase.hash(), 0}, spender_coinbase.outputs()[0], 1, true));
+    at1.add(utxo_set_element(output_point{spender_tx.hash(), 0}, spender_tx.outputs()[0], 1, false));
+
+    {
+        internal_database db(db_path, db_mode_type::full, 10000000, db_size, true);
+        REQUIRE(db.open());
+        REQUIRE(db.push_block(orig, 0, 1) == result_code::success);
+        REQUIRE(db.get_utxo_set_hash() == at0.hash());
+
+        REQUIRE(db.push_block(spender, 1, 1) == result_code::success);
+        REQUIRE(db.get_utxo_set_hash() == at1.hash());
+        REQUIRE(db.get_utxo_set_hash(1) == at1.hash());
+        REQUIRE(db.get_utxo_set_hash(0) == at0.hash());
+        REQUIRE( ! db.get_utxo_set_hash(2));
+    }
+
+    // Persisted, and restored by the pop.
+    {
+        internal_database db(db_path, db_mode_type::full, 10000000, db_size, true);
+        REQUIRE(db.open());
+        REQUIRE(db.get_utxo_set_hash() == at1.hash());
+
+        domain::chain::block out_block;
+        REQUIRE(db.pop_block(out_block) == result_code::success);
+        REQUIRE(db.get_utxo_set_hash() == at0.hash());
+        REQUIRE( ! db.get_utxo_set_hash(1));
+    }
+}
+
+TEST_CASE("internal database  utxo set hash  batch equals single pushes", "[None]") {
+    //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
+    std::string orig_enc = "01000000a594fda9d85f69e762e498650d6fdb54d838657cea7841915203170000000000a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f505da904ce6ed5b1b017fe8070101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b015cffffffff0100f2052a01000000434104283338ffd784c198147f99aed2cc16709c90b1522e3b3637b312a6f9130e0eda7081e373a96d36be319710cd5c134aaffba81ff08650d7de8af332fe4d8cde20ac00000000";
+    auto const orig = std::make_shared<domain::chain::block const>(get_block(orig_enc));
+
+    //80000 - 000000000043a8c0fd1d6f726790caa2a406010d19efd2780db27bdbbd93baf6
+    std::string spender_enc = "01000000ba8b9cda965dd8e536670f9ddec10e53aab14b20bacad27b9137190000000000190760b278fe7b8565fda3b968b918d5fd997f993b23674c0af3b6fde300b38f33a5914ce6ed5b1b01e32f570201000000010000000000000000000000000000000000000000000000000000000000000000ffffffff0704e6ed5b1b014effffffff0100f2052a01000000434104b68a50eaa0287eff855189f949c1c6e5f58b37c88231373d8a59809cbae83059cc6469d65c665ccfd1cfeb75c6e8e19413bba7fbff9bc762419a76d87b16086eac000000000100000001a6b97044d03da79c005b20ea9c0e1a6d9dc12d9f7b91a5911c9030a439eed8f5000000004948304502206e21798a42fae0e854281abd38bacd1aeed3ee3738d9e1446618c4571d1090db022100e2ac980643b0b82c0e88ffdfec6b64e3e6ba35e7ba5fdd7d5d6cc8d25c6b241501ffffffff0100f2052a010000001976a914404371705fa9bd789a2fcd52d2c580b65d35549d88ac00000000";
+    auto const spender = std::make_shared<domain::chain::block const>(get_block(spender_enc));
+
+    auto const& spender_coinbase = spender->transactions()[0];
+    auto const& spender_tx = spender->transactions()[1];
+
+    // Created and spent within the batch, the orig output is never hashed.
+    multiset expected;
+    expected.add(utxo_set_element(output_point{spender_coinbase.hash(), 0}, spender_coinbase.outputs()[0], 1, true));
+    expected.add(utxo_set_element(output_point{spender_tx.hash(), 0}, spender_tx.outputs()[0], 1, false));
+
+    using my_clock = dummy_clock<1284613427 + 365 * 24 * 60 * 60>;
+
+    internal_database_basis<my_clock> db(db_path, db_mode_type::full, 86, db_size, true, 0, 2);
+    REQUIRE(db.open());
+    REQUIRE(db.import_block(orig, 0, 1) == result_code::success);
+    REQUIRE(db.import_block(spender, 1, 1) == result_code::success);
+    REQUIRE(db.get_utxo_set_hash() == expected.hash());
+    REQUIRE(db.get_utxo_set_hash(1) == expected.hash());
+    REQUIRE( ! db.get_utxo_set_hash(0));
+}
+
+TEST_CASE("internal database  import utxo snapshot  checked against the trusted values", "[None]") {
+    auto const genesis = get_genesis();
+    auto const source_path = fs::path(DIRECTORY) / "snapshot_source";
+    auto const target_path = fs::path(DIRECTORY) / "snapshot_target";
+    auto const file = fs::path(DIRECTORY) / "snapshot.bin";
+
+    std::error_code ec;
+    remove_all(source_path, ec);
+    remove_all(target_path, ec);
+
+    std::optional<header_with_abla_state_t> stored;
+    {
+        internal_database db(source_path, db_mode_type::pruned, 10000000, db_size, true);
+        REQUIRE(db.create());
+        REQUIRE(db.push_block(genesis, 0, 1) == result_code::success);
+        REQUIRE(db.export_utxo_snapshot(file) == result_code::success);
+        stored = db.get_header_and_abla_state(0);
+        REQUIRE(stored);
+    }
+
+    std::ifstream stream(file, std::ios::binary);
+    auto const header = utxo_snapshot_reader(stream).read_header();
+    REQUIRE(header);
+    REQUIRE(header->block_hash == genesis.hash());
+
+    utxo_snapshot_trust trust {header->block_hash, header->commitment, header->abla_commitment, {}, true};
+
+    // The ABLA state is committed with the headers.
+    REQUIRE(header->abla_commitment == utxo_snapshot_abla_link(null_hash, std::get<1>(*stored), std::get<2>(*stored), std::get<3>(*stored)));
+
+    // Not the trusted commitment.
+    {
+        auto untrusted = trust;
+        untrusted.commitment = null_hash;
+        internal_database db(target_path, db_mode_type::pruned, 10000000, db_size, true);
+        REQUIRE(db.create());
+        REQUIRE(db.import_utxo_snapshot(file, genesis.hash(), untrusted) != result_code::success);
+    }
+
+    // Not the trusted ABLA state.
+    {
+        auto untrusted = trust;
+        untrusted.abla_commitment = utxo_snapshot_abla_link(null_hash, 1, 1, 1);
+        internal_database db(target_path, db_mode_type::pruned, 10000000, db_size, true);
+        REQUIRE(db.open());
+        REQUIRE(db.import_utxo_snapshot(file, genesis.hash(), untrusted) != result_code::success);
+    }
+
+    // A checkpoint conflict, the incomplete import does not open.
+    {
+        auto conflicting = trust;
+        conflicting.checkpoints.emplace_back(null_hash, 0);
+        internal_database db(target_path, db_mode_type::pruned, 10000000, db_size, true);
+        REQUIRE(db.open());
+        REQUIRE(db.import_utxo_snapshot(file, genesis.hash(), conflicting) == result_code::db_corrupt);
+    }
+
+    {
+        internal_database db(target_path, db_mode_type::pruned, 10000000, db_size, true);
+        REQUIRE( ! db.open());
+    }
+
+    remove_all(target_path, ec);
+
+    {
+        internal_database db(target_path, db_mode_type::pruned, 10000000, db_size, true);
+        REQUIRE(db.create());
+        REQUIRE(db.import_utxo_snapshot(file, genesis.hash(), trust) == result_code::success);
+    }
+
+    internal_database db(target_path, db_mode_type::pruned, 10000000, db_size, true);
+    REQUIRE(db.open());
+    REQUIRE(db.get_header(0).hash() == genesis.hash());
+    REQUIRE(db.get_utxo_set_hash() == header->commitment);
+}
+
 TEST_CASE("internal database  old blocks 1", "[None]") {
     //79880 - 00000000002e872c6fbbcf39c93ef0d89e33484ebf457f6829cbf4b561f3af5a
     // timestamp = 1284561413
@@ -0,0 +1,111 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <kth/database.hpp>
+
+using namespace kth;
+using namespace kth::domain::chain;
+using namespace kth::database;
+
+namespace {
+
+point make_point(uint8_t seed, uint32_t index) {
+    hash_digest hash = null_hash;
+    hash[0] = seed;
+    return point{hash, index};
+}
+
+utxo_entry make_entry(uint32_t height) {
+    return utxo_entry{output{}, height, 0, false};
+}
+
+} // namespace
+
+TEST_CASE("utxo cache  construct capacity 0  disabled", "[utxo cache]") {
+    utxo_cache const cache(0);
+    REQUIRE(cache.disabled());
+    REQUIRE(cache.size() == 0u);
+}
+
+TEST_CASE("utxo cache  add disabled  not found", "[utxo cache]") {
+    utxo_cache cache(0);
+    cache.add(make_point(1, 0), make_entry(42));
+    REQUIRE( ! cache.find(make_point(1, 0)));
+    REQUIRE(cache.size() == 0u);
+}
+
+TEST_CASE("utxo cache  add then find  hit", "[utxo cache]") {
+    utxo_cache cache(100);
+    cache.add(make_point(1, 0), make_entry(42));
+
+    auto const found = cache.find(make_point(1, 0));
+    REQUIRE(found);
+    REQUIRE(found->height() == 42u);
+    REQUIRE(cache.hits() == 1u);
+    REQUIRE(cache.misses() == 0u);
+}
+
+TEST_CASE("utxo cache  find missing  miss", "[utxo cache]") {
+    utxo_cache cache(100);
+    REQUIRE( ! cache.find(make_point(1, 0)));
+    REQUIRE(cache.misses() == 1u);
+    REQUIRE(cache.hit_rate() == 0.0f);
+}
+
+TEST_CASE("utxo cache  add beyond shard capacity  evicts least recently used", "[utxo cache]") {
+    // 16 shards of one entry each, all points below fall in the same shard.
+    utxo_cache cache(16);
+    cache.add(make_point(0, 0), make_entry(1));
+    cache.add(make_point(16, 0), make_entry(2));
+
+    REQUIRE( ! cache.find(make_point(0, 0)));
+    REQUIRE(cache.find(make_point(16, 0)));
+    REQUIRE(cache.size() == 1u);
+}
+
+TEST_CASE("utxo cache  add beyond shard size  evicts least recently used", "[utxo cache]") {
+    utxo_cache probe(100);
+    probe.add(make_point(0, 0), make_entry(1));
+    auto const entry_bytes = probe.bytes();
+    REQUIRE(entry_bytes > 0u);
+
+    // 16 shards of room for one entry each, by size only.
+    utxo_cache cache(100, 16 * entry_bytes);
+    cache.add(make_point(0, 0), make_entry(1));
+    cache.add(make_point(16, 0), make_entry(2));
+
+    REQUIRE( ! cache.find(make_point(0, 0)));
+    REQUIRE(cache.find(make_point(16, 0)));
+    REQUIRE(cache.size() == 1u);
+    REQUIRE(cache.bytes() == entry_bytes);
+
+    cache.remove(make_point(16, 0));
+    REQUIRE(cache.bytes() == 0u);
+}
+
+TEST_CASE("utxo cache  apply delta  adds created and drops erased", "[utxo cache]") {
+    utxo_cache cache(100);
+    cache.add(make_point(1, 0), make_entry(1));
+
+    utxo_cache::delta changes;
+    changes.created.emplace_back(make_point(2, 0), make_entry(2));
+    changes.erased.push_back(make_point(1, 0));
+    cache.apply(changes);
+
+    REQUIRE( ! cache.find(make_point(1, 0)));
+    REQUIRE(cache.find(make_point(2, 0)));
+}
+
+TEST_CASE("utxo cache  add if current after apply  ignored", "[utxo cache]") {
+    utxo_cache cache(100);
+    auto const generation = cache.generation();
+    cache.apply(utxo_cache::delta{});
+    cache.add_if_current(make_point(1, 0), make_entry(1), generation);
+    REQUIRE( ! cache.find(make_point(1, 0)));
+
+    cache.add_if_current(make_point(1, 0), make_entry(1), cache.generation());
+    REQUIRE(cache.find(make_point(1, 0)));
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <sstream>
+
+#include <kth/database.hpp>
+#include <kth/database/databases/utxo_snapshot.hpp>
+
+using namespace kth;
+using namespace kth::database;
+
+namespace {
+
+data_chunk const key1 {1, 2, 3};
+data_chunk const key2 {4, 5, 6};
+data_chunk const value1 {7, 8};
+data_chunk const value2 {9};
+data_chunk const height0 {0, 0, 0, 0};
+
+std::string make_snapshot() {
+    std::stringstream stream;
+    utxo_snapshot_writer writer(stream);
+    REQUIRE(writer.start());
+    REQUIRE(writer.add(snapshot_chunk_kind::headers, height0, value1));
+    REQUIRE(writer.add(snapshot_chunk_kind::utxos, key1, value1));
+    REQUIRE(writer.add(snapshot_chunk_kind::utxos, key2, value2));
+    REQUIRE(writer.finish(0, null_hash, null_hash));
+    return stream.str();
+}
+
+} // namespace
+
+TEST_CASE("utxo snapshot header  round trip  equal", "[utxo snapshot]") {
+    utxo_snapshot_header header;
+    header.height = 42;
+    header.headers = 43;
+    header.utxos = 1000;
+    header.block_hash[0] = 1;
+    header.commitment[0] = 2;
+    header.abla_commitment[0] = 3;
+
+    auto const data = header.to_data();
+    REQUIRE(data.size() == utxo_snapshot_header::serialized_size);
+
+    auto const parsed = utxo_snapshot_header::from_data(data);
+    REQUIRE(parsed);
+    REQUIRE(parsed->height == 42u);
+    REQUIRE(parsed->headers == 43u);
+    REQUIRE(parsed->utxos == 1000u);
+    REQUIRE(parsed->block_hash == header.block_hash);
+    REQUIRE(parsed->commitment == header.commitment);
+    REQUIRE(parsed->abla_commitment == header.abla_commitment);
+}
+
+TEST_CASE("utxo snapshot header  bad checksum  invalid", "[utxo snapshot]") {
+    auto data = utxo_snapshot_header{}.to_data();
+    data[10] ^= 1;
+    REQUIRE( ! utxo_snapshot_header::from_data(data));
+}
+
+TEST_CASE("utxo snapshot  write then read  same entries and commitment", "[utxo snapshot]") {
+    std::stringstream stream(make_snapshot());
+    utxo_snapshot_reader reader(stream);
+
+    auto const header = reader.read_header();
+    REQUIRE(header);
+    REQUIRE(header->headers == 1u);
+    REQUIRE(header->utxos == 2u);
+
+    auto const headers = reader.read_chunk();
+    REQUIRE(headers);
+    REQUIRE(headers->kind == snapshot_chunk_kind::headers);
+    REQUIRE(headers->entries.size() == 1u);
+
+    auto const utxos = reader.read_chunk();
+    REQUIRE(utxos);
+    REQUIRE(utxos->kind == snapshot_chunk_kind::utxos);
+    REQUIRE(utxos->entries.size() == 2u);
+    REQUIRE(data_chunk(utxos->entries[1].key.begin(), utxos->entries[1].key.end()) == key2);
+
+    auto const end = reader.read_chunk();
+    REQUIRE(end);
+    REQUIRE(end->kind == snapshot_chunk_kind::end);
+
+    // The commitment does not depend on the order of the outputs.
+    multiset expected;
+    expected.add(utxo_snapshot_element(key2, value2));
+    expected.add(utxo_snapshot_element(key1, value1));
+    REQUIRE(header->commitment == expected.hash());
+}
+
+TEST_CASE("utxo snapshot  corrupt payload  invalid chunk", "[utxo snapshot]") {
+    auto data = make_snapshot();
+    data[utxo_snapshot_header::serialized_size + 10] ^= 1;
+
+    std::stringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    REQUIRE(reader.read_header());
+    REQUIRE( ! reader.read_chunk());
+}
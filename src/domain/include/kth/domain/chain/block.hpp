@@ -90,6 +90,10 @@ public:
     static
     expect<block> from_data(byte_reader& reader, bool wire = true);
 
+    /// See block_basis::from_data_with_arena.
+    static
+    expect<block> from_data_with_arena(byte_reader& reader, bool wire = true);
+
     // Serialization.
     //-------------------------------------------------------------------------
 
@@ -144,6 +148,10 @@ public:
     size_t total_inputs(bool with_coinbase = true) const;
 
     code check() const;
+
+    /// Does not set validation.start_check, see block_basis::check.
+    code check(bool transactions) const;
+
     code accept(bool transactions = true) const;
     code accept(chain_state const& state, bool transactions = true) const;
     code connect() const;
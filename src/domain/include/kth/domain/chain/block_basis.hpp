@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <vector>
@@ -43,6 +44,12 @@ struct KD_API block_basis {
     block_basis(chain::header const& header, transaction::list&& transactions);
     block_basis(chain::header const& header, transaction::list const& transactions);
 
+    // Copies do not share the arena, their scripts are on the heap.
+    block_basis(block_basis const& x);
+    block_basis(block_basis&& x) = default;
+    block_basis& operator=(block_basis const& x);
+    block_basis& operator=(block_basis&& x) noexcept;
+
     // Operators.
     //-------------------------------------------------------------------------
     bool operator==(block_basis const& x) const;
@@ -54,6 +61,11 @@ struct KD_API block_basis {
     static
     expect<block_basis> from_data(byte_reader& reader, bool /*wire*/);
 
+    /// The script bytes of all the transactions are allocated from a single
+    /// arena, owned by the block and released with it.
+    static
+    expect<block_basis> from_data_with_arena(byte_reader& reader, bool wire);
+
     [[nodiscard]]
     bool is_valid() const;
 
@@ -126,6 +138,17 @@ struct KD_API block_basis {
     [[nodiscard]]
     hash_digest generate_merkle_root() const;
 
+    /// The merkle root of the hashes (null_hash if empty).
+    [[nodiscard]]
+    static
+    hash_digest generate_merkle_root(hash_list merkle);
+
+    /// The sibling hashes from the leaf at the position up to the root
+    /// (empty if the position is out of range or for a single hash).
+    [[nodiscard]]
+    static
+    hash_list generate_merkle_branch(hash_list merkle, size_t position);
+
     [[nodiscard]]
     size_t signature_operations(bool bip16, bool bip141) const;
 
@@ -156,8 +179,9 @@ struct KD_API block_basis {
     [[nodiscard]]
     bool is_valid_merkle_root() const;
 
+    /// Without transactions the merkle root and the transactions are not checked.
     [[nodiscard]]
-    code check(size_t serialized_size_false) const;
+    code check(size_t serialized_size_false, bool transactions = true) const;
 
     [[nodiscard]]
     code check_transactions() const;
@@ -182,6 +206,9 @@ struct KD_API block_basis {
 
 private:
     chain::header header_;
+
+    // Declared before the transactions, so it is released after them.
+    std::shared_ptr<std::pmr::memory_resource> arena_;
     transaction::list transactions_;
 };
 
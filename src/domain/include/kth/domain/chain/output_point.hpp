@@ -11,6 +11,7 @@
 
 #include <kth/domain/chain/output.hpp>
 #include <kth/domain/chain/point.hpp>
+#include <kth/domain/chain/prevout_cache.hpp>
 #include <kth/domain/chain/script.hpp>
 #include <kth/domain/define.hpp>
 #include <kth/infrastructure/utility/container_sink.hpp>
@@ -39,8 +40,8 @@ public:
         uint32_t median_time_past = 0;
 
         /// The output cache contains the output referenced by the input point.
-        /// If the cache.value is not_found (default) the output is not found.
-        output cache = output{};
+        /// If the cache is empty (default) the output is not found.
+        prevout_cache cache{};
 
         //TODO(fernando): add a compilation flag to exclude this...
         /// Tells if the output cache was found in the mempool or in the UTXO Set.
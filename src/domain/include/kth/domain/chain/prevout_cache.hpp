@@ -0,0 +1,60 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_DOMAIN_CHAIN_PREVOUT_CACHE_HPP
+#define KTH_DOMAIN_CHAIN_PREVOUT_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include <kth/domain/chain/output.hpp>
+#include <kth/domain/chain/script.hpp>
+#include <kth/domain/define.hpp>
+
+namespace kth::domain::chain {
+
+/// The previous output cached on an output point for validation.
+/// The output is shared (not copied) with its source, i.e. the utxo cache
+/// entry, and it is copied on write. An empty cache is the not found output.
+struct KD_API prevout_cache {
+    using ptr = std::shared_ptr<output const>;
+
+    prevout_cache() = default;
+    prevout_cache(ptr output);
+    prevout_cache(output const& x);
+    prevout_cache(output&& x);
+
+    /// The cached output, or the (shared) not found output.
+    [[nodiscard]]
+    output const& get() const;
+
+    [[nodiscard]]
+    ptr const& shared() const;
+
+    [[nodiscard]]
+    bool is_valid() const;
+
+    [[nodiscard]]
+    uint64_t value() const;
+
+    [[nodiscard]]
+    chain::script const& script() const;
+
+    [[nodiscard]]
+    token_data_opt const& token_data() const;
+
+    void set_value(uint64_t value);
+    void set_script(chain::script const& value);
+    void set_script(chain::script&& value);
+    void reset();
+
+private:
+    output& mutate();
+
+    ptr output_;
+};
+
+} // namespace kth::domain::chain
+
+#endif
@@ -9,8 +9,10 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include <kth/domain/constants.hpp>
 #include <kth/domain/define.hpp>
@@ -88,7 +90,7 @@ struct KD_API script_basis {
             sink.write_variable_little_endian(serialized_size(false));
         }
 
-        sink.write_bytes(bytes_);
+        sink.write_bytes(bytes_.data(), bytes_.size());
     }
 
     [[nodiscard]]
@@ -102,7 +104,7 @@ struct KD_API script_basis {
     size_t serialized_size(bool prefix) const;
 
     [[nodiscard]]
-    data_chunk const& bytes() const;
+    byte_span bytes() const;
     // operation::list const& operations() const;
 
     // Utilities (static).
@@ -237,7 +239,11 @@ protected:
         uint32_t active_forks
     );
 
-    data_chunk bytes_;
+    // Unprefixed, copied into the resource (i.e. the arena of a block).
+    script_basis(byte_span encoded, std::pmr::memory_resource* resource);
+
+    // Copies are allocated from the default resource, moves keep theirs.
+    std::pmr::vector<uint8_t> bytes_;
     bool valid_{false};
 };
 
@@ -204,11 +204,12 @@ private:
     // creating the transaction object
 
     // These share a mutex as they are not expected to contend.
-    mutable hash_ptr hash_;
-    mutable hash_ptr outputs_hash_;
-    mutable hash_ptr inpoints_hash_;
-    mutable hash_ptr sequences_hash_;
-    mutable hash_ptr utxos_hash_;
+    // Held inline, so a parsed block does not allocate per cached hash.
+    mutable std::optional<hash_digest> hash_;
+    mutable std::optional<hash_digest> outputs_hash_;
+    mutable std::optional<hash_digest> inpoints_hash_;
+    mutable std::optional<hash_digest> sequences_hash_;
+    mutable std::optional<hash_digest> utxos_hash_;
 
 #if ! defined(__EMSCRIPTEN__)
     mutable upgrade_mutex hash_mutex_;
@@ -178,6 +178,22 @@ data_chunk serialize(uint32_t version, const Message& packet, uint32_t magic) {
     return data;
 }
 
+/// Frame a payload already in the Bitcoin wire protocol encoding (i.e. a
+/// block read from the store) with the message heading.
+inline
+data_chunk serialize(std::string const& command, byte_span payload, uint32_t magic) {
+    auto const heading_size = heading::satoshi_fixed_size();
+    auto const payload_size32 = *safe_unsigned<uint32_t>(payload.size());
+    heading const head(magic, command, payload_size32, bitcoin_checksum(payload));
+
+    data_chunk data;
+    data.reserve(heading_size + payload.size());
+    extend_data(data, head.to_data());
+    extend_data(data, payload);
+    KTH_ASSERT(data.size() == heading_size + payload.size());
+    return data;
+}
+
 // KD_API size_t variable_uint_size(uint64_t value);
 
 } // namespace domain::message
@@ -220,6 +220,19 @@ expect<block> block::from_data(byte_reader& reader, bool wire) {
     return res;
 }
 
+expect<block> block::from_data_with_arena(byte_reader& reader, bool wire) {
+    auto const start_deserialize = asio::steady_clock::now();
+    auto basis = block_basis::from_data_with_arena(reader, wire);
+    auto const end_deserialize = asio::steady_clock::now();
+    if ( ! basis) {
+        return std::unexpected(basis.error());
+    }
+    block res {std::move(*basis)};
+    res.validation.start_deserialize = start_deserialize;
+    res.validation.end_deserialize = end_deserialize;
+    return res;
+}
+
 // Serialization.
 //-----------------------------------------------------------------------------
 
@@ -426,7 +439,11 @@ size_t block::total_inputs(bool with_coinbase) const {
 // These checks are self-contained; blockchain (and so version) independent.
 code block::check() const {
     validation.start_check = asio::steady_clock::now();
-    return block_basis::check(serialized_size());
+    return check(true);
+}
+
+code block::check(bool transactions) const {
+    return block_basis::check(serialized_size(), transactions);
 }
 
 code block::accept(bool transactions) const {
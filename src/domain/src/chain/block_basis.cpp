@@ -59,6 +59,24 @@ block_basis::block_basis(chain::header const& header, transaction::list&& transa
     , transactions_(std::move(transactions))
 {}
 
+block_basis::block_basis(block_basis const& x)
+    : header_(x.header_)
+    , transactions_(x.transactions_)
+{}
+
+block_basis& block_basis::operator=(block_basis const& x) {
+    *this = block_basis(x);
+    return *this;
+}
+
+// The transactions are released before the arena they may be allocated from.
+block_basis& block_basis::operator=(block_basis&& x) noexcept {
+    header_ = std::move(x.header_);
+    transactions_ = std::move(x.transactions_);
+    arena_ = std::move(x.arena_);
+    return *this;
+}
+
 // Operators.
 //-----------------------------------------------------------------------------
 
@@ -78,6 +96,7 @@ void block_basis::reset() {
     header_.reset();
     transactions_.clear();
     transactions_.shrink_to_fit();
+    arena_.reset();
 }
 
 bool block_basis::is_valid() const {
@@ -102,6 +121,24 @@ expect<block_basis> block_basis::from_data(byte_reader& reader, bool wire) {
     return block_basis {*hdr, std::move(*txs)};
 }
 
+// static
+expect<block_basis> block_basis::from_data_with_arena(byte_reader& reader, bool wire) {
+    // The script bytes are bounded by the block size, a single allocation.
+    auto arena = std::make_shared<std::pmr::monotonic_buffer_resource>(std::max(reader.remaining_size(), size_t(1)));
+
+    auto const previous = reader.resource();
+    reader.set_resource(arena.get());
+    auto basis = from_data(reader, wire);
+    reader.set_resource(previous);
+
+    if ( ! basis) {
+        return std::unexpected(basis.error());
+    }
+
+    basis->arena_ = std::move(arena);
+    return basis;
+}
+
 // Serialization.
 //-----------------------------------------------------------------------------
 
@@ -244,32 +281,56 @@ bool block_basis::is_distinct_transaction_set() const {
 }
 
 hash_digest block_basis::generate_merkle_root() const {
-    if (transactions_.empty()) {
+    return generate_merkle_root(to_hashes());
+}
+
+// static
+hash_digest block_basis::generate_merkle_root(hash_list merkle) {
+    static_assert(sizeof(hash_digest) == hash_size, "hashes must be contiguous");
+
+    if (merkle.empty()) {
         return null_hash;
     }
 
-    hash_list update;
-    auto merkle = to_hashes();
+    while (merkle.size() > 1) {
+        // If number of hashes is odd, duplicate last hash in the list.
+        if (merkle.size() % 2 != 0) {
+            merkle.push_back(merkle.back());
+        }
+
+        // Each adjacent pair is a 64 byte input, the level is hashed in place.
+        auto const pairs = merkle.size() / 2;
+        auto const level = reinterpret_cast<uint8_t*>(merkle.data());
+        bitcoin_hash_64(level, level, pairs);
+        merkle.resize(pairs);
+    }
+
+    // There is now only one item in the list.
+    return merkle.front();
+}
 
-    // Initial capacity is half of the original list (clear doesn't reset).
-    update.reserve((merkle.size() + 1) / 2);
+hash_list block_basis::generate_merkle_branch(hash_list merkle, size_t position) {
+    if (position >= merkle.size()) {
+        return {};
+    }
 
+    hash_list branch;
     while (merkle.size() > 1) {
         // If number of hashes is odd, duplicate last hash in the list.
         if (merkle.size() % 2 != 0) {
             merkle.push_back(merkle.back());
         }
 
-        for (auto it = merkle.begin(); it != merkle.end(); it += 2) {
-            update.push_back(bitcoin_hash(build_chunk({it[0], it[1]})));
-        }
+        branch.push_back(merkle[position ^ 1]);
 
-        std::swap(merkle, update);
-        update.clear();
+        auto const pairs = merkle.size() / 2;
+        auto const level = reinterpret_cast<uint8_t*>(merkle.data());
+        bitcoin_hash_64(level, level, pairs);
+        merkle.resize(pairs);
+        position /= 2;
     }
 
-    // There is now only one item in the list.
-    return merkle.front();
+    return branch;
 }
 
 size_t block_basis::non_coinbase_input_count() const {
@@ -415,7 +476,7 @@ code block_basis::connect_transactions(chain_state const& state) const {
 //-----------------------------------------------------------------------------
 
 // These checks are self-contained; blockchain (and so version) independent.
-code block_basis::check(size_t serialized_size_false) const {
+code block_basis::check(size_t serialized_size_false, bool transactions) const {
     code ec;
 
     if ((ec = header_.check())) {
@@ -460,6 +521,10 @@ code block_basis::check(size_t serialized_size_false) const {
         // TODO(legacy): relates height to tx.hash(false) (pool cache).
     }
 
+    if ( ! transactions) {
+        return error::success;
+    }
+
     if ( ! is_valid_merkle_root()) {
         return error::merkle_mismatch;
 
@@ -0,0 +1,73 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/domain/chain/prevout_cache.hpp>
+
+#include <memory>
+#include <utility>
+
+namespace kth::domain::chain {
+
+prevout_cache::prevout_cache(ptr output)
+    : output_(std::move(output))
+{}
+
+prevout_cache::prevout_cache(output const& x)
+    : output_(std::make_shared<output const>(x))
+{}
+
+prevout_cache::prevout_cache(output&& x)
+    : output_(std::make_shared<output const>(std::move(x)))
+{}
+
+output const& prevout_cache::get() const {
+    static output const not_found{};
+    return output_ ? *output_ : not_found;
+}
+
+prevout_cache::ptr const& prevout_cache::shared() const {
+    return output_;
+}
+
+bool prevout_cache::is_valid() const {
+    return output_ && output_->is_valid();
+}
+
+uint64_t prevout_cache::value() const {
+    return get().value();
+}
+
+chain::script const& prevout_cache::script() const {
+    return get().script();
+}
+
+token_data_opt const& prevout_cache::token_data() const {
+    return get().token_data();
+}
+
+void prevout_cache::set_value(uint64_t value) {
+    mutate().set_value(value);
+}
+
+void prevout_cache::set_script(chain::script const& value) {
+    mutate().set_script(value);
+}
+
+void prevout_cache::set_script(chain::script&& value) {
+    mutate().set_script(std::move(value));
+}
+
+void prevout_cache::reset() {
+    output_.reset();
+}
+
+// private
+// The shared output is never modified, a copy replaces it.
+output& prevout_cache::mutate() {
+    auto copy = std::make_shared<output>(get());
+    output_ = copy;
+    return *copy;
+}
+
+} // namespace kth::domain::chain
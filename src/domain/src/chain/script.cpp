@@ -1096,7 +1096,7 @@ code script::verify(transaction const& tx, uint32_t input, uint32_t forks) {
     }
 
     auto const& in = tx.inputs()[input];
-    auto const& prevout = in.previous_output().validation.cache;
+    auto const& prevout = in.previous_output().validation.cache.get();
 
     return verify(tx, input, forks, in.script(), prevout.script(), prevout.value());
 }
@@ -64,10 +64,16 @@ script_basis::script_basis(data_chunk&& encoded, bool prefix) {
     }
 
     // This is an optimization that avoids streaming the encoded bytes.
-    bytes_ = std::move(encoded);
+    bytes_.assign(encoded.begin(), encoded.end());
     valid_ = true;
 }
 
+// private
+script_basis::script_basis(byte_span encoded, std::pmr::memory_resource* resource)
+    : bytes_(encoded.begin(), encoded.end(), resource)
+    , valid_(true)
+{}
+
 script_basis::script_basis(data_chunk const& encoded, bool prefix) {
     byte_reader reader(encoded);
     auto obj = from_data(reader, prefix);
@@ -116,7 +122,8 @@ bool script_basis::from_string(std::string const& mnemonic) {
 // Concurrent read/write is not supported, so no critical section.
 void script_basis::from_operations(operation::list const& ops) {
     ////reset();
-    bytes_ = operations_to_data(ops);
+    auto const data = operations_to_data(ops);
+    bytes_.assign(data.begin(), data.end());
     valid_ = true;
 }
 
@@ -169,7 +176,7 @@ expect<script_basis> script_basis::from_data(byte_reader& reader, bool prefix) {
         if ( ! bytes) {
             return std::unexpected(bytes.error());
         }
-        return script_basis {data_chunk(std::begin(*bytes), std::end(*bytes)), false};
+        return script_basis {*bytes, reader.resource()};
     }
 
     auto const size = reader.read_size_little_endian();
@@ -186,7 +193,7 @@ expect<script_basis> script_basis::from_data(byte_reader& reader, bool prefix) {
     if ( ! bytes) {
         return std::unexpected(bytes.error());
     }
-    return script_basis {data_chunk(std::begin(*bytes), std::end(*bytes)), false};
+    return script_basis {*bytes, reader.resource()};
 }
 
 // static
@@ -200,7 +207,7 @@ expect<script_basis> script_basis::from_data_with_size(byte_reader& reader, size
     if ( ! bytes) {
         return std::unexpected(bytes.error());
     }
-    return script_basis {data_chunk(std::begin(*bytes), std::end(*bytes)), false};
+    return script_basis {*bytes, reader.resource()};
 }
 
 // Serialization.
@@ -248,7 +255,7 @@ size_t script_basis::serialized_size(bool prefix) const {
     return size;
 }
 
-data_chunk const& script_basis::bytes() const {
+byte_span script_basis::bytes() const {
     return bytes_;
 }
 
@@ -306,7 +313,7 @@ std::pair<hash_digest, size_t> script_basis::generate_version_0_signature_hash(
     // Unlike unversioned algorithm this does not allow an invalid input index.
     KTH_ASSERT(input_index < tx.inputs().size());
     auto const& input = tx.inputs()[input_index];
-    auto const& prevout = input.previous_output().validation.cache;
+    auto const& prevout = input.previous_output().validation.cache.get();
     KTH_ASSERT(prevout.is_valid());
     auto const size = preimage_size(script_code.serialized_size(true));
 
@@ -71,7 +71,7 @@ transaction::transaction(transaction const& x, hash_digest const& hash)
     : transaction_basis(x)
     , validation(x.validation)
 {
-    hash_ = std::make_shared<hash_digest>(hash);
+    hash_ = hash;
     // validation = x.validation;
 }
 
@@ -79,7 +79,7 @@ transaction::transaction(transaction&& x, hash_digest const& hash)
     : transaction_basis(std::move(x))
     , validation(std::move(x.validation))
 {
-    hash_ = std::make_shared<hash_digest>(hash);
+    hash_ = hash;
     // validation = std::move(x.validation);
 }
 
@@ -257,7 +257,7 @@ hash_digest transaction::hash() const {
     if ( ! hash_) {
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         hash_mutex_.unlock_upgrade_and_lock(); //TODO(fernando): use RAII
-        hash_ = std::make_shared<hash_digest>(chain::hash(*this));
+        hash_ = chain::hash(*this);
         hash_mutex_.unlock_and_lock_upgrade();
         //-----------------------------------------------------------------
     }
@@ -276,7 +276,7 @@ hash_digest transaction::hash() const {
 
     std::unique_lock lock(hash_mutex_);
     if ( ! hash_) {
-        hash_ = std::make_shared<hash_digest>(chain::hash(*this));
+        hash_ = chain::hash(*this);
     }
     return *hash_;
 #endif
@@ -291,7 +291,7 @@ hash_digest transaction::outputs_hash() const {
     if ( ! outputs_hash_) {
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         hash_mutex_.unlock_upgrade_and_lock();
-        outputs_hash_ = std::make_shared<hash_digest>(to_outputs(*this));
+        outputs_hash_ = to_outputs(*this);
         hash_mutex_.unlock_and_lock_upgrade();
         //-----------------------------------------------------------------
     }
@@ -310,7 +310,7 @@ hash_digest transaction::outputs_hash() const {
     }
     std::unique_lock lock(hash_mutex_);
     if ( ! outputs_hash_) {
-        outputs_hash_ = std::make_shared<hash_digest>(to_outputs(*this));
+        outputs_hash_ = to_outputs(*this);
     }
     return *outputs_hash_;
 
@@ -326,7 +326,7 @@ hash_digest transaction::inpoints_hash() const {
     if ( ! inpoints_hash_) {
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         hash_mutex_.unlock_upgrade_and_lock();
-        inpoints_hash_ = std::make_shared<hash_digest>(to_inpoints(*this));
+        inpoints_hash_ = to_inpoints(*this);
         hash_mutex_.unlock_and_lock_upgrade();
         //-----------------------------------------------------------------
     }
@@ -345,7 +345,7 @@ hash_digest transaction::inpoints_hash() const {
     }
     std::unique_lock lock(hash_mutex_);
     if ( ! inpoints_hash_) {
-        inpoints_hash_ = std::make_shared<hash_digest>(to_inpoints(*this));
+        inpoints_hash_ = to_inpoints(*this);
     }
     return *inpoints_hash_;
 #endif
@@ -360,7 +360,7 @@ hash_digest transaction::sequences_hash() const {
     if ( ! sequences_hash_) {
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         hash_mutex_.unlock_upgrade_and_lock();
-        sequences_hash_ = std::make_shared<hash_digest>(to_sequences(*this));
+        sequences_hash_ = to_sequences(*this);
         hash_mutex_.unlock_and_lock_upgrade();
         //-----------------------------------------------------------------
     }
@@ -379,7 +379,7 @@ hash_digest transaction::sequences_hash() const {
     }
     std::unique_lock lock(hash_mutex_);
     if ( ! sequences_hash_) {
-        sequences_hash_ = std::make_shared<hash_digest>(to_sequences(*this));
+        sequences_hash_ = to_sequences(*this);
     }
     return *sequences_hash_;
 #endif
@@ -394,7 +394,7 @@ hash_digest transaction::utxos_hash() const {
     if ( ! utxos_hash_) {
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         hash_mutex_.unlock_upgrade_and_lock();
-        utxos_hash_ = std::make_shared<hash_digest>(to_utxos(*this));
+        utxos_hash_ = to_utxos(*this);
         hash_mutex_.unlock_and_lock_upgrade();
         //-----------------------------------------------------------------
     }
@@ -413,7 +413,7 @@ hash_digest transaction::utxos_hash() const {
     }
     std::unique_lock lock(hash_mutex_);
     if ( ! utxos_hash_) {
-        utxos_hash_ = std::make_shared<hash_digest>(to_utxos(*this));
+        utxos_hash_ = to_utxos(*this);
     }
     return *utxos_hash_;
 #endif
@@ -423,7 +423,7 @@ hash_digest transaction::utxos_hash() const {
 //-----------------------------------------------------------------------------
 
 void transaction::recompute_hash() {
-    hash_ = nullptr;
+    hash_.reset();
     hash();
 }
 
@@ -647,7 +647,7 @@ code verify(transaction const& tx, uint32_t input, uint32_t forks) {
     }
 
     auto const& in = tx.inputs()[input];
-    auto const& prevout = in.previous_output().validation.cache;
+    auto const& prevout = in.previous_output().validation.cache.get();
     return verify(tx, input, forks, in.script(), prevout.script(), prevout.value());
 
 }
@@ -654,7 +654,7 @@ hash_digest to_sequences(transaction_basis const& tx) {
 
 hash_digest to_utxos(transaction_basis const& tx) {
     auto const sum = [&](size_t total, input const& input) {
-        auto const& prevout = input.previous_output().validation.cache;
+        auto const& prevout = input.previous_output().validation.cache.get();
         auto const missing = !prevout.is_valid();
         total += missing ? 0 : prevout.serialized_size();
         return total;
@@ -669,7 +669,7 @@ hash_digest to_utxos(transaction_basis const& tx) {
     ostream_writer sink_w(ostream);
 
     auto const write = [&](input const& input) {
-        auto const& prevout = input.previous_output().validation.cache;
+        auto const& prevout = input.previous_output().validation.cache.get();
         auto const missing = !prevout.is_valid();
         if (missing) return;
         prevout.to_data(sink_w);
@@ -685,7 +685,7 @@ hash_digest to_utxos(transaction_basis const& tx) {
 uint64_t total_input_value(transaction_basis const& tx) {
     ////static_assert(max_money() < max_uint64, "overflow sentinel invalid");
     auto const sum = [](uint64_t total, input const& input) {
-        auto const& prevout = input.previous_output().validation.cache;
+        auto const& prevout = input.previous_output().validation.cache.get();
         auto const missing = !prevout.is_valid();
 
         // Treat missing previous outputs as zero-valued, no math on sentinel.
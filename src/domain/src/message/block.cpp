@@ -74,8 +74,9 @@ bool block::operator!=(block const& x) const {
 //-----------------------------------------------------------------------------
 
 // static
+// The receive path, the block owns the allocations of its scripts.
 expect<block> block::from_data(byte_reader& reader, uint32_t /*version*/) {
-    auto chain_block = chain::block::from_data(reader);
+    auto chain_block = chain::block::from_data_with_arena(reader);
     if ( ! chain_block) {
         return std::unexpected(chain_block.error());
     }
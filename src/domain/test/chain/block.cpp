@@ -4,6 +4,9 @@
 
 #include <test_helpers.hpp>
 
+#include <memory_resource>
+#include <optional>
+
 using namespace kth;
 using namespace kd;
 
@@ -30,6 +33,27 @@ bool all_valid(chain::transaction::list const& transactions) {
     return valid;
 }
 
+// Test helper, counts the allocations of the scripts read into it.
+struct counting_resource : std::pmr::memory_resource {
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override {
+        ++allocations;
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* pointer, size_t size, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+        return this == &other;
+    }
+};
+
 } // anonymous namespace
 
 // Start Test Suite: chain block tests
@@ -356,6 +380,67 @@ TEST_CASE("block  factory from data 3  genesis mainnet  success", "[block serial
     REQUIRE(genesis.header().merkle() == block.generate_merkle_root());
 }
 
+TEST_CASE("block  from data  reader resource  scripts allocated from it", "[block serialization]") {
+    auto const genesis = chain::block::genesis_mainnet();
+    auto const raw_block = genesis.to_data();
+    auto const& tx = genesis.transactions().front();
+    auto const script_bytes = tx.inputs().front().script().serialized_size(false) +
+        tx.outputs().front().script().serialized_size(false);
+
+    counting_resource resource;
+    byte_reader reader(raw_block);
+    reader.set_resource(&resource);
+
+    auto const block = chain::block::from_data(reader);
+    REQUIRE(block);
+    REQUIRE(*block == genesis);
+    REQUIRE(resource.allocations == 2u);
+    REQUIRE(resource.bytes == script_bytes);
+
+    // Copies are allocated from the default resource.
+    auto const copy = *block;
+    REQUIRE(copy == genesis);
+    REQUIRE(resource.allocations == 2u);
+}
+
+TEST_CASE("block  from data with arena  genesis mainnet  outlived by copies", "[block serialization]") {
+    auto const genesis = chain::block::genesis_mainnet();
+    auto const raw_block = genesis.to_data();
+
+    std::optional<chain::block> copy;
+    {
+        byte_reader reader(raw_block);
+        auto const block = chain::block::from_data_with_arena(reader);
+        REQUIRE(block);
+        REQUIRE(*block == genesis);
+        REQUIRE(block->generate_merkle_root() == genesis.header().merkle());
+        REQUIRE(reader.resource() == std::pmr::get_default_resource());
+        copy = *block;
+    }
+
+    REQUIRE(*copy == genesis);
+    REQUIRE(all_valid(copy->transactions()));
+}
+
+TEST_CASE("block  from data with arena  move assigned over arena block  equal", "[block serialization]") {
+    auto const genesis = chain::block::genesis_mainnet();
+    auto const raw_block = genesis.to_data();
+
+    byte_reader reader1(raw_block);
+    auto block = chain::block::from_data_with_arena(reader1);
+    REQUIRE(block);
+
+    // The replaced transactions are released before their arena.
+    byte_reader reader2(raw_block);
+    auto other = chain::block::from_data_with_arena(reader2);
+    REQUIRE(other);
+    *block = std::move(*other);
+    REQUIRE(*block == genesis);
+
+    *block = genesis;
+    REQUIRE(*block == genesis);
+}
+
 // End Test Suite
 
 // Start Test Suite: block generate merkle root tests
@@ -407,6 +492,32 @@ TEST_CASE("block  generate merkle root  block with multiple transactions  matche
     REQUIRE(header.merkle() == block100k.generate_merkle_root());
 }
 
+TEST_CASE("block  generate merkle branch  every position  folds to the merkle root", "[block generate merkle root]") {
+    hash_list hashes;
+    for (uint8_t i = 0; i < 5; ++i) {
+        hash_digest hash = null_hash;
+        hash[0] = i + 1;
+        hashes.push_back(hash);
+    }
+
+    auto const root = chain::block::generate_merkle_root(hashes);
+
+    for (size_t position = 0; position < hashes.size(); ++position) {
+        auto const branch = chain::block::generate_merkle_branch(hashes, position);
+        REQUIRE(branch.size() == 3u);
+
+        auto node = hashes[position];
+        auto index = position;
+        for (auto const& sibling : branch) {
+            node = index % 2 == 0 ? bitcoin_hash(build_chunk({node, sibling})) : bitcoin_hash(build_chunk({sibling, node}));
+            index /= 2;
+        }
+        REQUIRE(node == root);
+    }
+
+    REQUIRE(chain::block::generate_merkle_branch(hashes, 5).empty());
+}
+
 TEST_CASE("block  header accessor  always  returns initialized value", "[block generate merkle root]") {
     chain::header const header {
         10u,
@@ -0,0 +1,46 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <memory>
+
+using namespace kth;
+using namespace kd;
+
+// Start Test Suite: prevout cache tests
+
+TEST_CASE("prevout cache  default  not found", "[prevout cache]") {
+    chain::prevout_cache const instance;
+    REQUIRE( ! instance.is_valid());
+    REQUIRE( ! instance.shared());
+    REQUIRE(instance.value() == chain::output_basis::not_found);
+}
+
+TEST_CASE("prevout cache  construct from shared  not copied", "[prevout cache]") {
+    auto const output = std::make_shared<chain::output const>(42u, chain::script{}, std::nullopt);
+    chain::prevout_cache const instance(output);
+    chain::prevout_cache const copy = instance;
+    REQUIRE(instance.is_valid());
+    REQUIRE(&instance.get() == output.get());
+    REQUIRE(&copy.get() == output.get());
+    REQUIRE(copy.value() == 42u);
+}
+
+TEST_CASE("prevout cache  set value  shared output unchanged", "[prevout cache]") {
+    auto const output = std::make_shared<chain::output const>(42u, chain::script{}, std::nullopt);
+    chain::prevout_cache instance(output);
+    instance.set_value(7u);
+    REQUIRE(instance.value() == 7u);
+    REQUIRE(output->value() == 42u);
+}
+
+TEST_CASE("prevout cache  reset  not found", "[prevout cache]") {
+    chain::prevout_cache instance(chain::output{42u, chain::script{}, std::nullopt});
+    REQUIRE(instance.is_valid());
+    instance.reset();
+    REQUIRE( ! instance.is_valid());
+}
+
+// End Test Suite
@@ -1027,3 +1027,18 @@ TEST_CASE("chain transaction  hash  block320670  success", "[chain transaction]"
     REQUIRE(to_chunk(tx7) == instance.to_data());
 }
 
+TEST_CASE("chain transaction  hash  set locktime  recomputed", "[chain transaction]") {
+    byte_reader reader(tx7);
+    auto result = chain::transaction::from_data(reader, true);
+    REQUIRE(result);
+    auto instance = std::move(*result);
+    REQUIRE(instance.hash() == tx7_hash);
+
+    instance.set_locktime(instance.locktime() + 1);
+    REQUIRE(instance.hash() != tx7_hash);
+    REQUIRE(instance.hash() == bitcoin_hash(instance.to_data()));
+
+    chain::transaction const copy(instance, tx7_hash);
+    REQUIRE(copy.hash() == tx7_hash);
+}
+
@@ -53,6 +53,7 @@
 #include <kth/infrastructure/math/crypto.hpp>
 #include <kth/infrastructure/math/elliptic_curve.hpp>
 #include <kth/infrastructure/math/hash.hpp>
+#include <kth/infrastructure/math/multiset.hpp>
 #include <kth/infrastructure/math/uint256.hpp>
 
 #include <kth/infrastructure/message/message_tools.hpp>
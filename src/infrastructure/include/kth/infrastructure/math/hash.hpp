@@ -65,6 +65,15 @@ KI_API hash_digest bitcoin_hash(byte_span data);
 KI_API hash_digest litecoin_hash(byte_span data);
 #endif
 
+/// Generate the bitcoin hashes of count consecutive 64 byte inputs (i.e. the
+/// concatenated pairs of a merkle tree level) into count 32 byte outputs.
+/// Several inputs are hashed at once when the cpu allows it.
+/// The outputs may be written over the inputs (out == in).
+KI_API void bitcoin_hash_64(uint8_t* out, uint8_t const* in, size_t count);
+
+/// The sha256 implementation selected for this cpu (i.e. "shani,avx2(8way)").
+KI_API std::string sha256_implementation();
+
 /// Generate a bitcoin short hash.
 KI_API short_hash bitcoin_short_hash(byte_span data);
 
@@ -0,0 +1,55 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_INFRASTRUCTURE_MULTISET_HPP
+#define KTH_INFRASTRUCTURE_MULTISET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <kth/infrastructure/define.hpp>
+#include <kth/infrastructure/math/hash.hpp>
+#include <kth/infrastructure/utility/data.hpp>
+
+namespace kth {
+
+static constexpr size_t multiset_size = 33;
+using multiset_data = byte_array<multiset_size>;
+
+/// Elliptic curve multiset hash (ECMH) of a multiset of byte strings.
+/// The hash does not depend on the order of the elements, elements can be
+/// removed and partial multisets combined, so a set can be hashed in
+/// parallel chunks or maintained incrementally.
+class KI_API multiset {
+public:
+    /// The empty multiset.
+    multiset();
+
+    /// Parse the serialized group element (see to_data), nullopt if invalid.
+    static
+    std::optional<multiset> from_data(multiset_data const& data);
+
+    void add(byte_span element);
+    void remove(byte_span element);
+
+    /// Add all the elements of the other multiset.
+    void combine(multiset const& other);
+
+    bool empty() const;
+
+    /// The commitment to the multiset (all zeros if empty).
+    hash_digest hash() const;
+
+    /// The group element as a compressed point (all zeros if empty).
+    multiset_data to_data() const;
+
+private:
+    // The secp256k1_multiset group element.
+    byte_array<96> state_;
+};
+
+} // namespace kth
+
+#endif
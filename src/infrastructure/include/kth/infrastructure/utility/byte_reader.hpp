@@ -11,6 +11,7 @@
 #include <expected>
 #include <cstring>
 #include <iostream>
+#include <memory_resource>
 
 //TODO: Mover a otro lugar
 
@@ -221,9 +222,20 @@ struct byte_reader {
         position_ = 0;
     }
 
+    /// The memory resource of the bytes copied out of the buffer into the
+    /// deserialized objects (i.e. scripts), the heap by default.
+    std::pmr::memory_resource* resource() const {
+        return resource_;
+    }
+
+    void set_resource(std::pmr::memory_resource* resource) {
+        resource_ = resource;
+    }
+
 private:
     byte_span buffer_;
     size_t position_;
+    std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
 };
 
 // bool starts_with(byte_reader& reader, byte_span value) {
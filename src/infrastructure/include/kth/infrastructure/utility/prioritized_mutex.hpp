@@ -26,6 +26,11 @@ public:
     void lock_low_priority();
     void unlock_low_priority();
 
+    /// Low priority holders that may run concurrently with each other.
+    /// A waiting high priority locker blocks new shared holders.
+    void lock_low_priority_shared();
+    void unlock_low_priority_shared();
+
     void lock_high_priority();
     void unlock_high_priority();
 
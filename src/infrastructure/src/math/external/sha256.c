@@ -100,6 +100,27 @@ void SHA256Pad(SHA256CTX* context);
 void SHA256Transform(uint32_t state[SHA256_STATE_LENGTH],
     uint8_t const block[SHA256_BLOCK_LENGTH]);
 
+static SHA256TransformFunction transform_blocks = SHA256BlocksPortable;
+
+void SHA256SetTransform(SHA256TransformFunction transform)
+{
+    transform_blocks = transform == NULL ? SHA256BlocksPortable : transform;
+}
+
+void SHA256Blocks(uint32_t state[SHA256_STATE_LENGTH], uint8_t const* blocks,
+    size_t count)
+{
+    transform_blocks(state, blocks, count);
+}
+
+void SHA256BlocksPortable(uint32_t state[SHA256_STATE_LENGTH],
+    uint8_t const* blocks, size_t count)
+{
+    for (; count > 0; --count, blocks += SHA256_BLOCK_LENGTH) {
+        SHA256Transform(state, blocks);
+    }
+}
+
 void SHA256_(uint8_t const* input, size_t length,
     uint8_t digest[SHA256_DIGEST_LENGTH])
 {
@@ -143,15 +164,15 @@ void SHA256Update(SHA256CTX* context, uint8_t const* input, size_t length)
     }
 
     memcpy(&context->buf[r], input, 64 - r);
-    SHA256Transform(context->state, context->buf);
+    transform_blocks(context->state, context->buf, 1);
 
     input += 64 - r;
     length -= 64 - r;
 
-    while (length >= 64) {
-        SHA256Transform(context->state, input);
-        input += 64;
-        length -= 64;
+    if (length >= 64) {
+        transform_blocks(context->state, input, length / 64);
+        input += length & ~(size_t)63;
+        length &= 63;
     }
 
     memcpy(context->buf, input, length);
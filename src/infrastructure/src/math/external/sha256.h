@@ -46,6 +46,23 @@ typedef struct SHA256CTX
     uint8_t buf[SHA256_BLOCK_LENGTH];
 } SHA256CTX;
 
+/* Process count consecutive 64 byte blocks into the state. */
+typedef void (*SHA256TransformFunction)(uint32_t state[SHA256_STATE_LENGTH],
+    uint8_t const* blocks, size_t count);
+
+/* Replace the block transform used by all hashing (i.e. by a cpu specific
+ * one), the portable transform is restored when transform is NULL. This is
+ * not thread safe, it is expected to be called once during initialization. */
+void SHA256SetTransform(SHA256TransformFunction transform);
+
+/* Process blocks with the current transform. */
+void SHA256Blocks(uint32_t state[SHA256_STATE_LENGTH], uint8_t const* blocks,
+    size_t count);
+
+/* Process blocks with the portable transform. */
+void SHA256BlocksPortable(uint32_t state[SHA256_STATE_LENGTH],
+    uint8_t const* blocks, size_t count);
+
 void SHA256_(uint8_t const* input, size_t length,
     uint8_t digest[SHA256_DIGEST_LENGTH]);
 
@@ -8,8 +8,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <cerrno>
+#include <cstring>
 #include <new>
 #include <stdexcept>
+#include <string>
+
+#if defined(KTH_SHA256_X86)
+#include <cpuid.h>
+#endif
 
 #include "../math/external/crypto_scrypt.h"
 #include "../math/external/hmac_sha256.h"
@@ -19,6 +25,8 @@
 #include "../math/external/sha1.h"
 #include "../math/external/sha256.h"
 #include "../math/external/sha512.h"
+#include "../math/sha256_kernels.hpp"
+#include "../math/sha256_lanes.hpp"
 
 //TODO(fernando): see what to do with Currency
 // #ifdef KTH_CURRENCY_LTC
@@ -27,6 +35,177 @@
 
 namespace kth {
 
+// Sha256 kernels.
+//-----------------------------------------------------------------------------
+
+namespace {
+
+using double_64_function = void (*)(uint8_t* out, uint8_t const* in);
+
+struct sha256_kernels {
+    std::string name {"standard"};
+    double_64_function double_64_4way = nullptr;
+    double_64_function double_64_8way = nullptr;
+};
+
+void store_big_endian(uint8_t* out, uint32_t value) {
+    auto const bytes = to_big_endian(value);
+    std::copy(bytes.begin(), bytes.end(), out);
+}
+
+// The (64 byte) message and its padding block, then the padded digest.
+void double_64(uint8_t* out, uint8_t const* in) {
+    static constexpr uint8_t message_padding[64] {
+        0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x00
+    };
+
+    uint8_t block[64] {};
+    block[32] = 0x80;
+    block[62] = 0x01;
+
+    uint32_t state[8];
+    std::copy(sha256::initial_state, sha256::initial_state + 8, state);
+    SHA256Blocks(state, in, 1);
+    SHA256Blocks(state, message_padding, 1);
+
+    for (size_t i = 0; i < 8; ++i) {
+        store_big_endian(block + i * 4, state[i]);
+    }
+
+    std::copy(sha256::initial_state, sha256::initial_state + 8, state);
+    SHA256Blocks(state, block, 1);
+
+    for (size_t i = 0; i < 8; ++i) {
+        store_big_endian(out + i * 4, state[i]);
+    }
+}
+
+#if defined(KTH_SHA256_X86)
+
+// The os saves the avx registers on context switches.
+bool avx_enabled() {
+    uint32_t eax;
+    uint32_t edx;
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (eax & 6) == 6;
+}
+
+// Eight arbitrary inputs and their hashes, by the portable transform.
+struct self_test {
+    uint8_t input[8 * 64];
+    uint8_t expected[8 * 32];
+
+    self_test() {
+        for (size_t i = 0; i < sizeof(input); ++i) {
+            input[i] = uint8_t(i * 7 + 3);
+        }
+
+        for (size_t lane = 0; lane < 8; ++lane) {
+            SHA256_(input + lane * 64, 64, expected + lane * 32);
+            SHA256_(expected + lane * 32, 32, expected + lane * 32);
+        }
+    }
+
+    // Compare the kernel with the portable implementation.
+    bool matches(double_64_function kernel, size_t lanes) const {
+        uint8_t actual[8 * 32];
+        kernel(actual, input);
+        return std::memcmp(actual, expected, lanes * 32) == 0;
+    }
+};
+
+#endif
+
+sha256_kernels select_kernels() {
+    sha256_kernels result;
+
+#if defined(KTH_SHA256_X86)
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return result;
+    }
+
+    bool const sse41 = ((ecx >> 19) & 1) != 0;
+    bool const avx = ((ecx >> 27) & 1) != 0 && ((ecx >> 28) & 1) != 0 && avx_enabled();
+    bool avx2 = false;
+    bool shani = false;
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0) {
+        avx2 = avx && ((ebx >> 5) & 1) != 0;
+        shani = sse41 && ((ebx >> 29) & 1) != 0;
+    }
+
+    self_test const test;
+    std::string name;
+
+    if (shani) {
+        SHA256SetTransform(sha256::transform_shani);
+        if (test.matches(double_64, 1)) {
+            name = "shani";
+        } else {
+            SHA256SetTransform(nullptr);
+        }
+    }
+
+    // Eight lanes outrun SHA-NI, four lanes only outrun the portable transform.
+    if (sse41 && ! shani && test.matches(sha256::double_64_4way, 4)) {
+        result.double_64_4way = sha256::double_64_4way;
+        name += name.empty() ? "sse41(4way)" : ",sse41(4way)";
+    }
+
+    if (avx2 && test.matches(sha256::double_64_8way, 8)) {
+        result.double_64_8way = sha256::double_64_8way;
+        name += name.empty() ? "avx2(8way)" : ",avx2(8way)";
+    }
+
+    if ( ! name.empty()) {
+        result.name = name;
+    }
+#endif
+
+    return result;
+}
+
+sha256_kernels const& kernels() {
+    static sha256_kernels const instance = select_kernels();
+    return instance;
+}
+
+// Select the kernels at startup, so every sha256 uses the transform.
+[[maybe_unused]] auto const& selected_kernels = kernels();
+
+} // namespace
+
+void bitcoin_hash_64(uint8_t* out, uint8_t const* in, size_t count) {
+    auto const& selected = kernels();
+
+    if (selected.double_64_8way != nullptr) {
+        for (; count >= 8; count -= 8, out += 8 * 32, in += 8 * 64) {
+            selected.double_64_8way(out, in);
+        }
+    }
+
+    if (selected.double_64_4way != nullptr) {
+        for (; count >= 4; count -= 4, out += 4 * 32, in += 4 * 64) {
+            selected.double_64_4way(out, in);
+        }
+    }
+
+    for (; count > 0; --count, out += 32, in += 64) {
+        double_64(out, in);
+    }
+}
+
+std::string sha256_implementation() {
+    return kernels().name;
+}
+
+// Hashes.
+//-----------------------------------------------------------------------------
+
 hash_digest bitcoin_hash(byte_span data) {
     return sha256_hash(sha256_hash(data));
 }
@@ -0,0 +1,87 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/infrastructure/math/multiset.hpp>
+
+#include <cstring>
+
+#include <secp256k1.h>
+#include <secp256k1_multiset.h>
+
+#include "secp256k1_initializer.hpp"
+
+namespace kth {
+
+namespace {
+
+static_assert(sizeof(secp256k1_multiset) == sizeof(byte_array<96>));
+
+secp256k1_multiset to_secp(byte_array<96> const& state) {
+    secp256k1_multiset result;
+    std::memcpy(result.d, state.data(), state.size());
+    return result;
+}
+
+void from_secp(byte_array<96>& state, secp256k1_multiset const& value) {
+    std::memcpy(state.data(), value.d, state.size());
+}
+
+} // namespace
+
+multiset::multiset() {
+    secp256k1_multiset value;
+    secp256k1_multiset_init(verification.context(), &value);
+    from_secp(state_, value);
+}
+
+std::optional<multiset> multiset::from_data(multiset_data const& data) {
+    secp256k1_multiset value;
+    if (secp256k1_multiset_parse(verification.context(), &value, data.data()) != 1) {
+        return std::nullopt;
+    }
+
+    multiset result;
+    from_secp(result.state_, value);
+    return result;
+}
+
+void multiset::add(byte_span element) {
+    auto value = to_secp(state_);
+    secp256k1_multiset_add(verification.context(), &value, element.data(), element.size());
+    from_secp(state_, value);
+}
+
+void multiset::remove(byte_span element) {
+    auto value = to_secp(state_);
+    secp256k1_multiset_remove(verification.context(), &value, element.data(), element.size());
+    from_secp(state_, value);
+}
+
+void multiset::combine(multiset const& other) {
+    auto value = to_secp(state_);
+    auto const other_value = to_secp(other.state_);
+    secp256k1_multiset_combine(verification.context(), &value, &other_value);
+    from_secp(state_, value);
+}
+
+bool multiset::empty() const {
+    auto const value = to_secp(state_);
+    return secp256k1_multiset_is_empty(verification.context(), &value) == 1;
+}
+
+hash_digest multiset::hash() const {
+    hash_digest result;
+    auto const value = to_secp(state_);
+    secp256k1_multiset_finalize(verification.context(), result.data(), &value);
+    return result;
+}
+
+multiset_data multiset::to_data() const {
+    multiset_data result;
+    auto const value = to_secp(state_);
+    secp256k1_multiset_serialize(verification.context(), result.data(), &value);
+    return result;
+}
+
+} // namespace kth
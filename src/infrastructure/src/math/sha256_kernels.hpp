@@ -0,0 +1,31 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_INFRASTRUCTURE_SHA256_KERNELS_HPP
+#define KTH_INFRASTRUCTURE_SHA256_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// The x86 kernels are compiled (with their own instruction set flags) only
+// when KTH_SHA256_X86 is defined, and are used only if the cpu supports them.
+
+namespace kth::sha256 {
+
+#if defined(KTH_SHA256_X86)
+
+/// Process count 64 byte blocks with the SHA extensions (SHA-NI).
+void transform_shani(uint32_t* state, uint8_t const* blocks, size_t count);
+
+/// Double sha256 of 4 consecutive 64 byte inputs (SSE4.1).
+void double_64_4way(uint8_t* out, uint8_t const* in);
+
+/// Double sha256 of 8 consecutive 64 byte inputs (AVX2).
+void double_64_8way(uint8_t* out, uint8_t const* in);
+
+#endif
+
+} // namespace kth::sha256
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_INFRASTRUCTURE_SHA256_LANES_HPP
+#define KTH_INFRASTRUCTURE_SHA256_LANES_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Double sha256 of several 64 byte inputs at once, one per vector lane.
+// Lanes provides the vector type and operations of an instruction set:
+//   vec, count, add, bit_and, bit_or, bit_xor, shr<N>, shl<N>, set,
+//   read(in, offset) and write(out, offset, value).
+// Each kernel instantiates these with its own (translation unit local) Lanes,
+// so code compiled for one instruction set is never shared with another.
+
+namespace kth::sha256 {
+
+inline constexpr uint32_t initial_state[8] {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+inline constexpr uint32_t round_constants[64] {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+template <typename Lanes, int Bits>
+typename Lanes::vec rotate_right(typename Lanes::vec x) {
+    return Lanes::bit_or(Lanes::template shr<Bits>(x), Lanes::template shl<32 - Bits>(x));
+}
+
+template <typename Lanes>
+typename Lanes::vec xor3(typename Lanes::vec x, typename Lanes::vec y, typename Lanes::vec z) {
+    return Lanes::bit_xor(Lanes::bit_xor(x, y), z);
+}
+
+template <typename Lanes>
+void compress(typename Lanes::vec* state, typename Lanes::vec const* block) {
+    using vec = typename Lanes::vec;
+    using L = Lanes;
+
+    vec w[64];
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = block[i];
+    }
+
+    for (size_t i = 16; i < 64; ++i) {
+        auto const s0 = xor3<L>(rotate_right<L, 7>(w[i - 15]), rotate_right<L, 18>(w[i - 15]), L::template shr<3>(w[i - 15]));
+        auto const s1 = xor3<L>(rotate_right<L, 17>(w[i - 2]), rotate_right<L, 19>(w[i - 2]), L::template shr<10>(w[i - 2]));
+        w[i] = L::add(L::add(w[i - 16], s0), L::add(w[i - 7], s1));
+    }
+
+    auto a = state[0];
+    auto b = state[1];
+    auto c = state[2];
+    auto d = state[3];
+    auto e = state[4];
+    auto f = state[5];
+    auto g = state[6];
+    auto h = state[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto const sigma1 = xor3<L>(rotate_right<L, 6>(e), rotate_right<L, 11>(e), rotate_right<L, 25>(e));
+        auto const choose = L::bit_xor(g, L::bit_and(e, L::bit_xor(f, g)));
+        auto const t1 = L::add(L::add(L::add(h, sigma1), L::add(choose, L::set(round_constants[i]))), w[i]);
+        auto const sigma0 = xor3<L>(rotate_right<L, 2>(a), rotate_right<L, 13>(a), rotate_right<L, 22>(a));
+        auto const majority = L::bit_or(L::bit_and(a, b), L::bit_and(c, L::bit_or(a, b)));
+        auto const t2 = L::add(sigma0, majority);
+        h = g;
+        g = f;
+        f = e;
+        e = L::add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = L::add(t1, t2);
+    }
+
+    state[0] = L::add(state[0], a);
+    state[1] = L::add(state[1], b);
+    state[2] = L::add(state[2], c);
+    state[3] = L::add(state[3], d);
+    state[4] = L::add(state[4], e);
+    state[5] = L::add(state[5], f);
+    state[6] = L::add(state[6], g);
+    state[7] = L::add(state[7], h);
+}
+
+/// sha256(sha256(input)) of Lanes::count consecutive 64 byte inputs.
+/// All the inputs are read before any output is written.
+template <typename Lanes>
+void double_64(uint8_t* out, uint8_t const* in) {
+    using vec = typename Lanes::vec;
+    using L = Lanes;
+
+    vec state[8];
+    vec block[16];
+
+    for (size_t i = 0; i < 8; ++i) {
+        state[i] = L::set(initial_state[i]);
+    }
+
+    for (size_t i = 0; i < 16; ++i) {
+        block[i] = L::read(in, i * 4);
+    }
+
+    compress<L>(state, block);
+
+    // The padding of a 64 byte message.
+    block[0] = L::set(0x80000000);
+    for (size_t i = 1; i < 15; ++i) {
+        block[i] = L::set(0);
+    }
+    block[15] = L::set(512);
+
+    compress<L>(state, block);
+
+    // The padded 32 byte digest.
+    for (size_t i = 0; i < 8; ++i) {
+        block[i] = state[i];
+        state[i] = L::set(initial_state[i]);
+    }
+
+    block[8] = L::set(0x80000000);
+    for (size_t i = 9; i < 15; ++i) {
+        block[i] = L::set(0);
+    }
+    block[15] = L::set(256);
+
+    compress<L>(state, block);
+
+    for (size_t i = 0; i < 8; ++i) {
+        L::write(out, i * 4, state[i]);
+    }
+}
+
+} // namespace kth::sha256
+
+#endif
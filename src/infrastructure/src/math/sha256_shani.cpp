@@ -0,0 +1,88 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Compiled with -msse4.1 -msha.
+
+#include "sha256_kernels.hpp"
+
+#if defined(KTH_SHA256_X86)
+
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+#include "sha256_lanes.hpp"
+
+namespace kth::sha256 {
+
+namespace {
+
+// Byte swap each 32 bit word (the message is big endian).
+__m128i load_message(uint8_t const* in, __m128i mask) {
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), mask);
+}
+
+__m128i load_constants(size_t group) {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(round_constants + group * 4));
+}
+
+} // namespace
+
+void transform_shani(uint32_t* state, uint8_t const* blocks, size_t count) {
+    auto const mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+    // The instructions work on the state ordered as (a, b, e, f), (c, d, g, h).
+    auto temp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0xb1);
+    auto state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state + 4)), 0x1b);
+    auto state0 = _mm_alignr_epi8(temp, state1, 8);
+    state1 = _mm_blend_epi16(state1, temp, 0xf0);
+
+    for (; count > 0; --count, blocks += 64) {
+        auto const saved0 = state0;
+        auto const saved1 = state1;
+        __m128i message[4];
+
+        // Four rounds per group, the schedule of the next groups is computed
+        // in the rolling window of four message vectors.
+        for (size_t group = 0; group < 16; ++group) {
+            auto& current = message[group % 4];
+            if (group < 4) {
+                current = load_message(blocks + group * 16, mask);
+            }
+
+            auto words = _mm_add_epi32(current, load_constants(group));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, words);
+
+            if (group >= 3 && group < 15) {
+                auto& next = message[(group + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(current, message[(group + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, current);
+            }
+
+            words = _mm_shuffle_epi32(words, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, words);
+
+            if (group >= 1 && group < 13) {
+                auto& previous = message[(group + 3) % 4];
+                previous = _mm_sha256msg1_epu32(previous, current);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, saved0);
+        state1 = _mm_add_epi32(state1, saved1);
+    }
+
+    temp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    state0 = _mm_blend_epi16(temp, state1, 0xf0);
+    state1 = _mm_alignr_epi8(state1, temp, 8);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+} // namespace kth::sha256
+
+#endif
@@ -0,0 +1,71 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Compiled with -msse4.1.
+
+#include "sha256_kernels.hpp"
+
+#if defined(KTH_SHA256_X86)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "sha256_lanes.hpp"
+
+namespace kth::sha256 {
+
+namespace {
+
+struct lanes {
+    using vec = __m128i;
+    static constexpr size_t count = 4;
+    static constexpr size_t stride = 64;
+
+    static vec add(vec x, vec y) { return _mm_add_epi32(x, y); }
+    static vec bit_and(vec x, vec y) { return _mm_and_si128(x, y); }
+    static vec bit_or(vec x, vec y) { return _mm_or_si128(x, y); }
+    static vec bit_xor(vec x, vec y) { return _mm_xor_si128(x, y); }
+    static vec set(uint32_t x) { return _mm_set1_epi32(int(x)); }
+
+    template <int Bits>
+    static vec shr(vec x) { return _mm_srli_epi32(x, Bits); }
+
+    template <int Bits>
+    static vec shl(vec x) { return _mm_slli_epi32(x, Bits); }
+
+    static int word(uint8_t const* in) {
+        uint32_t value;
+        std::memcpy(&value, in, sizeof(value));
+        return int(__builtin_bswap32(value));
+    }
+
+    // The big endian word at offset of each input.
+    static vec read(uint8_t const* in, size_t offset) {
+        in += offset;
+        return _mm_set_epi32(word(in + 3 * stride), word(in + 2 * stride), word(in + stride), word(in));
+    }
+
+    // The big endian word at offset of each (32 byte) output.
+    static void write(uint8_t* out, size_t offset, vec x) {
+        alignas(16) uint32_t words[count];
+        _mm_store_si128(reinterpret_cast<vec*>(words), x);
+        for (size_t lane = 0; lane < count; ++lane) {
+            auto const value = __builtin_bswap32(words[lane]);
+            std::memcpy(out + lane * 32 + offset, &value, sizeof(value));
+        }
+    }
+};
+
+} // namespace
+
+void double_64_4way(uint8_t* out, uint8_t const* in) {
+    double_64<lanes>(out, in);
+}
+
+} // namespace kth::sha256
+
+#endif
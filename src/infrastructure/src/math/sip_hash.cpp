@@ -188,4 +188,89 @@ uint64_t sip_hash_uint256_extra(uint64_t k0, uint64_t k1, hash_digest const& val
     return v0 ^ v1 ^ v2 ^ v3;
 }
 
+namespace {
+
+// Number of values hashed side by side by sip_hash_uint256_batch.
+constexpr size_t sip_lanes = 4;
+
+struct sip_lanes_state {
+    uint64_t v0[sip_lanes];
+    uint64_t v1[sip_lanes];
+    uint64_t v2[sip_lanes];
+    uint64_t v3[sip_lanes];
+};
+
+// The lanes are independent, the loop maps to vector instructions.
+inline
+void sip_round(sip_lanes_state& state) {
+    for (size_t lane = 0; lane < sip_lanes; ++lane) {
+        uint64_t& v0 = state.v0[lane];
+        uint64_t& v1 = state.v1[lane];
+        uint64_t& v2 = state.v2[lane];
+        uint64_t& v3 = state.v3[lane];
+        SIPROUND;
+    }
+}
+
+inline
+uint64_t load_uint64(hash_digest const& x, size_t i) {
+    auto const* ptr = x.data() + i * sizeof(uint64_t);
+
+    return ((uint64_t)ptr[0]) | ((uint64_t)ptr[1]) << 8 |
+            ((uint64_t)ptr[2]) << 16 | ((uint64_t)ptr[3]) << 24 |
+            ((uint64_t)ptr[4]) << 32 | ((uint64_t)ptr[5]) << 40 |
+            ((uint64_t)ptr[6]) << 48 | ((uint64_t)ptr[7]) << 56;
+}
+
+} // namespace
+
+void sip_hash_uint256_batch(uint64_t k0, uint64_t k1, hash_digest const* vals, size_t count, uint64_t* out) {
+    size_t first = 0;
+
+    for (; first + sip_lanes <= count; first += sip_lanes) {
+        sip_lanes_state state;
+        for (size_t lane = 0; lane < sip_lanes; ++lane) {
+            state.v0[lane] = 0x736f6d6570736575ULL ^ k0;
+            state.v1[lane] = 0x646f72616e646f6dULL ^ k1;
+            state.v2[lane] = 0x6c7967656e657261ULL ^ k0;
+            state.v3[lane] = 0x7465646279746573ULL ^ k1;
+        }
+
+        for (size_t word = 0; word < sizeof(hash_digest) / sizeof(uint64_t); ++word) {
+            uint64_t d[sip_lanes];
+            for (size_t lane = 0; lane < sip_lanes; ++lane) {
+                d[lane] = load_uint64(vals[first + lane], word);
+                state.v3[lane] ^= d[lane];
+            }
+            sip_round(state);
+            sip_round(state);
+            for (size_t lane = 0; lane < sip_lanes; ++lane) {
+                state.v0[lane] ^= d[lane];
+            }
+        }
+
+        for (size_t lane = 0; lane < sip_lanes; ++lane) {
+            state.v3[lane] ^= uint64_t(4) << 59;
+        }
+        sip_round(state);
+        sip_round(state);
+        for (size_t lane = 0; lane < sip_lanes; ++lane) {
+            state.v0[lane] ^= uint64_t(4) << 59;
+            state.v2[lane] ^= 0xFF;
+        }
+        sip_round(state);
+        sip_round(state);
+        sip_round(state);
+        sip_round(state);
+
+        for (size_t lane = 0; lane < sip_lanes; ++lane) {
+            out[first + lane] = state.v0[lane] ^ state.v1[lane] ^ state.v2[lane] ^ state.v3[lane];
+        }
+    }
+
+    for (; first < count; ++first) {
+        out[first] = sip_hash_uint256(k0, k1, vals[first]);
+    }
+}
+
 } // namespace kth
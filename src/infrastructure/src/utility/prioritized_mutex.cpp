@@ -34,6 +34,25 @@ void prioritized_mutex::unlock_low_priority()
 }
 }
 
+void prioritized_mutex::lock_low_priority_shared()
+{
+    // Queue behind a high priority locker that owns the next mutex.
+    if (prioritize_) {
+        next_mutex_.lock_shared();
+    }
+
+    data_mutex_.lock_shared();
+
+    if (prioritize_) {
+        next_mutex_.unlock_shared();
+    }
+}
+
+void prioritized_mutex::unlock_low_priority_shared()
+{
+    data_mutex_.unlock_shared();
+}
+
 void prioritized_mutex::lock_high_priority()
 {
     if (prioritize_) {
@@ -39,6 +39,37 @@ TEST_CASE("sha256 hash test", "[hash tests]") {
     REQUIRE(encode_base16(hash) == "3a6eb0790f39ac87c94f3856b2dd2c5d110e6811602261a9a923d3bb23adc8b7");
 }
 
+TEST_CASE("sha256 hash multiple blocks test", "[hash tests]") {
+    // One million 'a', processed in runs of many blocks.
+    data_chunk const chunk(1000000, 'a');
+    auto const hash = sha256_hash(chunk);
+    REQUIRE(encode_base16(hash) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_CASE("bitcoin hash 64 matches bitcoin hash test", "[hash tests]") {
+    REQUIRE( ! sha256_implementation().empty());
+
+    // Enough inputs to use every lane width and the remainder.
+    for (size_t count = 0; count <= 19; ++count) {
+        data_chunk input(count * 64);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = uint8_t(i * 31 + count);
+        }
+
+        data_chunk output(count * hash_size);
+        bitcoin_hash_64(output.data(), input.data(), count);
+
+        for (size_t i = 0; i < count; ++i) {
+            auto const expected = bitcoin_hash(byte_span(input.data() + i * 64, 64));
+            REQUIRE(std::equal(expected.begin(), expected.end(), output.begin() + i * hash_size));
+        }
+
+        // In place.
+        bitcoin_hash_64(input.data(), input.data(), count);
+        REQUIRE(std::equal(output.begin(), output.end(), input.begin()));
+    }
+}
+
 TEST_CASE("sha512 hash test", "[hash tests]") {
     data_chunk const chunk{ 'd', 'a', 't', 'a' };
     auto const long_hash = sha512_hash(chunk);
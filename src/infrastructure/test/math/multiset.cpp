@@ -0,0 +1,94 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+#include <kth/infrastructure.hpp>
+
+using namespace kth;
+
+// Start Test Suite: multiset tests
+
+namespace {
+
+data_chunk const element1 {1, 2, 3};
+data_chunk const element2 {4, 5, 6, 7};
+data_chunk const element3 {8};
+
+} // namespace
+
+TEST_CASE("multiset  construct  empty with null hash", "[multiset]") {
+    multiset const set;
+    REQUIRE(set.empty());
+    REQUIRE(set.hash() == null_hash);
+    REQUIRE(set.to_data() == multiset_data{});
+}
+
+TEST_CASE("multiset  add  not empty", "[multiset]") {
+    multiset set;
+    set.add(element1);
+    REQUIRE( ! set.empty());
+    REQUIRE(set.hash() != null_hash);
+}
+
+TEST_CASE("multiset  add different order  same hash", "[multiset]") {
+    multiset set1;
+    set1.add(element1);
+    set1.add(element2);
+    set1.add(element3);
+
+    multiset set2;
+    set2.add(element3);
+    set2.add(element1);
+    set2.add(element2);
+
+    REQUIRE(set1.hash() == set2.hash());
+}
+
+TEST_CASE("multiset  add then remove  same hash as before", "[multiset]") {
+    multiset set;
+    set.add(element1);
+    auto const expected = set.hash();
+
+    set.add(element2);
+    REQUIRE(set.hash() != expected);
+
+    set.remove(element2);
+    REQUIRE(set.hash() == expected);
+
+    set.remove(element1);
+    REQUIRE(set.empty());
+}
+
+TEST_CASE("multiset  combine  same hash as adding all", "[multiset]") {
+    multiset all;
+    all.add(element1);
+    all.add(element2);
+    all.add(element3);
+
+    multiset left;
+    left.add(element1);
+
+    multiset right;
+    right.add(element2);
+    right.add(element3);
+
+    left.combine(right);
+    REQUIRE(left.hash() == all.hash());
+}
+
+TEST_CASE("multiset  to data from data  round trip", "[multiset]") {
+    multiset set;
+    set.add(element1);
+    set.add(element2);
+
+    auto const parsed = multiset::from_data(set.to_data());
+    REQUIRE(parsed);
+    REQUIRE(parsed->hash() == set.hash());
+
+    auto const empty = multiset::from_data(multiset_data{});
+    REQUIRE(empty);
+    REQUIRE(empty->empty());
+}
+
+// End Test Suite
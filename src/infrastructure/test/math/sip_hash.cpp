@@ -0,0 +1,46 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <vector>
+
+#include <test_helpers.hpp>
+#include <kth/infrastructure.hpp>
+#include <kth/infrastructure/math/sip_hash.hpp>
+
+using namespace kth;
+
+// Start Test Suite: sip hash tests
+
+namespace {
+
+constexpr uint64_t k0 = 0x0706050403020100ULL;
+constexpr uint64_t k1 = 0x0F0E0D0C0B0A0908ULL;
+
+std::vector<hash_digest> make_values(size_t count) {
+    std::vector<hash_digest> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < hash_size; ++j) {
+            values[i][j] = uint8_t(i * 31 + j * 7);
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+TEST_CASE("sip hash uint256 batch  empty  no output", "[sip hash]") {
+    sip_hash_uint256_batch(k0, k1, nullptr, 0, nullptr);
+}
+
+TEST_CASE("sip hash uint256 batch  uneven count  matches scalar", "[sip hash]") {
+    auto const values = make_values(11);
+    std::vector<uint64_t> out(values.size());
+    sip_hash_uint256_batch(k0, k1, values.data(), values.size(), out.data());
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        REQUIRE(out[i] == sip_hash_uint256(k0, k1, values[i]));
+    }
+}
+
+// End Test Suite
@@ -0,0 +1,62 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test_helpers.hpp>
+
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <kth/infrastructure.hpp>
+
+using namespace kth;
+
+// Start Test Suite: prioritized mutex tests
+
+TEST_CASE("prioritized mutex  lock low priority shared  concurrent holders", "[prioritized mutex]") {
+    prioritized_mutex mutex;
+    mutex.lock_low_priority_shared();
+
+    // A second shared holder must not block on the first one.
+    std::thread other([&] {
+        mutex.lock_low_priority_shared();
+        mutex.unlock_low_priority_shared();
+    });
+    other.join();
+
+    mutex.unlock_low_priority_shared();
+}
+
+TEST_CASE("prioritized mutex  lock high priority  waits for shared holders", "[prioritized mutex]") {
+    prioritized_mutex mutex;
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::latch started(1);
+
+    auto const record = [&](int event) {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back(event);
+    };
+
+    mutex.lock_low_priority_shared();
+
+    std::thread high([&] {
+        started.count_down();
+        mutex.lock_high_priority();
+        record(2);
+        mutex.unlock_high_priority();
+    });
+
+    // The high priority lock can only be taken after the shared release,
+    // whatever the interleaving of the two threads.
+    started.wait();
+    record(1);
+    mutex.unlock_low_priority_shared();
+    high.join();
+
+    REQUIRE(order == std::vector<int>{1, 2});
+}
+
+// End Test Suite
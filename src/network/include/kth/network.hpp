@@ -20,9 +20,11 @@
 #include <kth/network/hosts.hpp>
 #include <kth/network/message_subscriber.hpp>
 #include <kth/network/p2p.hpp>
+#include <kth/network/payload_pool.hpp>
 #include <kth/network/proxy.hpp>
 #include <kth/network/settings.hpp>
 #include <kth/network/version.hpp>
+#include <kth/network/wire_cache.hpp>
 #include <kth/network/protocols/protocol.hpp>
 #include <kth/network/protocols/protocol_address_31402.hpp>
 #include <kth/network/protocols/protocol_events.hpp>
@@ -12,6 +12,7 @@
 #include <kth/domain.hpp>
 #include <kth/network/channel.hpp>
 #include <kth/network/define.hpp>
+#include <kth/network/payload_pool.hpp>
 #include <kth/network/settings.hpp>
 
 namespace kth::network {
@@ -27,7 +28,7 @@ public:
     using accept_handler = std::function<void(code const&, channel::ptr)>;
 
     /// Construct an instance.
-    acceptor(threadpool& pool, settings const& settings);
+    acceptor(threadpool& pool, settings const& settings, payload_pool::ptr buffers);
 
     /// Validate acceptor stopped.
     ~acceptor();
@@ -50,6 +51,7 @@ private:
     std::atomic<bool> stopped_;
     threadpool& pool_;
     settings const& settings_;
+    payload_pool::ptr const buffers_;
     mutable dispatcher dispatch_;
 
     // These are protected by mutex.
@@ -13,6 +13,7 @@
 #include <string>
 #include <kth/domain.hpp>
 #include <kth/network/define.hpp>
+#include <kth/network/payload_pool.hpp>
 #include <kth/network/message_subscriber.hpp>
 #include <kth/network/proxy.hpp>
 #include <kth/network/settings.hpp>
@@ -27,7 +28,7 @@ public:
     using ptr = std::shared_ptr<channel>;
 
     /// Construct an instance.
-    channel(threadpool& pool, socket::ptr socket, settings const& settings);
+    channel(threadpool& pool, socket::ptr socket, settings const& settings, payload_pool::ptr buffers);
 
     void start(result_handler handler) override;
 
@@ -12,6 +12,7 @@
 #include <kth/domain.hpp>
 #include <kth/network/channel.hpp>
 #include <kth/network/define.hpp>
+#include <kth/network/payload_pool.hpp>
 #include <kth/network/settings.hpp>
 
 namespace kth::network {
@@ -27,7 +28,7 @@ public:
     using connect_handler = std::function<void(code const& ec, channel::ptr)>;
 
     /// Construct an instance.
-    connector(threadpool& pool, settings const& settings);
+    connector(threadpool& pool, settings const& settings, payload_pool::ptr buffers);
 
     /// Validate connector stopped.
     ~connector();
@@ -58,6 +59,7 @@ private:
     std::atomic<bool> stopped_;
     threadpool& pool_;
     settings const& settings_;
+    payload_pool::ptr const buffers_;
     mutable dispatcher dispatch_;
 
     // These are protected by mutex.
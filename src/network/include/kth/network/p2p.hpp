@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,11 +20,13 @@
 #include <kth/network/define.hpp>
 #include <kth/network/hosts.hpp>
 #include <kth/network/message_subscriber.hpp>
+#include <kth/network/payload_pool.hpp>
 #include <kth/network/sessions/session_inbound.hpp>
 #include <kth/network/sessions/session_manual.hpp>
 #include <kth/network/sessions/session_outbound.hpp>
 #include <kth/network/sessions/session_seed.hpp>
 #include <kth/network/settings.hpp>
+#include <kth/network/wire_cache.hpp>
 
 namespace kth::network {
 
@@ -55,9 +58,17 @@ public:
         auto const join_handler = synchronize(handle_complete, channels.size(),
             "p2p_join", synchronizer_terminate::on_count);
 
-        // No pre-serialize, channels may have different protocol versions.
+        // Serialize (and checksum) once per negotiated protocol version.
+        std::map<uint32_t, wire_cache::payload_ptr> payloads;
+
         for (auto const channel: channels) {
-            channel->send(message, std::bind(&p2p::handle_send, this, std::placeholders::_1, channel, handle_channel, join_handler));
+            auto const version = channel->negotiated_version();
+            auto& payload = payloads[version];
+            if ( ! payload) {
+                payload = std::make_shared<data_chunk const>(domain::message::serialize(version, message, settings_.identifier));
+            }
+
+            channel->send_serialized(payload, message.command, std::bind(&p2p::handle_send, this, std::placeholders::_1, channel, handle_channel, join_handler));
         }
     }
 
@@ -127,6 +138,12 @@ public:
     virtual
     threadpool& thread_pool();
 
+    /// Serialized messages shared by all channels (relayed blocks and txs).
+    wire_cache& relay_cache();
+
+    /// Large payload buffers shared by all channels.
+    payload_pool::ptr payload_buffers() const;
+
     // Subscriptions.
     // ------------------------------------------------------------------------
 
@@ -272,6 +289,8 @@ private:
     pending_channels pending_close_;
     stop_subscriber::ptr stop_subscriber_;
     channel_subscriber::ptr channel_subscriber_;
+    wire_cache relay_cache_;
+    payload_pool::ptr const payload_buffers_;
 };
 
 } // namespace kth::network
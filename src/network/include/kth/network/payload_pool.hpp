@@ -0,0 +1,72 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_NETWORK_PAYLOAD_POOL_HPP
+#define KTH_NETWORK_PAYLOAD_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <kth/domain.hpp>
+#include <kth/network/define.hpp>
+
+namespace kth::network {
+
+/// Pool of large payload buffers shared by all channels.
+/// Channels read small payloads into their own buffer (grown on demand up
+/// to small_size) and borrow a buffer from the pool for larger payloads
+/// (i.e. blocks), returning it once the message is parsed.
+/// This class is thread safe.
+struct KN_API payload_pool {
+    using ptr = std::shared_ptr<payload_pool>;
+
+    /// Payloads up to this size are read into the channel's own buffer.
+    static constexpr size_t small_size = 64 * 1024;
+
+    /// Maximum number of idle buffers retained by the pool.
+    static constexpr size_t capacity_default = 8;
+
+    struct stats {
+        size_t pooled;          // idle buffers
+        size_t pooled_bytes;    // idle buffers capacity
+        size_t outstanding;     // buffers borrowed by channels
+        size_t hits;            // acquisitions served by an idle buffer
+        size_t misses;          // acquisitions requiring an allocation
+    };
+
+    explicit
+    payload_pool(size_t capacity = capacity_default);
+
+    // Non-copyable, non-movable
+    payload_pool(payload_pool const&) = delete;
+    payload_pool& operator=(payload_pool const&) = delete;
+
+    /// Get a buffer resized to size, reusing the smallest idle buffer
+    /// large enough when possible.
+    data_chunk acquire(size_t size);
+
+    /// Return a buffer obtained from acquire, the smallest buffer is freed
+    /// when the pool is at capacity.
+    void release(data_chunk&& buffer);
+
+    stats get_stats() const;
+
+private:
+    size_t const capacity_;
+
+    // These are protected by mutex.
+    std::vector<data_chunk> buffers_;
+    mutable std::mutex mutex_;
+
+    std::atomic<size_t> outstanding_ {0};
+    std::atomic<size_t> hits_ {0};
+    std::atomic<size_t> misses_ {0};
+};
+
+} // namespace kth::network
+
+#endif
@@ -12,6 +12,7 @@
 #include <kth/domain.hpp>
 #include <kth/network/channel.hpp>
 #include <kth/network/define.hpp>
+#include <kth/network/wire_cache.hpp>
 
 namespace kth::network {
 
@@ -51,6 +52,26 @@ protected:
         channel_->send(packet, BOUND_PROTOCOL(handler, args));
     }
 
+    /// Send a message on the channel, sharing its serialization with the
+    /// other channels through the network relay cache (id: block/tx hash).
+    template <typename Protocol, typename Message, typename Handler, typename... Args>
+    void send_cached(Message const& packet, hash_digest const& id, Handler&& handler, Args&&... args) {
+        channel_->send(packet, id, relay_cache_, BOUND_PROTOCOL(handler, args));
+    }
+
+    /// Send a message from the network relay cache, false if not cached.
+    template <typename Protocol, typename Handler, typename... Args>
+    bool send_from_cache(hash_digest const& id, std::string const& command, Handler&& handler, Args&&... args) {
+        return channel_->send_cached(id, command, relay_cache_, BOUND_PROTOCOL(handler, args));
+    }
+
+    /// Send a payload already in the wire encoding, sharing the framed
+    /// message with the other channels through the network relay cache.
+    template <typename Protocol, typename Handler, typename... Args>
+    void send_payload(byte_span payload, std::string const& command, hash_digest const& id, Handler&& handler, Args&&... args) {
+        channel_->send_payload(payload, command, id, relay_cache_, BOUND_PROTOCOL(handler, args));
+    }
+
     /// Subscribe to all channel messages, blocking until subscribed.
     template <typename Protocol, typename Message, typename Handler, typename... Args>
     void subscribe(Handler&& handler, Args&&... args) {
@@ -97,6 +118,7 @@ private:
     threadpool& pool_;
     dispatcher dispatch_;
     channel::ptr channel_;
+    wire_cache& relay_cache_;
     const std::string name_;
 };
 
@@ -110,6 +132,13 @@ private:
 #define SEND3(message, method, p1, p2, p3) \
     send<CLASS>(message, &CLASS::method, p1, p2, p3)
 
+#define SEND_CACHED2(message, id, method, p1, p2) \
+    send_cached<CLASS>(message, id, &CLASS::method, p1, p2)
+#define SEND_FROM_CACHE2(id, command, method, p1, p2) \
+    send_from_cache<CLASS>(id, command, &CLASS::method, p1, p2)
+#define SEND_PAYLOAD2(payload, command, id, method, p1, p2) \
+    send_payload<CLASS>(payload, command, id, &CLASS::method, p1, p2)
+
 #define SUBSCRIBE2(message, method, p1, p2) \
     subscribe<CLASS, message>(&CLASS::method, p1, p2)
 #define SUBSCRIBE3(message, method, p1, p2, p3) \
@@ -15,7 +15,9 @@
 #include <kth/domain.hpp>
 #include <kth/network/define.hpp>
 #include <kth/network/message_subscriber.hpp>
+#include <kth/network/payload_pool.hpp>
 #include <kth/network/settings.hpp>
+#include <kth/network/wire_cache.hpp>
 
 namespace kth::network {
 
@@ -29,7 +31,7 @@ public:
     using stop_subscriber = subscriber<code>;
 
     /// Construct an instance.
-    proxy(threadpool& pool, socket::ptr socket, settings const& settings);
+    proxy(threadpool& pool, socket::ptr socket, settings const& settings, payload_pool::ptr buffers);
 
     /// Validate proxy stopped.
     ~proxy();
@@ -38,14 +40,28 @@ public:
     template <typename Message>
     void send(Message const& message, result_handler handler) {
         auto data = domain::message::serialize(version_, message, protocol_magic_);
-        auto const payload = std::make_shared<data_chunk>(std::move(data));
-        auto const command = std::make_shared<std::string>(message.command);
+        auto const payload = std::make_shared<data_chunk const>(std::move(data));
+        send_serialized(payload, message.command, handler);
+    }
 
-        // Sequential dispatch is required because write may occur in multiple
-        // asynchronous steps invoked on different threads, causing deadlocks.
-        dispatch_.lock(&proxy::do_send, shared_from_this(), command, payload, handler);
+    /// Send a message on the socket, reusing its serialization from the
+    /// cache when already serialized (for any channel) at this version.
+    template <typename Message>
+    void send(Message const& message, hash_digest const& id, wire_cache& cache, result_handler handler) {
+        auto const payload = cache.get(message, id, version_, protocol_magic_);
+        send_serialized(payload, message.command, handler);
     }
 
+    /// Send a message already serialized for the negotiated version.
+    void send_serialized(wire_cache::payload_ptr payload, std::string const& command, result_handler handler);
+
+    /// Send a message found in the cache, false (not sent) if not cached.
+    bool send_cached(hash_digest const& id, std::string const& command, wire_cache& cache, result_handler handler);
+
+    /// Send a payload already in the wire encoding of any version (i.e. a
+    /// block read from the store), caching the framed message.
+    void send_payload(byte_span payload, std::string const& command, hash_digest const& id, wire_cache& cache, result_handler handler);
+
     /// Subscribe to messages of the specified type on the socket.
     template <typename Message>
     void subscribe(message_handler<Message>&& handler) {
@@ -88,7 +104,7 @@ protected:
 
 private:
     using command_ptr = std::shared_ptr<std::string>;
-    using payload_ptr = std::shared_ptr<data_chunk>;
+    using payload_ptr = wire_cache::payload_ptr;
 
     static infrastructure::config::authority authority_factory(socket::ptr socket);
 
@@ -99,6 +115,7 @@ private:
 
     void read_payload(const domain::message::heading& head);
     void handle_read_payload(boost_code const& ec, size_t, const domain::message::heading& head);
+    void release_payload();
 
     void do_send(command_ptr command, payload_ptr payload, result_handler handler);
     void handle_send(boost_code const& ec, size_t bytes, command_ptr command, payload_ptr payload, result_handler handler);
@@ -108,12 +125,15 @@ private:
     // These are protected by read header/payload ordering.
     data_chunk heading_buffer_;
     data_chunk payload_buffer_;
+    data_chunk small_buffer_;
+    bool pooled_payload_;
     socket::ptr socket_;
 
     // These are thread safe.
     std::atomic<bool> stopped_;
     uint32_t const protocol_magic_;
     size_t const maximum_payload_;
+    payload_pool::ptr const payload_pool_;
     bool const validate_checksum_;
     bool const verbose_;
     std::atomic<uint32_t> version_;
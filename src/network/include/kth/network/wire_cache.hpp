@@ -0,0 +1,87 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef KTH_NETWORK_WIRE_CACHE_HPP
+#define KTH_NETWORK_WIRE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <kth/domain.hpp>
+#include <kth/network/define.hpp>
+
+namespace kth::network {
+
+/// Bounded cache of serialized messages (heading, checksum and payload),
+/// shared by all channels so that relaying the same block or transaction
+/// to many peers serializes it once per protocol version.
+/// Entries are keyed by message identity (i.e. the block or tx hash), the
+/// command and the protocol version, and evicted least recently used first.
+/// This class is thread safe.
+struct KN_API wire_cache {
+    using payload_ptr = std::shared_ptr<data_chunk const>;
+
+    static constexpr size_t capacity_default = 64 * 1024 * 1024;
+
+    explicit
+    wire_cache(size_t capacity = capacity_default);
+
+    // Non-copyable, non-movable
+    wire_cache(wire_cache const&) = delete;
+    wire_cache& operator=(wire_cache const&) = delete;
+
+    /// Total size in bytes of the cached payloads.
+    size_t size() const;
+    size_t count() const;
+
+    /// Get the cached payload, or nullptr.
+    payload_ptr find(hash_digest const& id, std::string const& command, uint32_t version) const;
+
+    /// Cache a payload, payloads larger than the capacity are not cached.
+    void add(hash_digest const& id, std::string const& command, uint32_t version, payload_ptr payload);
+
+    void clear();
+
+    /// Get the cached payload or serialize the message and cache it.
+    template <typename Message>
+    payload_ptr get(Message const& message, hash_digest const& id, uint32_t version, uint32_t magic) {
+        auto payload = find(id, Message::command, version);
+        if (payload) {
+            return payload;
+        }
+
+        payload = std::make_shared<data_chunk const>(domain::message::serialize(version, message, magic));
+        add(id, Message::command, version, payload);
+        return payload;
+    }
+
+private:
+    using key = std::tuple<hash_digest, std::string, uint32_t>;
+    using lru_list = std::list<key>;
+
+    struct item {
+        payload_ptr payload;
+        lru_list::iterator position;
+    };
+
+    void evict(size_t required);
+
+    size_t const capacity_;
+
+    // These are protected by mutex.
+    size_t size_ = 0;
+    mutable lru_list lru_;
+    std::map<key, item> items_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace kth::network
+
+#endif
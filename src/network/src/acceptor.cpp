@@ -21,10 +21,11 @@ using namespace std::placeholders;
 
 static auto const reuse_address = asio::acceptor::reuse_address(true);
 
-acceptor::acceptor(threadpool& pool, settings const& settings)
+acceptor::acceptor(threadpool& pool, settings const& settings, payload_pool::ptr buffers)
     : stopped_(true)
     , pool_(pool)
     , settings_(settings)
+    , buffers_(buffers)
     , dispatch_(pool, NAME)
     , acceptor_(pool_.service())
     , CONSTRUCT_TRACK(acceptor) {}
@@ -135,7 +136,7 @@ void acceptor::handle_accept(boost_code const& ec, socket::ptr socket, accept_ha
     }
 
     // Ensure that channel is not passed as an r-value.
-    auto const created = std::make_shared<channel>(pool_, socket, settings_);
+    auto const created = std::make_shared<channel>(pool_, socket, settings_, buffers_);
     handler(error::success, created);
 }
 
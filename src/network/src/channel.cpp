@@ -25,8 +25,8 @@ deadline::ptr alarm(threadpool& pool, const asio::duration& duration) {
     return std::make_shared<deadline>(pool, pseudo_random_broken_do_not_use::duration(duration));
 }
 
-channel::channel(threadpool& pool, socket::ptr socket, settings const& settings)
-    : proxy(pool, socket, settings)
+channel::channel(threadpool& pool, socket::ptr socket, settings const& settings, payload_pool::ptr buffers)
+    : proxy(pool, socket, settings, buffers)
     , notify_(false)
     , nonce_(0)
     , expiration_(alarm(pool, settings.channel_expiration()))
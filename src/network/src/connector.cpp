@@ -21,10 +21,11 @@ namespace kth::network {
 using namespace kth::config;
 using namespace std::placeholders;
 
-connector::connector(threadpool& pool, settings const& settings)
+connector::connector(threadpool& pool, settings const& settings, payload_pool::ptr buffers)
     : stopped_(false)
     , pool_(pool)
     , settings_(settings)
+    , buffers_(buffers)
     , dispatch_(pool, NAME)
     , resolver_(pool.service())
     , CONSTRUCT_TRACK(connector)
@@ -142,7 +143,7 @@ void connector::handle_connect(boost_code const& ec, asio::endpoint const&,
     }
 
     // Ensure that channel is not passed as an r-value.
-    auto const created = std::make_shared<channel>(pool_, socket, settings_);
+    auto const created = std::make_shared<channel>(pool_, socket, settings_, buffers_);
     handler(error::success, created);
 }
 
@@ -60,6 +60,7 @@ p2p::p2p(settings const& settings)
     , threadpool_("network")
     , stop_subscriber_(std::make_shared<stop_subscriber>(threadpool_, NAME "_stop_sub"))
     , channel_subscriber_(std::make_shared<channel_subscriber>(threadpool_, NAME "_sub"))
+    , payload_buffers_(std::make_shared<payload_pool>())
 {}
 
 // This allows for shutdown based on destruct without need to call stop.
@@ -271,6 +272,10 @@ bool p2p::close() {
     // Block on join of all threads in the threadpool.
     threadpool_.join();
 
+    auto const buffers = payload_buffers_->get_stats();
+    spdlog::debug("[network] Payload buffers: {} pooled ({} bytes), {} outstanding, {} hits, {} misses.",
+        buffers.pooled, buffers.pooled_bytes, buffers.outstanding, buffers.hits, buffers.misses);
+
     return result;
 }
 
@@ -301,6 +306,14 @@ threadpool& p2p::thread_pool() {
     return threadpool_;
 }
 
+wire_cache& p2p::relay_cache() {
+    return relay_cache_;
+}
+
+payload_pool::ptr p2p::payload_buffers() const {
+    return payload_buffers_;
+}
+
 // Send.
 // ----------------------------------------------------------------------------
 
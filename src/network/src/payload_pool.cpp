@@ -0,0 +1,85 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/network/payload_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace kth::network {
+
+payload_pool::payload_pool(size_t capacity)
+    : capacity_(capacity)
+{}
+
+data_chunk payload_pool::acquire(size_t size) {
+    ++outstanding_;
+    data_chunk buffer;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto best = buffers_.end();
+        for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+            if (it->capacity() >= size && (best == buffers_.end() || it->capacity() < best->capacity())) {
+                best = it;
+            }
+        }
+
+        if (best != buffers_.end()) {
+            buffer = std::move(*best);
+            buffers_.erase(best);
+        }
+    }
+
+    if (buffer.capacity() >= size) {
+        ++hits_;
+    } else {
+        ++misses_;
+    }
+
+    // This does not cause a reallocation on hits.
+    buffer.resize(size);
+    return buffer;
+}
+
+void payload_pool::release(data_chunk&& buffer) {
+    --outstanding_;
+
+    if (capacity_ == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (buffers_.size() < capacity_) {
+        buffers_.push_back(std::move(buffer));
+        return;
+    }
+
+    // Keep the largest buffers, they are the expensive ones to allocate.
+    auto const smallest = std::min_element(buffers_.begin(), buffers_.end(),
+        [](data_chunk const& x, data_chunk const& y) {
+            return x.capacity() < y.capacity();
+        });
+
+    if (smallest->capacity() < buffer.capacity()) {
+        *smallest = std::move(buffer);
+    }
+}
+
+payload_pool::stats payload_pool::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t bytes = 0;
+    for (auto const& buffer : buffers_) {
+        bytes += buffer.capacity();
+    }
+
+    return {buffers_.size(), bytes, outstanding_.load(), hits_.load(), misses_.load()};
+}
+
+} // namespace kth::network
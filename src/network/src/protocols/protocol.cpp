@@ -18,6 +18,7 @@ protocol::protocol(p2p& network, channel::ptr channel, std::string const& name)
     : pool_(network.thread_pool())
     , dispatch_(network.thread_pool(), NAME)
     , channel_(channel)
+    , relay_cache_(network.relay_cache())
     , name_(name) {}
 
 infrastructure::config::authority protocol::authority() const {
@@ -29,17 +29,18 @@ using namespace kd::message;
 // Dump up to 1k of payload as hex in order to diagnose failure.
 static size_t const invalid_payload_dump_size = 1024;
 
-// payload_buffer_ sizing assumes monotonically increasing size by version.
-// Initialize to pre-witness max payload and let grow to witness as required.
+// payload_buffer_ grows on demand up to payload_pool::small_size, larger
+// payloads are read into a buffer borrowed from the shared pool.
 // The socket owns the single thread on which this channel reads and writes.
-proxy::proxy(threadpool& pool, socket::ptr socket, settings const& settings)
+proxy::proxy(threadpool& pool, socket::ptr socket, settings const& settings, payload_pool::ptr buffers)
     : authority_(socket->authority())
     , heading_buffer_(heading::maximum_size())
-    , payload_buffer_(heading::maximum_payload_size(settings.protocol_maximum, settings.identifier, settings.inbound_port == 48333))
-    , maximum_payload_(heading::maximum_payload_size(settings.protocol_maximum, settings.identifier, settings.inbound_port == 48333))
+    , pooled_payload_(false)
     , socket_(socket)
     , stopped_(true)
     , protocol_magic_(settings.identifier)
+    , maximum_payload_(heading::maximum_payload_size(settings.protocol_maximum, settings.identifier, settings.inbound_port == 48333))
+    , payload_pool_(buffers)
     , validate_checksum_(settings.validate_checksum)
     , verbose_(settings.verbose)
     , version_(settings.protocol_maximum)
@@ -158,17 +159,30 @@ void proxy::read_payload(heading const& head) {
         return;
     }
 
-    // This does not cause a reallocation.
-    payload_buffer_.resize(head.payload_size());
+    auto const size = head.payload_size();
+
+    if (size > payload_pool::small_size) {
+        // Keep the channel buffer aside while borrowing a large one.
+        small_buffer_.swap(payload_buffer_);
+        payload_buffer_ = payload_pool_->acquire(size);
+        pooled_payload_ = true;
+    } else {
+        // This only reallocates to grow the buffer (up to small_size).
+        payload_buffer_.resize(size);
+    }
 
     async_read(socket_->get(), buffer(payload_buffer_), std::bind(&proxy::handle_read_payload, shared_from_this(), _1, _2, head));
 }
 
 void proxy::handle_read_payload(boost_code const& ec, size_t payload_size, heading const& head) {
-    if (stopped()) return;
+    if (stopped()) {
+        release_payload();
+        return;
+    }
 
     if (ec) {
         spdlog::debug("[network] Payload read failure [{}] {}", authority(), code(error::boost_to_error_code(ec)).message());
+        release_payload();
         stop(ec);
         return;
     }
@@ -176,6 +190,7 @@ void proxy::handle_read_payload(boost_code const& ec, size_t payload_size, headi
     // This is a pointless test but we allow it as an option for completeness.
     if (validate_checksum_ && head.checksum() != bitcoin_checksum(payload_buffer_)) {
         spdlog::warn("[network] Invalid {} payload from [{}] bad checksum.", head.command(), authority());
+        release_payload();
         stop(error::bad_stream);
         return;
     }
@@ -194,10 +209,14 @@ void proxy::handle_read_payload(boost_code const& ec, size_t payload_size, headi
         auto const begin = payload_buffer_.begin();
 
         spdlog::trace("[network] Invalid payload from [{}] {}", authority(), encode_base16(data_chunk{ begin, begin + size }));
+        release_payload();
         stop(code);
         return;
     }
 
+    // The message is parsed, the payload is no longer referenced.
+    release_payload();
+
     if (code) {
         spdlog::trace("[network] Invalid {} payload from [{}] {}", head.command(), authority(), code.message());
         stop(code);
@@ -216,9 +235,46 @@ void proxy::handle_read_payload(boost_code const& ec, size_t payload_size, headi
     read_heading();
 }
 
+// Return a borrowed payload buffer to the pool.
+void proxy::release_payload() {
+    if ( ! pooled_payload_) {
+        return;
+    }
+
+    payload_pool_->release(std::move(payload_buffer_));
+    payload_buffer_ = std::move(small_buffer_);
+    small_buffer_ = data_chunk{};
+    pooled_payload_ = false;
+}
+
 // Message send sequence.
 // ----------------------------------------------------------------------------
 
+void proxy::send_serialized(payload_ptr payload, std::string const& command, result_handler handler) {
+    auto const command_copy = std::make_shared<std::string>(command);
+
+    // Sequential dispatch is required because write may occur in multiple
+    // asynchronous steps invoked on different threads, causing deadlocks.
+    dispatch_.lock(&proxy::do_send, shared_from_this(), command_copy, payload, handler);
+}
+
+bool proxy::send_cached(hash_digest const& id, std::string const& command, wire_cache& cache, result_handler handler) {
+    auto const payload = cache.find(id, command, version_);
+    if ( ! payload) {
+        return false;
+    }
+
+    send_serialized(payload, command, handler);
+    return true;
+}
+
+void proxy::send_payload(byte_span payload, std::string const& command, hash_digest const& id, wire_cache& cache, result_handler handler) {
+    auto data = domain::message::serialize(command, payload, protocol_magic_);
+    auto const message = std::make_shared<data_chunk const>(std::move(data));
+    cache.add(id, command, version_, message);
+    send_serialized(message, command, handler);
+}
+
 void proxy::do_send(command_ptr command, payload_ptr payload, result_handler handler) {
     async_write(socket_->get(), buffer(*payload),
         std::bind(&proxy::handle_send,
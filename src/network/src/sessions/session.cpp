@@ -75,11 +75,11 @@ bool session::stopped(code const& ec) const {
 // ----------------------------------------------------------------------------
 
 acceptor::ptr session::create_acceptor() {
-    return std::make_shared<acceptor>(pool_, settings_);
+    return std::make_shared<acceptor>(pool_, settings_, network_.payload_buffers());
 }
 
 connector::ptr session::create_connector() {
-    return std::make_shared<connector>(pool_, settings_);
+    return std::make_shared<connector>(pool_, settings_, network_.payload_buffers());
 }
 
 // Pending connect.
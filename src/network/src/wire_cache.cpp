@@ -0,0 +1,78 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kth/network/wire_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace kth::network {
+
+wire_cache::wire_cache(size_t capacity)
+    : capacity_(capacity)
+{}
+
+size_t wire_cache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+size_t wire_cache::count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+}
+
+wire_cache::payload_ptr wire_cache::find(hash_digest const& id, std::string const& command, uint32_t version) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto const it = items_.find(key{id, command, version});
+    if (it == items_.end()) {
+        return nullptr;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.position);
+    return it->second.payload;
+}
+
+void wire_cache::add(hash_digest const& id, std::string const& command, uint32_t version, payload_ptr payload) {
+    if ( ! payload || payload->size() > capacity_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Another channel may have serialized the same message concurrently.
+    key entry{id, command, version};
+    if (items_.contains(entry)) {
+        return;
+    }
+
+    evict(payload->size());
+    size_ += payload->size();
+    lru_.push_front(entry);
+    items_.emplace(std::move(entry), item{std::move(payload), lru_.begin()});
+}
+
+void wire_cache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_.clear();
+    lru_.clear();
+    size_ = 0;
+}
+
+// private
+// precondition: mutex_ is locked.
+void wire_cache::evict(size_t required) {
+    while ( ! lru_.empty() && size_ + required > capacity_) {
+        auto const it = items_.find(lru_.back());
+        size_ -= it->second.payload->size();
+        items_.erase(it);
+        lru_.pop_back();
+    }
+}
+
+} // namespace kth::network
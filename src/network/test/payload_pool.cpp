@@ -0,0 +1,57 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <utility>
+
+#include <test_helpers.hpp>
+
+#include <kth/network.hpp>
+
+using namespace kth;
+using namespace kth::network;
+
+// Start Test Suite: payload pool tests
+
+TEST_CASE("payload pool  acquire empty pool  miss", "[payload pool]") {
+    payload_pool pool;
+    auto const buffer = pool.acquire(1000);
+    REQUIRE(buffer.size() == 1000u);
+
+    auto const stats = pool.get_stats();
+    REQUIRE(stats.misses == 1u);
+    REQUIRE(stats.hits == 0u);
+    REQUIRE(stats.outstanding == 1u);
+}
+
+TEST_CASE("payload pool  acquire after release  reuses buffer", "[payload pool]") {
+    payload_pool pool;
+    auto buffer = pool.acquire(1000);
+    auto const data = buffer.data();
+    pool.release(std::move(buffer));
+    REQUIRE(pool.get_stats().pooled == 1u);
+
+    auto const reused = pool.acquire(500);
+    REQUIRE(reused.size() == 500u);
+    REQUIRE(reused.data() == data);
+
+    auto const stats = pool.get_stats();
+    REQUIRE(stats.hits == 1u);
+    REQUIRE(stats.pooled == 0u);
+    REQUIRE(stats.outstanding == 1u);
+}
+
+TEST_CASE("payload pool  release full pool  keeps largest", "[payload pool]") {
+    payload_pool pool(1);
+    auto small = pool.acquire(100);
+    auto large = pool.acquire(1000);
+    pool.release(std::move(small));
+    pool.release(std::move(large));
+
+    auto const stats = pool.get_stats();
+    REQUIRE(stats.pooled == 1u);
+    REQUIRE(stats.pooled_bytes >= 1000u);
+    REQUIRE(stats.outstanding == 0u);
+}
+
+// End Test Suite
@@ -0,0 +1,56 @@
+// Copyright (c) 2016-2025 Knuth Project developers.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memory>
+
+#include <test_helpers.hpp>
+
+#include <kth/network.hpp>
+
+using namespace kth;
+using namespace kd::message;
+using namespace kth::network;
+
+// Start Test Suite: wire cache tests
+
+TEST_CASE("wire cache  get twice  serialized once", "[wire cache]") {
+    wire_cache cache;
+    transaction const tx{1, 0, {}, {}};
+    auto const first = cache.get(tx, tx.hash(), kd::message::version::level::canonical, 0x0b110907);
+    auto const second = cache.get(tx, tx.hash(), kd::message::version::level::canonical, 0x0b110907);
+    REQUIRE(first == second);
+    REQUIRE(*first == serialize(version::level::canonical, tx, 0x0b110907));
+    REQUIRE(cache.count() == 1u);
+}
+
+TEST_CASE("wire cache  get different version  serialized per version", "[wire cache]") {
+    wire_cache cache;
+    transaction const tx{1, 0, {}, {}};
+    auto const first = cache.get(tx, tx.hash(), kd::message::version::level::minimum, 0x0b110907);
+    auto const second = cache.get(tx, tx.hash(), kd::message::version::level::canonical, 0x0b110907);
+    REQUIRE(first != second);
+    REQUIRE(cache.count() == 2u);
+}
+
+TEST_CASE("wire cache  add beyond capacity  evicts least recently used", "[wire cache]") {
+    wire_cache cache(10);
+    auto const payload = std::make_shared<data_chunk const>(data_chunk(4, 0x00));
+    cache.add(hash_digest{{ 1 }}, "tx", 0, payload);
+    cache.add(hash_digest{{ 2 }}, "tx", 0, payload);
+    REQUIRE(cache.find(hash_digest{{ 1 }}, "tx", 0));
+
+    cache.add(hash_digest{{ 3 }}, "tx", 0, payload);
+    REQUIRE(cache.size() == 8u);
+    REQUIRE(cache.find(hash_digest{{ 1 }}, "tx", 0));
+    REQUIRE( ! cache.find(hash_digest{{ 2 }}, "tx", 0));
+    REQUIRE(cache.find(hash_digest{{ 3 }}, "tx", 0));
+}
+
+TEST_CASE("wire cache  add larger than capacity  not cached", "[wire cache]") {
+    wire_cache cache(2);
+    cache.add(null_hash, "block", 0, std::make_shared<data_chunk const>(data_chunk(4, 0x00)));
+    REQUIRE(cache.count() == 0u);
+}
+
+// End Test Suite
@@ -73,8 +73,16 @@ bool menu(kth::node::parser& metadata, kth::node::executor& host, std::ostream&
     } else if (config.initchain) {
         return host.do_initchain(version());
     }
+
+    if ( ! config.import_snapshot.empty()) {
+        return host.do_import_snapshot(version());
+    }
 #endif // ! defined(KTH_DB_READONLY)
 
+    if ( ! config.export_snapshot.empty()) {
+        return host.do_export_snapshot(version());
+    }
+
     // There are no command line arguments, just run the node.
     return run(host);
 }
@@ -42,8 +42,20 @@ struct KND_API configuration {
 #if ! defined(KTH_DB_READONLY)
     bool initchain;
     bool init_and_run;
+
+    /// Initialize the chain from this UTXO snapshot file.
+    kth::path import_snapshot;
+
+    /// The trusted block hash, utxo commitment and abla commitment of the
+    /// imported snapshot.
+    infrastructure::config::hash256 snapshot_hash;
+    infrastructure::config::hash256 snapshot_commitment;
+    infrastructure::config::hash256 snapshot_abla_commitment;
 #endif
 
+    /// Write a UTXO snapshot of the chain to this file.
+    kth::path export_snapshot;
+
     bool settings;
     bool version;
     domain::config::network net = domain::config::network::mainnet;
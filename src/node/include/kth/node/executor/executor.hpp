@@ -26,8 +26,11 @@ struct executor {
 
 #if ! defined(KTH_DB_READONLY)
     bool do_initchain(std::string_view extra);
+    bool do_import_snapshot(std::string_view extra);
 #endif
 
+    bool do_export_snapshot(std::string_view extra);
+
     // bool run(kth::handle0 handler);
 
 #if ! defined(KTH_DB_READONLY)
@@ -89,6 +92,12 @@ private:
 #define KTH_INITCHAIN_TRY "Failed to test directory {} with error, '{}'."
 #define KTH_INITCHAIN_COMPLETE "Completed initialization."
 #define KTH_INITCHAIN_FAILED "Error creating database files."
+#define KTH_SNAPSHOT_IMPORTING "Please wait while importing the snapshot {}..."
+#define KTH_SNAPSHOT_IMPORT_FAILED "Error importing the snapshot, the {} directory was removed."
+#define KTH_SNAPSHOT_UNTRUSTED "The snapshot_hash, snapshot_commitment and snapshot_abla_commitment options are required to import a snapshot."
+#define KTH_SNAPSHOT_EXPORTING "Please wait while exporting the snapshot {}..."
+#define KTH_SNAPSHOT_EXPORT_FAILED "Error exporting the snapshot."
+#define KTH_SNAPSHOT_COMPLETE "Completed snapshot."
 
 #define KTH_NODE_INTERRUPT "Press CTRL-C to stop the node."
 #define KTH_NODE_STARTING "Please wait while the node is starting..."
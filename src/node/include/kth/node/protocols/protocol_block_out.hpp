@@ -33,7 +33,7 @@ private:
     size_t locator_limit();
 
     void send_next_data(inventory_ptr inventory);
-    void send_block(code const& ec, block_const_ptr message, size_t height, inventory_ptr inventory);
+    void send_block(code const& ec, std::shared_ptr<data_chunk const> data, size_t height, inventory_ptr inventory);
     void send_merkle_block(code const& ec, merkle_block_const_ptr message, size_t height, inventory_ptr inventory);
     void send_compact_block(code const& ec, compact_block_const_ptr message, size_t height, inventory_ptr inventory);
 
@@ -6,8 +6,13 @@
 #define KTH_NODE_PROTOCOL_TRANSACTION_OUT_HPP
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
 #include <kth/blockchain.hpp>
 #if ! defined(__EMSCRIPTEN__)
 #include <kth/network.hpp>
@@ -29,9 +34,16 @@ public:
     virtual void start();
 
 private:
+    // The hashes last announced to (or by) the peer, per channel.
+    static constexpr size_t known_inventory_capacity = 10000;
+
     void send_next_data(inventory_ptr inventory);
-    void send_transaction(code const& ec, transaction_const_ptr message, size_t position, size_t height, inventory_ptr inventory);
+    void send_transaction(code const& ec, transaction_const_ptr message, inventory_ptr inventory);
+    void send_announcements();
+    void start_trickle();
+    bool remember(hash_digest const& hash);
 
+    bool handle_receive_inventory(code const& ec, inventory_const_ptr message);
     bool handle_receive_get_data(code const& ec, get_data_const_ptr message);
     bool handle_receive_fee_filter(code const& ec, fee_filter_const_ptr message);
     bool handle_receive_memory_pool(code const& ec, memory_pool_const_ptr message);
@@ -39,12 +51,22 @@ private:
     void handle_stop(code const& ec);
     void handle_send_next(code const& ec, inventory_ptr inventory);
     bool handle_transaction_pool(code const& ec, transaction_const_ptr message);
+    void handle_trickle(code const& ec);
 
     // These are thread safe.
     blockchain::safe_chain& chain_;
     std::atomic<uint64_t> minimum_peer_fee_;
     bool const relay_to_peer_;
+    asio::duration const trickle_interval_;
+    deadline::ptr trickle_timer_;
     // bool const enable_witness_;
+
+    // These are protected by mutex_.
+    std::vector<transaction_const_ptr> announcements_;
+    std::unordered_set<hash_digest> known_;
+    std::vector<hash_digest> known_ring_;
+    size_t known_next_ = 0;
+    std::mutex mutex_;
 };
 
 } // namespace kth::node
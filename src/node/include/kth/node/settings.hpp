@@ -20,12 +20,14 @@ struct KND_API settings {
     uint32_t sync_peers;
     uint32_t sync_timeout_seconds;
     uint32_t block_latency_seconds;
+    uint32_t transaction_trickle_milliseconds;
     bool refresh_transactions;
     bool compact_blocks_high_bandwidth;
     bool ds_proofs_enabled;
 
     /// Helpers.
     asio::duration block_latency() const;
+    asio::duration transaction_trickle() const;
 };
 
 } // namespace kth::node
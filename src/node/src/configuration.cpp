@@ -37,7 +37,12 @@ configuration::configuration(configuration const& other)
 #if ! defined(KTH_DB_READONLY)
     , initchain(other.initchain)
     , init_and_run(other.init_and_run)
+    , import_snapshot(other.import_snapshot)
+    , snapshot_hash(other.snapshot_hash)
+    , snapshot_commitment(other.snapshot_commitment)
+    , snapshot_abla_commitment(other.snapshot_abla_commitment)
 #endif
+    , export_snapshot(other.export_snapshot)
     , settings(other.settings)
     , version(other.version)
     , net(other.net)
@@ -5,6 +5,7 @@
 #include <kth/node/executor/executor.hpp>
 
 #include <csignal>
+#include <filesystem>
 #include <functional>
 #include <future>
 #include <memory>
@@ -111,8 +112,72 @@ bool executor::do_initchain(std::string_view extra) {
     return false;
 }
 
+bool executor::do_import_snapshot(std::string_view extra) {
+    initialize_output(extra, config_.database.db_mode);
+
+    // The snapshot is trusted through values obtained out of band.
+    utxo_snapshot_trust const trust {
+        config_.snapshot_hash,
+        config_.snapshot_commitment,
+        config_.snapshot_abla_commitment,
+        config_.chain.checkpoints,
+        config_.chain.retarget
+    };
+
+    if (trust.block_hash == null_hash || trust.commitment == null_hash || trust.abla_commitment == null_hash) {
+        spdlog::error("[node] {}", KTH_SNAPSHOT_UNTRUSTED);
+        return false;
+    }
+
+    error_code ec;
+    auto const& directory = config_.database.directory;
+
+    if ( ! create_directories(directory, ec)) {
+        if (ec.value() == directory_exists) {
+            spdlog::error("[node] {}", fmt::format(KTH_INITCHAIN_EXISTS, directory.string()));
+            return false;
+        }
+
+        spdlog::error("[node] {}", fmt::format(KTH_INITCHAIN_NEW, directory.string(), ec.message()));
+        return false;
+    }
+
+    spdlog::info("[node] {}", fmt::format(KTH_SNAPSHOT_IMPORTING, config_.import_snapshot.string()));
+    auto const genesis = kth::node::full_node::get_genesis_block(get_network(config_.network.identifier, config_.network.inbound_port == 48333));
+
+    // The directory was created above, nothing else is removed.
+    data_base db(config_.database);
+    if ( ! db.create_from_snapshot(config_.import_snapshot, genesis, trust)) {
+        std::filesystem::remove_all(directory, ec);
+        spdlog::error("[node] {}", fmt::format(KTH_SNAPSHOT_IMPORT_FAILED, directory.string()));
+        return false;
+    }
+
+    spdlog::info("[node] {}", KTH_SNAPSHOT_COMPLETE);
+    return true;
+}
+
 #endif // ! defined(KTH_DB_READONLY)
 
+bool executor::do_export_snapshot(std::string_view extra) {
+    initialize_output(extra, config_.database.db_mode);
+
+    if ( ! verify_directory()) {
+        return false;
+    }
+
+    spdlog::info("[node] {}", fmt::format(KTH_SNAPSHOT_EXPORTING, config_.export_snapshot.string()));
+
+    data_base db(config_.database);
+    if ( ! db.open() || db.internal_db().export_utxo_snapshot(config_.export_snapshot) != result_code::success) {
+        spdlog::error("[node] {}", KTH_SNAPSHOT_EXPORT_FAILED);
+        return false;
+    }
+
+    spdlog::info("[node] {}", KTH_SNAPSHOT_COMPLETE);
+    return true;
+}
+
 kth::node::full_node& executor::node() {
     return *node_;
 }
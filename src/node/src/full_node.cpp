@@ -99,6 +99,8 @@ void full_node::start(result_handler handler) {
         return;
     }
 
+    spdlog::info("[node] Using sha256 implementation: {}.", sha256_implementation());
+
     if ( ! chain_.start()) {
         spdlog::error("[node] Failure starting blockchain [full_node::start()].");
         handler(error::operation_failed);
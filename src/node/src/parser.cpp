@@ -125,7 +125,32 @@ options_metadata parser::load_options() {
             default_value(false)->zero_tokens(),
         "Initialize blockchain in the configured directory, then start the node."
     )
+    (
+        "import_snapshot",
+        value<path>(&configured.import_snapshot),
+        "Initialize blockchain in the configured directory from a UTXO snapshot file (pruned mode)."
+    )
+    (
+        "snapshot_hash",
+        value<infrastructure::config::hash256>(&configured.snapshot_hash),
+        "The trusted block hash of the imported UTXO snapshot, required by import_snapshot."
+    )
+    (
+        "snapshot_commitment",
+        value<infrastructure::config::hash256>(&configured.snapshot_commitment),
+        "The trusted UTXO commitment of the imported UTXO snapshot, required by import_snapshot."
+    )
+    (
+        "snapshot_abla_commitment",
+        value<infrastructure::config::hash256>(&configured.snapshot_abla_commitment),
+        "The trusted ABLA state commitment of the imported UTXO snapshot, required by import_snapshot."
+    )
 #endif // ! defined(KTH_DB_READONLY)
+    (
+        "export_snapshot",
+        value<path>(&configured.export_snapshot),
+        "Write a UTXO snapshot of the blockchain in the configured directory to a file."
+    )
     (
         KTH_SETTINGS_VARIABLE ",s",
         value<bool>(&configured.settings)->
@@ -339,6 +364,30 @@ options_metadata parser::load_settings() {
         "database.cache_capacity",
         value<uint32_t>(&configured.database.cache_capacity),
         "The maximum number of entries in the unspent outputs cache, defaults to 10000."
+    )(
+        "database.cache_size",
+        value<uint32_t>(&configured.database.cache_size),
+        "The maximum approximate memory size in MiB of the unspent outputs cache, defaults to 256 (0 to bound it by entries only)."
+    )(
+        "database.ibd_batch_blocks",
+        value<uint32_t>(&configured.database.ibd_batch_blocks),
+        "The maximum number of old blocks committed in a single write transaction during the initial block download, defaults to 500 (0 to commit each block)."
+    )(
+        "database.ibd_batch_size",
+        value<uint32_t>(&configured.database.ibd_batch_size),
+        "The maximum size in MiB of the old blocks batched in a single write transaction, defaults to 256."
+    )(
+        "database.ibd_flush_interval",
+        value<uint32_t>(&configured.database.ibd_flush_interval),
+        "The maximum number of seconds old blocks are kept batched before being committed, defaults to 60."
+    )(
+        "database.async_indexes",
+        value<bool>(&configured.database.async_indexes),
+        "Write the address history and spend indexes (full mode) on background threads instead of with each block, defaults to false."
+    )(
+        "database.rebuild_indexes",
+        value<bool>(&configured.database.rebuild_indexes),
+        "Rebuild the address history and spend indexes (full mode) from the stored blocks on start, defaults to false."
     )
     /* [blockchain] */
     (
@@ -349,6 +398,18 @@ options_metadata parser::load_settings() {
         "blockchain.priority",
         value<bool>(&configured.chain.priority),
         "Use high thread priority for block validation, defaults to true."
+    )(
+        "blockchain.script_cache_capacity",
+        value<size_t>(&configured.chain.script_cache_capacity),
+        "The maximum number of transactions with verified scripts kept for block validation, defaults to 100000 (0 to disable)."
+    )(
+        "blockchain.signature_cache_capacity",
+        value<size_t>(&configured.chain.signature_cache_capacity),
+        "The maximum number of verified signatures kept for block validation (32 bytes each), defaults to 1048576 (0 to disable)."
+    )(
+        "blockchain.recent_blocks_capacity",
+        value<size_t>(&configured.chain.recent_blocks_capacity),
+        "The number of recently organized blocks kept in memory, with their encodings, to serve peer requests, defaults to 16 (0 to disable)."
     )
     // (
     //     "blockchain.use_libconsensus",
@@ -522,6 +583,10 @@ options_metadata parser::load_settings() {
         "node.block_latency_seconds",
         value<uint32_t>(&configured.node.block_latency_seconds),
         "The time to wait for a requested block, defaults to 60."
+    )(
+        "node.transaction_trickle_milliseconds",
+        value<uint32_t>(&configured.node.transaction_trickle_milliseconds),
+        "The maximum (randomized) delay of transaction announcements to each peer, defaults to 2000 (0 announces immediately)."
     )(
         /* Internally this is blockchain, but it is conceptually a node setting. */
         "node.notify_limit_hours",
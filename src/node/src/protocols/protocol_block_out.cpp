@@ -325,7 +325,11 @@ void protocol_block_out::send_next_data(inventory_ptr inventory) {
 
     switch (entry.type()) {
         case inventory::type_id::block: {
-            chain_.fetch_block(entry.hash(), BIND4(send_block, _1, _2, _3, inventory));
+            // Blocks are served from the relay cache or as stored, in the
+            // wire format, without building the block object.
+            if ( ! SEND_FROM_CACHE2(entry.hash(), block::command, handle_send_next, _1, inventory)) {
+                chain_.fetch_block_data(entry.hash(), BIND4(send_block, _1, _2, _3, inventory));
+            }
             break;
         } case inventory::type_id::filtered_block: {
             chain_.fetch_merkle_block(entry.hash(), BIND4(send_merkle_block, _1, _2, _3, inventory));
@@ -339,7 +343,7 @@ void protocol_block_out::send_next_data(inventory_ptr inventory) {
     }
 }
 
-void protocol_block_out::send_block(code const& ec, block_const_ptr message, size_t, inventory_ptr inventory) {
+void protocol_block_out::send_block(code const& ec, std::shared_ptr<data_chunk const> data, size_t, inventory_ptr inventory) {
     if (stopped(ec)) {
         return;
     }
@@ -361,7 +365,9 @@ void protocol_block_out::send_block(code const& ec, block_const_ptr message, siz
         return;
     }
 
-    SEND2(*message, handle_send_next, _1, inventory);
+    KTH_ASSERT( ! inventory->inventories().empty());
+    auto const& hash = inventory->inventories().back().hash();
+    SEND_PAYLOAD2(*data, block::command, hash, handle_send_next, _1, inventory);
 }
 
 // TODO: move merkle_block to derived class protocol_block_out_70001.
@@ -413,7 +419,7 @@ void protocol_block_out::send_compact_block(code const& ec, compact_block_const_
         return;
     }
 
-    SEND2(*message, handle_send_next, _1, inventory);
+    SEND_CACHED2(*message, message->header().hash(), handle_send_next, _1, inventory);
 }
 
 void protocol_block_out::handle_send_next(code const& ec, inventory_ptr inventory) {
@@ -461,7 +467,7 @@ bool protocol_block_out::handle_reorganized(code ec, size_t fork_height, block_c
 
         if (block->validation.originator != nonce()) {
             compact_block announce = compact_block::factory_from_block(*block);
-            SEND2(announce, handle_send, _1, announce.command);
+            SEND_CACHED2(announce, block->hash(), handle_send, _1, announce.command);
         }
 
         return true;
@@ -4,9 +4,11 @@
 
 #include <kth/node/protocols/protocol_transaction_out.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 #include <boost/range/adaptor/reversed.hpp>
 
@@ -39,6 +41,8 @@ protocol_transaction_out::protocol_transaction_out(full_node& network, channel::
     // TODO: move relay to a derived class protocol_transaction_out_70001.
     , relay_to_peer_(peer_version()->relay())
 
+    , trickle_interval_(network.node_settings().transaction_trickle())
+    , trickle_timer_(std::make_shared<deadline>(pool()))
     , CONSTRUCT_TRACK(protocol_transaction_out)
 {}
 
@@ -55,6 +59,10 @@ void protocol_transaction_out::start() {
     if (relay_to_peer_) {
         // Subscribe to transaction pool notifications and relay txs.
         chain_.subscribe_transaction(BIND2(handle_transaction_pool, _1, _2));
+        start_trickle();
+
+        // Transactions announced by the peer are not announced back.
+        SUBSCRIBE2(inventory, handle_receive_inventory, _1, _2);
     }
 
     // TODO: move fee filter to a derived class protocol_transaction_out_70013.
@@ -82,6 +90,23 @@ bool protocol_transaction_out::handle_receive_fee_filter(code const& ec, fee_fil
     return true;
 }
 
+// Receive inventory sequence.
+//-----------------------------------------------------------------------------
+
+bool protocol_transaction_out::handle_receive_inventory(code const& ec, inventory_const_ptr message) {
+    if (stopped(ec)) {
+        return false;
+    }
+
+    for (auto const& inventory : message->inventories()) {
+        if (inventory.is_transaction_type()) {
+            remember(inventory.hash());
+        }
+    }
+
+    return true;
+}
+
 // Receive mempool sequence.
 //-----------------------------------------------------------------------------
 
@@ -106,13 +131,17 @@ void protocol_transaction_out::handle_fetch_mempool(code const& ec, inventory_pt
         return;
     }
 
+    for (auto const& inventory : message->inventories()) {
+        remember(inventory.hash());
+    }
+
     SEND2(*message, handle_send, _1, message->command);
 }
 
 // Receive get_data sequence.
 //-----------------------------------------------------------------------------
 
-// THIS SUPPORTS REQUEST OF CONFIRMED TRANSACTIONS.
+// Only unconfirmed transactions are served, from the in-memory pool.
 // TODO: subscribe to and handle get_block_transactions message.
 // TODO: expose a new service bit that indicates complete current tx history.
 // This would exclude transctions replaced by duplication as per BIP30.
@@ -151,7 +180,7 @@ void protocol_transaction_out::send_next_data(inventory_ptr inventory) {
 
     switch (entry.type()) {
         case inventory::type_id::transaction: {
-            chain_.fetch_transaction(entry.hash(), false, BIND5(send_transaction, _1, _2, _3, _4, inventory));
+            chain_.fetch_unconfirmed_transaction(entry.hash(), BIND3(send_transaction, _1, _2, inventory));
             break;
         } default: {
             KTH_ASSERT_MSG(false, "improperly-filtered inventory");
@@ -160,17 +189,13 @@ void protocol_transaction_out::send_next_data(inventory_ptr inventory) {
 }
 
 // TODO: send block_transaction message as applicable.
-void protocol_transaction_out::send_transaction(code const& ec, transaction_const_ptr message, size_t position, size_t /*height*/, inventory_ptr inventory) {
+void protocol_transaction_out::send_transaction(code const& ec, transaction_const_ptr message, inventory_ptr inventory) {
     if (stopped(ec)) {
         return;
     }
 
-    // Treat already confirmed transactions as not found.
-    auto confirmed = ! ec
-                    && position != position_max
-                    ;
-
-    if (ec == error::not_found || confirmed) {
+    // Already confirmed transactions are not found.
+    if (ec == error::not_found) {
         spdlog::debug("[node] Transaction requested by [{}] not found.", authority());
 
         // TODO: move not_found to derived class protocol_block_out_70001.
@@ -187,7 +212,8 @@ void protocol_transaction_out::send_transaction(code const& ec, transaction_cons
         return;
     }
 
-    SEND2(*message, handle_send_next, _1, inventory);
+    remember(message->hash());
+    SEND_CACHED2(*message, message->hash(), handle_send_next, _1, inventory);
 }
 
 void protocol_transaction_out::handle_send_next(code const& ec, inventory_ptr inventory) {
@@ -232,23 +258,106 @@ bool protocol_transaction_out::handle_transaction_pool(code const& ec, transacti
         return true;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        announcements_.push_back(message);
+    }
+
+    // Without trickling every transaction is announced as it is accepted.
+    if (trickle_interval_ == asio::duration::zero()) {
+        send_announcements();
+    }
+
+    return true;
+}
+
+// Trickle.
+//-----------------------------------------------------------------------------
+
+// The announcements are queued and sent to each peer in batches, after a
+// random delay (up to trickle_interval_), which also obscures the origin.
+void protocol_transaction_out::start_trickle() {
+    if (trickle_interval_ == asio::duration::zero()) {
+        return;
+    }
+
+    trickle_timer_->start(BIND1(handle_trickle, _1), pseudo_random_broken_do_not_use::duration(trickle_interval_));
+}
+
+void protocol_transaction_out::handle_trickle(code const& ec) {
+    if (stopped(ec)) {
+        return;
+    }
+
+    if (ec) {
+        spdlog::debug("[node] Failure in transaction trickle timer for [{}] {}", authority(), ec.message());
+        stop(ec);
+        return;
+    }
+
+    send_announcements();
+    start_trickle();
+}
+
+// The fee filter and the known inventory are applied when sent, as either
+// may have changed since the transaction was queued.
+void protocol_transaction_out::send_announcements() {
+    std::vector<transaction_const_ptr> queued;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued.swap(announcements_);
+    }
+
+    if (queued.empty()) {
+        return;
+    }
+
     // TODO: move fee_filter to a derived class protocol_transaction_out_70013.
-    if (message->fees() < minimum_peer_fee_) {
-        return true;
+    uint64_t const minimum_fee = minimum_peer_fee_;
+
+    inventory announce;
+    announce.inventories().reserve(std::min(queued.size(), max_inventory));
+
+    for (auto const& tx : queued) {
+        if (tx->fees() < minimum_fee || ! remember(tx->hash())) {
+            continue;
+        }
+
+        announce.inventories().emplace_back(inventory::type_id::transaction, tx->hash());
+
+        if (announce.inventories().size() == max_inventory) {
+            SEND2(announce, handle_send, _1, announce.command);
+            announce.inventories().clear();
+        }
     }
 
-    inventory::type_id id;
-    id = inventory::type_id::transaction;
-    inventory const announce {{id, message->hash()}};
-    SEND2(announce, handle_send, _1, announce.command);
+    if ( ! announce.inventories().empty()) {
+        SEND2(announce, handle_send, _1, announce.command);
+    }
+}
+
+// Returns false if the hash was already known (to the peer).
+bool protocol_transaction_out::remember(hash_digest const& hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ( ! known_.insert(hash).second) {
+        return false;
+    }
+
+    // The oldest hash is forgotten.
+    if (known_ring_.size() < known_inventory_capacity) {
+        known_ring_.push_back(hash);
+    } else {
+        known_.erase(known_ring_[known_next_]);
+        known_ring_[known_next_] = hash;
+        known_next_ = (known_next_ + 1) % known_inventory_capacity;
+    }
 
-    ////spdlog::debug("[node]
-    ////] Announced tx [{}{}{}].", encode_hash(message->hash()), "] to ["
-    ////, authority());
     return true;
 }
 
 void protocol_transaction_out::handle_stop(code const&) {
+    trickle_timer_->stop();
     chain_.unsubscribe();
 
     spdlog::debug("[network] Stopped transaction_out protocol for [{}].", authority());
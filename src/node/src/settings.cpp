@@ -14,6 +14,7 @@ settings::settings()
     : sync_peers(0)
     , sync_timeout_seconds(5)
     , block_latency_seconds(60)
+    , transaction_trickle_milliseconds(2000)
     , refresh_transactions(true)
     , compact_blocks_high_bandwidth(true)
     , ds_proofs_enabled(false)
@@ -28,4 +29,8 @@ duration settings::block_latency() const {
     return seconds(block_latency_seconds);
 }
 
+duration settings::transaction_trickle() const {
+    return milliseconds(transaction_trickle_milliseconds);
+}
+
 } // namespace kth::node